@@ -2,7 +2,9 @@
 #include <linux/kernel.h>
 #include <linux/init.h>
 #include <linux/gpio.h>
+#include <linux/gpio/consumer.h>
 #include <linux/interrupt.h>
+#include <linux/completion.h>
 #include <linux/cdev.h>
 #include <linux/uaccess.h>
 #include <linux/wait.h>
@@ -12,51 +14,587 @@
 #include <linux/device.h>
 #include <linux/delay.h>
 #include <linux/mutex.h>
+#include <linux/platform_device.h>
+#include <linux/of.h>
+#include <linux/idr.h>
+#include <linux/slab.h>
+#include <linux/list.h>
+#include <linux/ktime.h>
+#include <linux/moduleparam.h>
+#include <linux/hwmon.h>
+#include <linux/kref.h>
+
+#define CREATE_TRACE_POINTS
+#include "dht11_trace.h"
 
 #define DRIVER_NAME   "dht11"
 #define CLASS_NAME    "dht11_class"
-#define GPIO_PIN       4
+#define DHT11_MAX_DEVS 16
+#define DHT11_SLOT_MIN_MS 100     // 센서 하나 읽는 시간(시작 펄스 20ms + 캡처 ~5ms)보다 넉넉히
+#define DHT11_PERIOD_MIN_MS 1000  // DHT11은 1초보다 자주 읽으면 안 됨
+
+/*
+ * 캡처: 응답 ↓↑↓ 3개 + 비트마다 ↑↓ 2개 = 83에지. 마지막 비트의 ↓에서 끝.
+ * 비트 값은 HIGH 폭 (0: 26~28us, 1: 70us)
+ */
+#define DHT11_BITS          40
+#define DHT11_EDGES_FRAME   (3 + 2 * DHT11_BITS)
+#define DHT11_EDGES_MAX     (DHT11_EDGES_FRAME + 4)
+#define DHT11_ONE_MIN_NS    50000
+#define DHT11_FRAME_TIMEOUT_MS 20 // 프레임은 응답부터 ~5ms
+#define DHT11_START_MS      20    // 시작 펄스 (18ms 이상)
+#define DHT11_MAX_WAITERS   8     // 캡처 하나를 기다리는 콜백 수
+#define DHT11_READ_TIMEOUT_MS 2000 // 동기 읽기가 기다리는 최대 시간 (1초 간격 제한 + 캡처)
+#define DHT11_INTERVAL_DEF_MS 2000 // hwmon update_interval 기본값
+#define DHT11_INTERVAL_MAX_MS 60000
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("kkk");
 MODULE_DESCRIPTION("DHT11 driver");
 
-static DEFINE_MUTEX(dht_lock);
+/*
+ * 센서마다 인스턴스 하나 (platform device).
+ *  - device tree: compatible = "kkk,dht11"; gpios = <&gpio 4 0>;
+ *  - DT가 없으면 모듈 로딩 때 gpio 파라미터로 dht11.0 하나를 만든다 (gpio=-1이면 안 만듦)
+ * 인스턴스끼리는 락을 공유하지 않는다.
+ */
+static int gpio = 4;
+module_param(gpio, int, 0444);
+MODULE_PARM_DESC(gpio, "data GPIO of the default sensor (-1 = none, use device tree)");
+
+/*
+ * 센서 배열 모드 (array_period_ms > 0)
+ *  - 스케줄러(work 하나)가 등록된 센서를 돌아가며 period/N 간격으로 하나씩 읽는다.
+ *    시작 펄스와 캡처가 서로 엇갈려서 에지 IRQ가 한꺼번에 몰리지 않는다.
+ *  - dht11_read_values()/read()는 period 안의 캐시를 돌려주고 버스를 건드리지 않는다.
+ *  - 센서마다 sysfs로 sample_age_ms, reads_ok, reads_failed, fail_permille
+ * 0이면 예전처럼 읽을 때마다 캡처.
+ */
+static unsigned int array_period_ms;
+static int array_period_set(const char *val, const struct kernel_param *kp);
+static const struct kernel_param_ops array_period_ops = {
+    .set = array_period_set,
+    .get = param_get_uint,
+};
+module_param_cb(array_period_ms, &array_period_ops, &array_period_ms, 0644);
+MODULE_PARM_DESC(array_period_ms, "sample every sensor once per N ms in the background (0 = read on demand, min 1000)");
+
+struct dht11_pdata {
+    int gpio;
+};
+
+struct dht11_edge {
+    u64 ns;                     // ktime_get_ns()
+    bool high;                  // 에지 뒤 레벨
+};
+
+/*
+ * 캡처 하나는 capture_work가 단계별로 진행한다. 호출자는 기다리지 않는다.
+ *  START -(타이머 20ms)-> RELEASE -(83에지 또는 20ms)-> DECODE -> IDLE
+ */
+enum dht11_state {
+    DHT11_ST_IDLE,
+    DHT11_ST_START,             // 선을 LOW로 (시작 펄스)
+    DHT11_ST_RELEASE,           // 선을 놓고 에지 IRQ 걸기
+    DHT11_ST_DECODE,            // IRQ 풀고 해석, 콜백
+};
+
+/* 캡처 완료 콜백: process context(workqueue)에서 불림. err != 0이면 temp/humi는 -1 */
+typedef void (*dht11_done_fn)(void *data, int err, int temp, int humi, ktime_t kt);
+
+struct dht11_waiter {
+    dht11_done_fn done;
+    void *data;
+};
+
+struct dht11 {
+    struct device *dev;
+    struct gpio_desc *gpio;
+    spinlock_t lock;            // state, waiters, 아래 캐시
+    int id;
+    struct cdev *cdev;          // cdev_alloc: 열린 파일이 남아 있으면 마지막 close까지 산다
+    struct device *cdev_dev;
+    struct list_head node;      // dht11_list (open은 여기서 id로 찾는다)
+    struct kref ref;            // probe 하나 + 열린 파일마다 하나. 열린 파일 때문에 devm이 아님
+
+    // 캡처: 에지 IRQ는 RELEASE~DECODE 동안만 걸려 있고, 그동안 edges는 핸들러 차지
+    int irq;
+    struct dht11_edge edges[DHT11_EDGES_MAX];
+    int num_edges;
+    struct delayed_work capture_work;
+    enum dht11_state state;     // lock
+    bool removing;              // lock, 새 요청 거절 (열린 파일은 -ENODEV)
+
+    // 이번 캡처를 기다리는 콜백들 (lock). 콜백이 도는 동안은 cb_lock
+    struct dht11_waiter waiters[DHT11_MAX_WAITERS];
+    int nwaiters;
+    struct mutex cb_lock;
+
+    ktime_t resp_kt;            // 마지막으로 선을 놓은 시각 = 센서 응답 (lock). 다음 캡처는 1초 뒤부터
+
+    // 캐시 읽기(hwmon, /dev/dht11): interval_ms 안에는 캡처하지 않음. 새로 읽는 건 한 번에 하나
+    unsigned int interval_ms;
+    struct mutex refresh_lock;
+    struct device *hwmon;
+
+    // 마지막 캡처 결과 (lock)
+    int temp, humi;
+    int last_err;               // 마지막 캡처의 결과 (0 = temp/humi 유효)
+    ktime_t sample_kt;          // 마지막으로 성공한 캡처 시각
+    bool sampled;
+    ktime_t last_kt;            // 마지막 캡처가 끝난 시각 (성공/실패 모두)
+    bool finished;
+    unsigned long reads_ok, reads_failed;
+};
+
 static struct class *dht11_class=NULL;
 static dev_t dev_num;
-static struct cdev dht11_cdev;
-static int read_dht11(int *temp, int *humi);
-int dht11_read_values(int *temp, int *humi);
+static DEFINE_IDA(dht11_ida);
+static struct platform_device *dht11_legacy;
+static struct platform_driver dht11_driver;
+
+static LIST_HEAD(dht11_list);          // probe된 센서들 (id 순)
+static DEFINE_MUTEX(dht11_list_lock);
+static int sched_next_id;              // 다음에 읽을 센서 id (이상인 것 중 첫 번째)
+static void dht11_sched_fn(struct work_struct *work);
+static DECLARE_DELAYED_WORK(dht11_sched_work, dht11_sched_fn);
+
+static void dht11_capture_fn(struct work_struct *work);
+
+/*
+ * lock 잡고 호출: 쉬고 있으면 캡처를 시작한다. 진행 중이면 그 캡처 결과를 같이 받는다.
+ * 직전 응답에서 1초가 안 됐으면 그때까지 미룬다 -> 요청이 어디서 몇 개 오든 센서는 1Hz 이하
+ */
+static void dht11_kick_locked(struct dht11 *d)
+{
+    s64 wait_ms;
+
+    if (d->state != DHT11_ST_IDLE || d->removing)
+        return;
+    d->state = DHT11_ST_START;
+    wait_ms = DHT11_PERIOD_MIN_MS - ktime_ms_delta(ktime_get(), d->resp_kt);
+    queue_delayed_work(system_highpri_wq, &d->capture_work,
+                       wait_ms > 0 ? msecs_to_jiffies(wait_ms) + 1 : 0);
+}
+
+static void dht11_kick(struct dht11 *d)
+{
+    unsigned long flags;
+
+    spin_lock_irqsave(&d->lock, flags);
+    dht11_kick_locked(d);
+    spin_unlock_irqrestore(&d->lock, flags);
+}
+
+/*
+ * 비동기 읽기: 캡처를 걸고 바로 돌아온다. 어떤 context에서도 불러도 된다 (atomic 포함).
+ * 캡처가 끝나면 done(data, err, temp, humi, kt)이 workqueue에서 한 번 불린다.
+ * 같은 (done, data)가 이미 기다리고 있으면 하나로 합친다.
+ * 콜백 안에서 dht11_cancel_async()를 부르면 안 된다 (dht11_read_async는 괜찮음).
+ */
+int dht11_read_async(struct device *dev, dht11_done_fn done, void *data)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long flags;
+    int i, ret = 0;
+
+    if (!d || !done)
+        return -EINVAL;
+
+    spin_lock_irqsave(&d->lock, flags);
+    if (d->removing) {
+        ret = -ENODEV;
+        goto out;
+    }
+    for (i = 0; i < d->nwaiters; i++)
+        if (d->waiters[i].done == done && d->waiters[i].data == data)
+            goto kick;
+    if (d->nwaiters == DHT11_MAX_WAITERS) {
+        ret = -EBUSY;
+        goto out;
+    }
+    d->waiters[d->nwaiters].done = done;
+    d->waiters[d->nwaiters].data = data;
+    d->nwaiters++;
+kick:
+    dht11_kick_locked(d);
+out:
+    spin_unlock_irqrestore(&d->lock, flags);
+    return ret;
+}
+EXPORT_SYMBOL_GPL(dht11_read_async);
+
+/* 걸어 둔 (done, data)를 뺀다. 돌아온 뒤에는 그 콜백이 돌고 있지도, 다시 불리지도 않는다 */
+void dht11_cancel_async(struct device *dev, dht11_done_fn done, void *data)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long flags;
+    int i;
+
+    if (!d)
+        return;
+
+    spin_lock_irqsave(&d->lock, flags);
+    for (i = 0; i < d->nwaiters; i++) {
+        if (d->waiters[i].done == done && d->waiters[i].data == data) {
+            d->waiters[i] = d->waiters[--d->nwaiters];
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&d->lock, flags);
+
+    // 이미 꺼내 가서 부르고 있는 중이면 끝날 때까지
+    mutex_lock(&d->cb_lock);
+    mutex_unlock(&d->cb_lock);
+}
+EXPORT_SYMBOL_GPL(dht11_cancel_async);
+
+/* 마지막으로 성공한 샘플과 그 시각. 버스를 건드리지 않고 기다리지도 않는다 */
+int dht11_get_latest(struct device *dev, int *temp, int *humi, ktime_t *kt)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long flags;
+    int ret = -ENODATA;
+
+    if (!d || !temp || !humi)
+        return -EINVAL;
+
+    spin_lock_irqsave(&d->lock, flags);
+    if (d->sampled) {
+        *temp = d->temp;
+        *humi = d->humi;
+        if (kt)
+            *kt = d->sample_kt;
+        ret = 0;
+    }
+    spin_unlock_irqrestore(&d->lock, flags);
+    return ret;
+}
+EXPORT_SYMBOL_GPL(dht11_get_latest);
+
+// 동기 읽기용: 호출자 스택에 두고 콜백이 채운다
+struct dht11_sync {
+    struct completion done;
+    int err, temp, humi;
+};
+
+static void dht11_sync_done(void *data, int err, int temp, int humi, ktime_t kt)
+{
+    struct dht11_sync *s = data;
+
+    s->err = err;
+    s->temp = temp;
+    s->humi = humi;
+    complete(&s->done);
+}
 
-int dht11_read_values(int *temp, int *humi)
+/*
+ * 캡처 하나를 기다린다 (잠잘 수 있는 context 전용). dht11_read_async 위에 얹은 것이라
+ * 시작 펄스/캡처는 workqueue에서 돌고 여기서는 결과만 기다린다.
+ */
+static int dht11_read_sync(struct dht11 *d, int *temp, int *humi)
 {
+    struct dht11_sync s = { .err = -ETIMEDOUT };
     int ret;
-    if (!temp || !humi) return -EINVAL;
 
-    mutex_lock(&dht_lock);
-    ret = read_dht11(temp, humi);
-    mutex_unlock(&dht_lock);
+    init_completion(&s.done);
+    ret = dht11_read_async(d->dev, dht11_sync_done, &s);
+    if (ret)
+        return ret;
+    if (!wait_for_completion_timeout(&s.done, msecs_to_jiffies(DHT11_READ_TIMEOUT_MS))) {
+        dht11_cancel_async(d->dev, dht11_sync_done, &s);   // 이 뒤로 s는 안 건드림
+        if (!completion_done(&s.done))
+            return -ETIMEDOUT;
+    }
+    if (s.err)
+        return s.err;
+    *temp = s.temp;
+    *humi = s.humi;
+    return 0;
+}
+
+/*
+ * 캐시 읽기 (hwmon, /dev/dht11): 마지막 캡처가 interval_ms 안이면 그 결과(실패 포함)를
+ * 그대로 돌려주고, 지났을 때만 새로 하나 읽는다. 동시에 들어온 읽기는 refresh_lock에서
+ * 기다렸다가 방금 채운 캐시를 본다 -> 읽는 쪽이 몇이든 interval당 캡처는 한 번.
+ */
+static int dht11_read_cached(struct dht11 *d, int *temp, int *humi)
+{
+    unsigned long flags;
+    bool fresh;
+    int ret = 0;
 
+    mutex_lock(&d->refresh_lock);
+    spin_lock_irqsave(&d->lock, flags);
+    fresh = d->finished &&
+            ktime_ms_delta(ktime_get(), d->last_kt) < (s64)READ_ONCE(d->interval_ms);
+    if (fresh) {
+        ret = d->last_err;
+        *temp = d->temp;
+        *humi = d->humi;
+    }
+    spin_unlock_irqrestore(&d->lock, flags);
+    if (!fresh)
+        ret = dht11_read_sync(d, temp, humi);
+    mutex_unlock(&d->refresh_lock);
     return ret;
 }
+
+/*
+ * dev: dht11 platform device (dht11_find_device로 얻은 것)
+ * 동기 읽기: 항상 새 캡처 하나를 기다린다 (배열 모드면 스케줄러 캐시)
+ */
+int dht11_read_values(struct device *dev, int *temp, int *humi)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long flags;
+    if (!d || !temp || !humi) return -EINVAL;
+
+    // 배열 모드: 스케줄러가 채운 캐시가 한 주기 안이면 그대로 (버스 안 건드림)
+    spin_lock_irqsave(&d->lock, flags);
+    if (READ_ONCE(array_period_ms) && d->sampled &&
+        ktime_ms_delta(ktime_get(), d->sample_kt) < 2 * (s64)READ_ONCE(array_period_ms)) {
+        *temp = d->temp;
+        *humi = d->humi;
+        spin_unlock_irqrestore(&d->lock, flags);
+        return 0;
+    }
+    spin_unlock_irqrestore(&d->lock, flags);
+
+    return dht11_read_sync(d, temp, humi);
+}
 EXPORT_SYMBOL_GPL(dht11_read_values);
 
-static int wait_pin_status(int level, int time)
+/*
+ * 다른 모듈이 쓸 센서 찾기: DT 노드(np) 또는 장치 이름(예: "dht11.0").
+ * probe가 끝난 장치만 돌려주고 참조를 잡는다 (put_device로 반납). 없으면 NULL.
+ */
+struct device *dht11_find_device(struct device_node *np, const char *name)
 {
-	int counter =0;
+    if (np)
+        return driver_find_device_by_of_node(&dht11_driver.driver, np);
+    if (name && *name)
+        return driver_find_device_by_name(&dht11_driver.driver, name);
+    return NULL;
+}
+EXPORT_SYMBOL_GPL(dht11_find_device);
 
-	while(gpio_get_value(GPIO_PIN) != level) {
-		if (++counter > time) return -1;
-		udelay(1);
-	}
-	return counter;
+// -------------------- 배열 스케줄러 --------------------
+/* 센서 수에 맞춘 슬롯 간격. 한 주기에 전부 못 넣으면 슬롯 최소값을 지키고 주기가 늘어난다 */
+static unsigned long dht11_slot_jiffies(unsigned int period, int n)
+{
+    unsigned int slot = n ? period / n : period;
+
+    return msecs_to_jiffies(max_t(unsigned int, slot, DHT11_SLOT_MIN_MS));
+}
+
+static void dht11_sched_fn(struct work_struct *work)
+{
+    unsigned int period = READ_ONCE(array_period_ms);
+    struct dht11 *d, *pick = NULL;
+    int n = 0;
+
+    if (!period)
+        return;
+
+    // 한 슬롯에 센서 하나. 캡처는 그 센서의 capture_work가 하므로 여기서는 걸기만 한다
+    mutex_lock(&dht11_list_lock);
+    list_for_each_entry(d, &dht11_list, node) {
+        n++;
+        if (!pick && d->id >= sched_next_id)
+            pick = d;
+    }
+    if (!pick && n)
+        pick = list_first_entry(&dht11_list, struct dht11, node);  // 한 바퀴 돌았음
+
+    if (pick) {
+        sched_next_id = pick->id + 1;
+        dht11_kick(pick);
+    }
+    mutex_unlock(&dht11_list_lock);
+
+    if (n)
+        schedule_delayed_work(&dht11_sched_work, dht11_slot_jiffies(period, n));
 }
+
+static int array_period_set(const char *val, const struct kernel_param *kp)
+{
+    unsigned int v;
+    int ret;
+
+    ret = kstrtouint(val, 0, &v);
+    if (ret)
+        return ret;
+    if (v && v < DHT11_PERIOD_MIN_MS)
+        v = DHT11_PERIOD_MIN_MS;
+    WRITE_ONCE(array_period_ms, v);
+
+    if (v)
+        mod_delayed_work(system_wq, &dht11_sched_work, 0);
+    return 0;
+}
+
+// -------------------- sysfs: 센서별 통계 --------------------
+/* 마지막으로 성공한 샘플이 몇 ms 전인지 (-1 = 아직 없음) */
+static ssize_t sample_age_ms_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long flags;
+    s64 age = -1;
+
+    spin_lock_irqsave(&d->lock, flags);
+    if (d->sampled)
+        age = ktime_ms_delta(ktime_get(), d->sample_kt);
+    spin_unlock_irqrestore(&d->lock, flags);
+    return sysfs_emit(buf, "%lld\n", age);
+}
+static DEVICE_ATTR_RO(sample_age_ms);
+
+static ssize_t reads_ok_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%lu\n", READ_ONCE(d->reads_ok));
+}
+static DEVICE_ATTR_RO(reads_ok);
+
+static ssize_t reads_failed_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%lu\n", READ_ONCE(d->reads_failed));
+}
+static DEVICE_ATTR_RO(reads_failed);
+
+/* 실패율 (천분율, 지금까지의 캡처 전체 기준) */
+static ssize_t fail_permille_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    unsigned long ok, fail, flags;
+
+    spin_lock_irqsave(&d->lock, flags);
+    ok = d->reads_ok;
+    fail = d->reads_failed;
+    spin_unlock_irqrestore(&d->lock, flags);
+    return sysfs_emit(buf, "%lu\n", ok + fail ? fail * 1000 / (ok + fail) : 0);
+}
+static DEVICE_ATTR_RO(fail_permille);
+
+static struct attribute *dht11_attrs[] = {
+    &dev_attr_sample_age_ms.attr,
+    &dev_attr_reads_ok.attr,
+    &dev_attr_reads_failed.attr,
+    &dev_attr_fail_permille.attr,
+    NULL,
+};
+ATTRIBUTE_GROUPS(dht11);
+
+// -------------------- hwmon: temp1_input, humidity1_input, update_interval --------------------
+static umode_t dht11_hwmon_is_visible(const void *data, enum hwmon_sensor_types type,
+                                      u32 attr, int channel)
+{
+    if (type == hwmon_chip && attr == hwmon_chip_update_interval)
+        return 0644;
+    return 0444;
+}
+
+/* 값은 캐시에서 (dht11_read_cached). 단위는 hwmon 규칙대로 밀리도/밀리퍼센트, interval은 ms */
+static int dht11_hwmon_read(struct device *dev, enum hwmon_sensor_types type,
+                            u32 attr, int channel, long *val)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+    int t, h, ret;
+
+    if (type == hwmon_chip) {
+        *val = READ_ONCE(d->interval_ms);
+        return 0;
+    }
+    ret = dht11_read_cached(d, &t, &h);
+    if (ret)
+        return ret;
+    *val = (type == hwmon_temp ? t : h) * 1000L;
+    return 0;
+}
+
+/* 1초(센서 한계)보다 짧게는 못 줄인다 */
+static int dht11_hwmon_write(struct device *dev, enum hwmon_sensor_types type,
+                             u32 attr, int channel, long val)
+{
+    struct dht11 *d = dev_get_drvdata(dev);
+
+    if (type != hwmon_chip || attr != hwmon_chip_update_interval)
+        return -EOPNOTSUPP;
+    WRITE_ONCE(d->interval_ms, clamp_t(long, val, DHT11_PERIOD_MIN_MS, DHT11_INTERVAL_MAX_MS));
+    return 0;
+}
+
+static const struct hwmon_ops dht11_hwmon_ops = {
+    .is_visible = dht11_hwmon_is_visible,
+    .read       = dht11_hwmon_read,
+    .write      = dht11_hwmon_write,
+};
+
+static const struct hwmon_channel_info *dht11_hwmon_info[] = {
+    HWMON_CHANNEL_INFO(chip, HWMON_C_UPDATE_INTERVAL),
+    HWMON_CHANNEL_INFO(temp, HWMON_T_INPUT),
+    HWMON_CHANNEL_INFO(humidity, HWMON_H_INPUT),
+    NULL
+};
+
+static const struct hwmon_chip_info dht11_hwmon_chip = {
+    .ops  = &dht11_hwmon_ops,
+    .info = dht11_hwmon_info,
+};
+
+static void dht11_free(struct kref *kref)
+{
+    kfree(container_of(kref, struct dht11, ref));
+}
+
+static void dht11_put(void *data)
+{
+    struct dht11 *d = data;
+
+    kref_put(&d->ref, dht11_free);
+}
+
+static int dht11_dev_open(struct inode *inode, struct file *filep)
+{
+    struct dht11 *d, *found = NULL;
+
+    // remove가 목록에서 빼고 나면 새로 열 수 없다
+    mutex_lock(&dht11_list_lock);
+    list_for_each_entry(d, &dht11_list, node) {
+        if (d->id == iminor(inode)) {
+            kref_get(&d->ref);
+            found = d;
+            break;
+        }
+    }
+    mutex_unlock(&dht11_list_lock);
+    if (!found)
+        return -ENODEV;
+
+    filep->private_data = found;
+    return 0;
+}
+
+static int dht11_dev_release(struct inode *inode, struct file *filep)
+{
+    dht11_put(filep->private_data);
+    return 0;
+}
+
 static ssize_t dht11_dev_read(struct file *filep, char *buffer, size_t len, loff_t *offset)
 {
+	struct dht11 *d = filep->private_data;
 	int temp=0, humi = 0;
 	int ret;
 	char msg_buff[80];
 
+	if (READ_ONCE(d->removing))
+		return -ENODEV;
+
 	if (*offset >0)
 	{
 
@@ -65,7 +603,7 @@ static ssize_t dht11_dev_read(struct file *filep, char *buffer, size_t len, loff
 
 	}
 
-	ret = read_dht11(&temp, &humi);
+	ret = dht11_read_cached(d, &temp, &humi);	// hwmon과 같은 캐시: 읽기가 몰려도 센서는 interval당 한 번
 	if (ret == 0)
 		sprintf(msg_buff, "temp: %d c humi: %d %%\n", temp, humi);
 	else sprintf(msg_buff, "DHT11 read error !!!! %d\n", ret);
@@ -76,117 +614,412 @@ static ssize_t dht11_dev_read(struct file *filep, char *buffer, size_t len, loff
 
 	return strlen(msg_buff);
 }
-static int read_dht11(int *temp, int *humi)
+/* 40비트 프레임: 받은 순서대로 MSB부터 (습도 정수, 습도 소수, 온도 정수, 온도 소수, checksum) */
+static inline void dht11_put_bit(u8 data[5], int i, bool one)
 {
-    unsigned char data[5] = {0};
-    unsigned long flags;
-    int i, ret = 0;
+    if (one)
+        data[i / 8] |= 1 << (7 - (i % 8));
+}
 
-    gpio_direction_output(GPIO_PIN, 0);
-    msleep(20);
-    gpio_set_value(GPIO_PIN, 1);
-    udelay(30);
+/* checksum 확인 후 정수부만 (DHT11은 소수부가 항상 0) */
+static int dht11_decode(const u8 data[5], int *temp, int *humi)
+{
+    if (data[4] != ((data[0] + data[1] + data[2] + data[3]) & 0xFF))
+        return -EIO;
 
-    gpio_direction_input(GPIO_PIN);
-    udelay(2);
+    *humi = data[0];
+    *temp = data[2];
+    return 0;
+}
 
-    preempt_disable();
-    local_irq_save(flags);
+/*
+ * 에지 목록 -> 40비트. HIGH 펄스(↑ 바로 다음 ↓)의 폭으로 0/1을 가르고 마지막 40개만 쓴다.
+ * 응답 신호의 HIGH 80us나 IRQ를 걸기 전에 지나간 앞쪽 에지는 이렇게 자연히 빠진다.
+ * 받은 비트 수를 돌려준다 (40보다 작으면 프레임이 끊긴 것).
+ */
+static int dht11_edges_to_bits(const struct dht11_edge *e, int n, u8 data[5])
+{
+    int i, pulses = 0, bit = 0;
 
-    if (wait_pin_status(0, 250) < 0) { ret = -ETIMEDOUT; goto out; }
-    if (wait_pin_status(1, 250) < 0) { ret = -ETIMEDOUT; goto out; }
-    if (wait_pin_status(0, 250) < 0) { ret = -ETIMEDOUT; goto out; }
+    for (i = 0; i + 1 < n; i++)
+        if (e[i].high && !e[i + 1].high)
+            pulses++;
+    if (pulses < DHT11_BITS)
+        return pulses;
 
-    for (i = 0; i < 40; i++) {
-        if (wait_pin_status(1, 250) < 0) { ret = -ETIMEDOUT; goto out; }
-        udelay(35);
-        if (gpio_get_value(GPIO_PIN))
-            data[i/8] |= (1 << (7 - (i % 8)));
-        // ✅ 0/1 상관없이 항상 LOW까지 기다림
-        if (wait_pin_status(0, 250) < 0) { ret = -ETIMEDOUT; goto out; }
+    memset(data, 0, 5);
+    for (i = 0; i + 1 < n; i++) {
+        if (!e[i].high || e[i + 1].high)
+            continue;
+        if (pulses-- > DHT11_BITS)
+            continue;
+        dht11_put_bit(data, bit++, e[i + 1].ns - e[i].ns >= DHT11_ONE_MIN_NS);
     }
+    return bit;
+}
 
-out:
-    local_irq_restore(flags);
-    preempt_enable();
+/* 양 에지마다 시각만 적는다. 해석은 프레임이 끝난 뒤 process context에서 */
+static irqreturn_t dht11_edge_irq(int irq, void *dev_id)
+{
+    struct dht11 *d = dev_id;
+    int n = d->num_edges;
 
-    if (ret) return ret;
+    if (n < DHT11_EDGES_MAX) {
+        d->edges[n].ns = ktime_get_ns();
+        d->edges[n].high = gpiod_get_value(d->gpio);
+        d->num_edges = ++n;
+        if (n == DHT11_EDGES_FRAME)
+            mod_delayed_work(system_highpri_wq, &d->capture_work, 0);   // 타임아웃 기다리지 않고 바로 해석
+    }
+    return IRQ_HANDLED;
+}
 
-    if (data[4] != ((data[0]+data[1]+data[2]+data[3]) & 0xFF))
-        return -EIO;
+/* 캡처 하나 끝: 캐시/통계 갱신 후 기다리던 콜백들을 부른다 (capture_work에서만) */
+static void dht11_finish(struct dht11 *d, int ret, int t, int h)
+{
+    struct dht11_waiter w[DHT11_MAX_WAITERS];
+    unsigned long flags;
+    ktime_t kt = ktime_get();
+    int i, n;
 
-    *humi = data[0];
-    *temp = data[2];
-    return 0;
+    if (ret)
+        t = h = -1;
+    trace_dht11_result(d->dev, ret, t, h);
+
+    mutex_lock(&d->cb_lock);
+    spin_lock_irqsave(&d->lock, flags);
+    d->last_err = ret;
+    d->last_kt = kt;
+    d->finished = true;
+    if (ret) {
+        d->reads_failed++;
+    } else {
+        d->temp = t;
+        d->humi = h;
+        d->sample_kt = kt;
+        d->sampled = true;
+        d->reads_ok++;
+    }
+    n = d->nwaiters;
+    memcpy(w, d->waiters, n * sizeof(w[0]));
+    d->nwaiters = 0;
+    d->state = DHT11_ST_IDLE;
+    spin_unlock_irqrestore(&d->lock, flags);
+
+    for (i = 0; i < n; i++)
+        w[i].done(w[i].data, ret, t, h, kt);
+    mutex_unlock(&d->cb_lock);
+
+    // 콜백 도는 사이 새로 들어온 요청 (콜백이 다시 건 것 포함)
+    spin_lock_irqsave(&d->lock, flags);
+    if (d->nwaiters)
+        dht11_kick_locked(d);
+    spin_unlock_irqrestore(&d->lock, flags);
 }
 
+/*
+ * 캡처 상태 머신. 단계 사이의 기다림은 전부 지연 work라서 잠자는 호출자가 없다.
+ * highpri workqueue: 선을 놓는 시점이 밀리면 센서가 시작 펄스를 놓칠 수 있다.
+ */
+static void dht11_capture_fn(struct work_struct *work)
+{
+    struct dht11 *d = container_of(to_delayed_work(work), struct dht11, capture_work);
+    enum dht11_state state;
+    unsigned long flags;
+    u8 data[5] = {0};
+    int bits, t = -1, h = -1, ret;
+    bool removing;
+
+    spin_lock_irqsave(&d->lock, flags);
+    state = d->state;
+    removing = d->removing;
+    spin_unlock_irqrestore(&d->lock, flags);
+
+    if (removing && state != DHT11_ST_IDLE) {
+        if (state == DHT11_ST_DECODE)
+            free_irq(d->irq, d);
+        gpiod_direction_input(d->gpio);
+        dht11_finish(d, -ENODEV, -1, -1);
+        return;
+    }
+
+    switch (state) {
+    case DHT11_ST_START:
+        trace_dht11_capture_start(d->dev);
+        gpiod_direction_output(d->gpio, 0);
+        WRITE_ONCE(d->state, DHT11_ST_RELEASE);   // IDLE이 아닌 동안 state는 capture_work만 바꾼다
+        // 타이머는 jiffy 경계에서 나가므로 첫 tick이 짧을 수 있다: 한 jiffy 더 (18ms 밑으로 가면 센서가 무시)
+        queue_delayed_work(system_highpri_wq, &d->capture_work,
+                           msecs_to_jiffies(DHT11_START_MS) + 1);
+        return;
+
+    case DHT11_ST_RELEASE:
+        /*
+         * 선을 놓으면(pull-up) 센서가 20~40us 뒤 응답한다. IRQ로 잡힌 선은 gpiolib이 출력으로
+         * 못 바꾸므로 IRQ는 입력으로 돌린 뒤 이 프레임 동안만 건다. 그 사이 놓친 앞쪽 에지는
+         * dht11_edges_to_bits가 건너뛴다. IRQ는 계속 켜져 있다.
+         */
+        d->num_edges = 0;
+        WRITE_ONCE(d->state, DHT11_ST_DECODE);
+        spin_lock_irqsave(&d->lock, flags);
+        d->resp_kt = ktime_get();
+        spin_unlock_irqrestore(&d->lock, flags);
+        gpiod_direction_input(d->gpio);
+        ret = request_irq(d->irq, dht11_edge_irq, IRQF_TRIGGER_RISING | IRQF_TRIGGER_FALLING,
+                          dev_name(d->dev), d);
+        if (ret) {
+            dht11_finish(d, ret, -1, -1);
+            return;
+        }
+        // 83번째 에지에서 핸들러가 앞당긴다
+        queue_delayed_work(system_highpri_wq, &d->capture_work,
+                           msecs_to_jiffies(DHT11_FRAME_TIMEOUT_MS));
+        return;
+
+    case DHT11_ST_DECODE:
+        free_irq(d->irq, d);    // 돌고 있는 핸들러가 끝난 뒤 돌아옴 -> 이제 edges는 우리 것
+
+        bits = dht11_edges_to_bits(d->edges, d->num_edges, data);
+        ret = bits < DHT11_BITS ? -ETIMEDOUT : 0;
+        trace_dht11_capture_end(d->dev, d->num_edges, bits, ret);
+        if (!ret)
+            ret = dht11_decode(data, &t, &h);
+        dht11_finish(d, ret, t, h);
+        return;
+
+    case DHT11_ST_IDLE:
+        return;                 // 핸들러가 늦게 앞당긴 것
+    }
+}
 
 static const struct file_operations fops = {
-    .read  = dht11_dev_read
+    .owner   = THIS_MODULE,
+    .open    = dht11_dev_open,
+    .read    = dht11_dev_read,
+    .release = dht11_dev_release,
 };
 
-static int __init dht11_driver_init(void)
+static int dht11_probe(struct platform_device *pdev)
 {
+    struct device *dev = &pdev->dev;
+    struct dht11_pdata *pdata = dev_get_platdata(dev);
+    struct dht11 *d;
     int ret;
 
-    printk(KERN_INFO "=== dht11 initializing ====\n");
+    d = kzalloc(sizeof(*d), GFP_KERNEL);
+    if (!d)
+        return -ENOMEM;
+    kref_init(&d->ref);
+    // 제일 먼저 건 devm 액션이라 hwmon/GPIO가 다 풀린 뒤에 놓는다
+    ret = devm_add_action_or_reset(dev, dht11_put, d);
+    if (ret)
+        return ret;
+    d->dev = dev;
+    spin_lock_init(&d->lock);
+    mutex_init(&d->cb_lock);
+    INIT_DELAYED_WORK(&d->capture_work, dht11_capture_fn);
+    d->state = DHT11_ST_IDLE;
+    d->resp_kt = ktime_sub(ktime_get(), ms_to_ktime(DHT11_PERIOD_MIN_MS));
+    mutex_init(&d->refresh_lock);
+    d->interval_ms = DHT11_INTERVAL_DEF_MS;
+
+    /* 1. GPIO: 모듈 파라미터(board info)면 번호로, 아니면 DT gpios */
+    if (pdata) {
+        ret = devm_gpio_request_one(dev, pdata->gpio, GPIOF_IN, "my_DHT11_data_pin");
+        if (ret) {
+            dev_err(dev, "ERROR: gpio_request %d\n", pdata->gpio);
+            return ret;
+        }
+        d->gpio = gpio_to_desc(pdata->gpio);
+    } else {
+        d->gpio = devm_gpiod_get(dev, NULL, GPIOD_IN);
+        if (IS_ERR(d->gpio))
+            return dev_err_probe(dev, PTR_ERR(d->gpio), "no data gpio\n");
+    }
+    d->irq = gpiod_to_irq(d->gpio);
+    if (d->irq < 0)
+        return dev_err_probe(dev, d->irq, "data gpio has no irq\n");
+
+    /* 2. 문자 디바이스: 0번은 예전 이름(/dev/dht11), 나머지는 /dev/dht11.N */
+    d->id = ida_alloc_max(&dht11_ida, DHT11_MAX_DEVS - 1, GFP_KERNEL);
+    if (d->id < 0)
+        return d->id;
 
-    /* 1. 문자 디바이스 번호 할당 */
-    ret = alloc_chrdev_region(&dev_num, 0, 1, DRIVER_NAME);
+    d->cdev = cdev_alloc();
+    if (!d->cdev) {
+        ret = -ENOMEM;
+        goto err_ida;
+    }
+    d->cdev->owner = THIS_MODULE;
+    d->cdev->ops = &fops;
+    ret = cdev_add(d->cdev, MKDEV(MAJOR(dev_num), d->id), 1);
     if (ret < 0) {
-        printk(KERN_ERR "ERROR: alloc_chrdev_region\n");
-        return ret;
+        kobject_put(&d->cdev->kobj);
+        goto err_ida;
     }
 
-    /* 2. cdev 등록 */
-    cdev_init(&dht11_cdev, &fops);
-    dht11_cdev.owner = THIS_MODULE;
+    if (d->id == 0)
+        d->cdev_dev = device_create_with_groups(dht11_class, dev, MKDEV(MAJOR(dev_num), d->id),
+                                                d, dht11_groups, DRIVER_NAME);
+    else
+        d->cdev_dev = device_create_with_groups(dht11_class, dev, MKDEV(MAJOR(dev_num), d->id),
+                                                d, dht11_groups, DRIVER_NAME ".%d", d->id);
+    if (IS_ERR(d->cdev_dev)) {
+        ret = PTR_ERR(d->cdev_dev);
+        goto err_cdev;
+    }
 
-    ret = cdev_add(&dht11_cdev, dev_num, 1);
+    platform_set_drvdata(pdev, d);
+
+    /* 3. 스케줄러에 등록 (id 순으로 넣어서 한 바퀴 순서가 일정하게) */
+    mutex_lock(&dht11_list_lock);
+    {
+        struct dht11 *pos;
+        struct list_head *at = &dht11_list;
+
+        list_for_each_entry(pos, &dht11_list, node) {
+            if (pos->id > d->id) {
+                at = &pos->node;
+                break;
+            }
+        }
+        list_add_tail(&d->node, at);
+    }
+    mutex_unlock(&dht11_list_lock);
+    if (READ_ONCE(array_period_ms))
+        mod_delayed_work(system_wq, &dht11_sched_work, 0);
+
+    /* 4. hwmon (/sys/class/hwmon/hwmonN): 없어도 /dev/dht11로 쓸 수 있으므로 실패해도 계속 */
+    d->hwmon = devm_hwmon_device_register_with_info(dev, DRIVER_NAME, d, &dht11_hwmon_chip, NULL);
+    if (IS_ERR(d->hwmon)) {
+        dev_warn(dev, "hwmon register failed: %ld\n", PTR_ERR(d->hwmon));
+        d->hwmon = NULL;
+    }
+
+    dev_info(dev, "dht11 #%d ready\n", d->id);
+    return 0;
+
+err_cdev:
+    cdev_del(d->cdev);
+err_ida:
+    ida_free(&dht11_ida, d->id);
+    return ret;
+}
+
+static int dht11_remove(struct platform_device *pdev)
+{
+    struct dht11 *d = platform_get_drvdata(pdev);
+    struct dht11_waiter w[DHT11_MAX_WAITERS];
+    unsigned long flags;
+    int i, n;
+
+    // 이 뒤로 스케줄러는 이 센서를 안 건드리고, 새 open도 못 찾는다
+    mutex_lock(&dht11_list_lock);
+    list_del(&d->node);
+    mutex_unlock(&dht11_list_lock);
+
+    // 새 요청을 막고 진행 중인 캡처는 -ENODEV로 끝낸다 (capture_fn이 removing을 보고 정리)
+    spin_lock_irqsave(&d->lock, flags);
+    d->removing = true;
+    spin_unlock_irqrestore(&d->lock, flags);
+    do {
+        flush_delayed_work(&d->capture_work);
+    } while (READ_ONCE(d->state) != DHT11_ST_IDLE);
+    cancel_delayed_work_sync(&d->capture_work);
+
+    // 캡처가 없었는데 남아 있던 요청
+    spin_lock_irqsave(&d->lock, flags);
+    n = d->nwaiters;
+    memcpy(w, d->waiters, n * sizeof(w[0]));
+    d->nwaiters = 0;
+    spin_unlock_irqrestore(&d->lock, flags);
+    for (i = 0; i < n; i++)
+        w[i].done(w[i].data, -ENODEV, -1, -1, ktime_get());
+
+    device_destroy(dht11_class, MKDEV(MAJOR(dev_num), d->id));
+    cdev_del(d->cdev);
+    ida_free(&dht11_ida, d->id);
+    return 0;   // d는 마지막 파일이 닫힐 때 dht11_put에서
+}
+
+static const struct of_device_id dht11_of_match[] = {
+    { .compatible = "kkk,dht11" },
+    { }
+};
+MODULE_DEVICE_TABLE(of, dht11_of_match);
+
+static struct platform_driver dht11_driver = {
+    .probe  = dht11_probe,
+    .remove = dht11_remove,
+    .driver = {
+        .name           = DRIVER_NAME,
+        .of_match_table = dht11_of_match,
+    },
+};
+
+static int __init dht11_driver_init(void)
+{
+    struct dht11_pdata pdata = { .gpio = gpio };
+    int ret;
+
+    printk(KERN_INFO "=== dht11 initializing ====\n");
+
+    /* 1. 문자 디바이스 번호 (인스턴스마다 minor 하나) */
+    ret = alloc_chrdev_region(&dev_num, 0, DHT11_MAX_DEVS, DRIVER_NAME);
     if (ret < 0) {
-        printk(KERN_ERR "ERROR: cdev_add\n");
-        unregister_chrdev_region(dev_num, 1);
+        printk(KERN_ERR "ERROR: alloc_chrdev_region\n");
         return ret;
     }
 
-    /* 3. class / device 생성 (udev용) */
+    /* 2. class (udev용) */
     dht11_class = class_create(THIS_MODULE, CLASS_NAME);
     if (IS_ERR(dht11_class)) {
         printk(KERN_ERR "ERROR: class_create\n");
-        cdev_del(&dht11_cdev);
-        unregister_chrdev_region(dev_num, 1);
-        return PTR_ERR(dht11_class);
+        ret = PTR_ERR(dht11_class);
+        goto err_chr;
     }
 
-    if (IS_ERR(device_create(dht11_class, NULL, dev_num,
-                             NULL, DRIVER_NAME))) {
-        printk(KERN_ERR "ERROR: device_create\n");
-        class_destroy(dht11_class);
-        cdev_del(&dht11_cdev);
-        unregister_chrdev_region(dev_num, 1);
-        return -ENOMEM;
-    }
+    /* 3. 드라이버 등록 -> DT 노드마다 probe */
+    ret = platform_driver_register(&dht11_driver);
+    if (ret)
+        goto err_class;
 
-    /* 4. GPIO 요청 및 설정 */
-    ret = gpio_request( GPIO_PIN, "my_DHT11_data_pin");
-    if (ret) {
-        printk(KERN_ERR "ERROR: gpio_request \n");
-        return -1;
+    /* 4. DT 없이 쓰던 예전 구성: gpio 파라미터로 기본 센서 하나 */
+    if (gpio >= 0) {
+        dht11_legacy = platform_device_register_data(NULL, DRIVER_NAME, 0,
+                                                     &pdata, sizeof(pdata));
+        if (IS_ERR(dht11_legacy)) {
+            ret = PTR_ERR(dht11_legacy);
+            dht11_legacy = NULL;
+            goto err_drv;
+        }
     }
 
     printk(KERN_INFO "dth11 driver init success\n");
     return 0;
+
+err_drv:
+    platform_driver_unregister(&dht11_driver);
+err_class:
+    class_destroy(dht11_class);
+err_chr:
+    unregister_chrdev_region(dev_num, DHT11_MAX_DEVS);
+    return ret;
 }
 
 static void __exit dht11_driver_exit(void)
 {
-    gpio_free(GPIO_PIN);
-    device_destroy(dht11_class, dev_num);
+    platform_device_unregister(dht11_legacy);
+    platform_driver_unregister(&dht11_driver);
+    cancel_delayed_work_sync(&dht11_sched_work);   // 센서가 다 빠졌으므로 다시 걸리지 않음
     class_destroy(dht11_class);
-    cdev_del(&dht11_cdev);
-    unregister_chrdev_region(dev_num, 1);
+    unregister_chrdev_region(dev_num, DHT11_MAX_DEVS);
     printk(KERN_INFO "DHT11_driver_exit !!!!\n");
 }
 
 module_init(dht11_driver_init);
 module_exit(dht11_driver_exit);
+
+#ifdef KKK_KUNIT_TEST
+#include "dht11_test.c"
+#endif
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * dht11 KUnit 테스트 (dht11.c 끝에서 include, make KUNIT=1)
+ * GPIO 없이 비트 조립(dht11_put_bit), 에지 시각 -> 비트(dht11_edges_to_bits),
+ * checksum 판정(dht11_decode)만 본다.
+ */
+#include <kunit/test.h>
+
+/* 5바이트를 센서가 보내는 순서(MSB부터 40비트)로 다시 조립 */
+static void dht11_test_assemble(const u8 in[5], u8 out[5])
+{
+    int i;
+
+    memset(out, 0, 5);
+    for (i = 0; i < 40; i++)
+        dht11_put_bit(out, i, in[i / 8] & (0x80 >> (i % 8)));
+}
+
+static void dht11_test_bits(struct kunit *test)
+{
+    static const u8 frames[][5] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0xff, 0xff, 0xff, 0xff, 0xfc },
+        { 0x3c, 0x00, 0x19, 0x00, 0x55 },
+        { 0x80, 0x01, 0x80, 0x01, 0x02 },
+    };
+    u8 out[5];
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(frames); i++) {
+        dht11_test_assemble(frames[i], out);
+        KUNIT_EXPECT_EQ(test, memcmp(out, frames[i], 5), 0);
+    }
+
+    // 첫 비트는 byte0의 MSB, 마지막 비트는 checksum의 LSB
+    memset(out, 0, 5);
+    dht11_put_bit(out, 0, true);
+    dht11_put_bit(out, 39, true);
+    dht11_put_bit(out, 20, false);
+    KUNIT_EXPECT_EQ(test, out[0], 0x80);
+    KUNIT_EXPECT_EQ(test, out[4], 0x01);
+    KUNIT_EXPECT_EQ(test, out[1] | out[2] | out[3], 0);
+}
+
+static void dht11_test_decode(struct kunit *test)
+{
+    const u8 ok[5]   = { 60, 0, 25, 0, 85 };    // 60%, 25C
+    const u8 bad[5]  = { 60, 0, 25, 0, 86 };
+    const u8 wrap[5] = { 0xff, 0x00, 0x02, 0x00, 0x01 };  // checksum은 하위 8비트만
+    int t = -1, h = -1;
+
+    KUNIT_EXPECT_EQ(test, dht11_decode(ok, &t, &h), 0);
+    KUNIT_EXPECT_EQ(test, t, 25);
+    KUNIT_EXPECT_EQ(test, h, 60);
+
+    t = h = -1;
+    KUNIT_EXPECT_EQ(test, dht11_decode(bad, &t, &h), -EIO);
+    KUNIT_EXPECT_EQ(test, t, -1);   // 실패면 결과를 건드리지 않음
+    KUNIT_EXPECT_EQ(test, h, -1);
+
+    KUNIT_EXPECT_EQ(test, dht11_decode(wrap, &t, &h), 0);
+    KUNIT_EXPECT_EQ(test, t, 2);
+    KUNIT_EXPECT_EQ(test, h, 255);
+}
+
+/* 센서 파형의 에지 목록: 응답(↓ 80us ↑ 80us ↓) 뒤 비트마다 ↑(27 또는 70us)↓(50us) */
+static int dht11_test_wave(const u8 in[5], struct dht11_edge *e)
+{
+    u64 t = 1000000;
+    int i, n = 0;
+
+    e[n++] = (struct dht11_edge){ t, false };
+    t += 80000;
+    e[n++] = (struct dht11_edge){ t, true };
+    t += 80000;
+    e[n++] = (struct dht11_edge){ t, false };
+    for (i = 0; i < 40; i++) {
+        t += 50000;
+        e[n++] = (struct dht11_edge){ t, true };
+        t += in[i / 8] & (0x80 >> (i % 8)) ? 70000 : 27000;
+        e[n++] = (struct dht11_edge){ t, false };
+    }
+    return n;
+}
+
+static void dht11_test_edges(struct kunit *test)
+{
+    const u8 frame[5] = { 0x3c, 0x00, 0x19, 0x00, 0x55 };
+    struct dht11_edge e[DHT11_EDGES_MAX + 1];
+    u8 out[5];
+    int n;
+
+    n = dht11_test_wave(frame, e);
+    KUNIT_EXPECT_EQ(test, n, DHT11_EDGES_FRAME);
+    KUNIT_EXPECT_EQ(test, dht11_edges_to_bits(e, n, out), 40);
+    KUNIT_EXPECT_EQ(test, memcmp(out, frame, 5), 0);
+
+    // IRQ를 늦게 걸어 응답 ↓↑를 놓쳐도 마지막 40개 펄스로 같은 값
+    KUNIT_EXPECT_EQ(test, dht11_edges_to_bits(e + 2, n - 2, out), 40);
+    KUNIT_EXPECT_EQ(test, memcmp(out, frame, 5), 0);
+
+    // 끝에 센서가 선을 놓는 ↑가 더 와도 HIGH 펄스가 아니므로 무시
+    e[n] = (struct dht11_edge){ e[n - 1].ns + 50000, true };
+    KUNIT_EXPECT_EQ(test, dht11_edges_to_bits(e, n + 1, out), 40);
+    KUNIT_EXPECT_EQ(test, memcmp(out, frame, 5), 0);
+
+    // 중간에 끊긴 프레임: 받은 HIGH 펄스 수만 (응답 HIGH 포함)
+    KUNIT_EXPECT_EQ(test, dht11_edges_to_bits(e, 3 + 2 * 20, out), 21);
+    KUNIT_EXPECT_EQ(test, dht11_edges_to_bits(e, 0, out), 0);
+}
+
+static struct kunit_case dht11_test_cases[] = {
+    KUNIT_CASE(dht11_test_bits),
+    KUNIT_CASE(dht11_test_edges),
+    KUNIT_CASE(dht11_test_decode),
+    {}
+};
+
+static struct kunit_suite dht11_test_suite = {
+    .name = "dht11",
+    .test_cases = dht11_test_cases,
+};
+kunit_test_suite(dht11_test_suite);
@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * dht11 tracepoints (/sys/kernel/tracing/events/dht11/)
+ * 꺼져 있으면 호출 자리는 static key 분기 하나뿐이다.
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM dht11
+
+#if !defined(_DHT11_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _DHT11_TRACE_H
+
+#include <linux/tracepoint.h>
+#include <linux/device.h>
+
+/* 시작 신호(LOW 20ms) 직전 */
+TRACE_EVENT(dht11_capture_start,
+    TP_PROTO(struct device *dev),
+    TP_ARGS(dev),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+    ),
+    TP_printk("%s", __get_str(dev))
+);
+
+/* 프레임이 끝나고 IRQ를 푼 직후: 받은 에지 수, 그 중 HIGH 펄스로 읽은 비트 수 (40이면 완전) */
+TRACE_EVENT(dht11_capture_end,
+    TP_PROTO(struct device *dev, int edges, int bits, int ret),
+    TP_ARGS(dev, edges, bits, ret),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(int, edges)
+        __field(int, bits)
+        __field(int, ret)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->edges = edges;
+        __entry->bits = bits;
+        __entry->ret = ret;
+    ),
+    TP_printk("%s edges=%d bits=%d ret=%d", __get_str(dev),
+              __entry->edges, __entry->bits, __entry->ret)
+);
+
+/* checksum까지 본 최종 결과 (실패면 temp/humi = -1) */
+TRACE_EVENT(dht11_result,
+    TP_PROTO(struct device *dev, int ret, int temp, int humi),
+    TP_ARGS(dev, ret, temp, humi),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(int, ret)
+        __field(int, temp)
+        __field(int, humi)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->ret = ret;
+        __entry->temp = temp;
+        __entry->humi = humi;
+    ),
+    TP_printk("%s ret=%d temp=%d humi=%d", __get_str(dev),
+              __entry->ret, __entry->temp, __entry->humi)
+);
+
+#endif /* _DHT11_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE dht11_trace
+#include <trace/define_trace.h>
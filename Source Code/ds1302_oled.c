@@ -3,6 +3,7 @@
 #include <linux/kernel.h>
 #include <linux/init.h>
 #include <linux/gpio.h>
+#include <linux/gpio/consumer.h>
 #include <linux/delay.h>
 #include <linux/workqueue.h>
 #include <linux/i2c.h>
@@ -14,75 +15,180 @@
 #include <linux/mutex.h>
 #include <linux/jiffies.h>
 #include <linux/types.h>
-extern void rotary_irq_enable(bool on);
-// UI 주기 / 센서 주기 / blink 주기
-#define UI_TICK_MS   50
+#include <linux/fb.h>
+#include <linux/mm.h>
+#include <linux/atomic.h>
+#include <linux/bitops.h>
+#include <linux/ktime.h>
+#include <linux/timekeeping.h>
+#include <linux/time.h>
+#include <linux/math64.h>
+#include <linux/hrtimer.h>
+#include <linux/rtc.h>
+#include <linux/nvmem-provider.h>
+#include <linux/of.h>
+#include <linux/property.h>
+#include <linux/idr.h>
+#include <linux/slab.h>
+#include <linux/kref.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/build_bug.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "ds1302_oled_ioctl.h"
+
+#define CREATE_TRACE_POINTS
+#include "ds1302_oled_trace.h"
+
+//oled/ds1302 모듈에서 dht11/rotary 인스턴스를 직접 호출 (dev = 각 모듈의 장치)
+extern struct device *dht11_find_device(struct device_node *np, const char *name);
+extern int dht11_read_async(struct device *dev,
+                            void (*done)(void *data, int err, int temp, int humi, ktime_t kt),
+                            void *data);
+extern void dht11_cancel_async(struct device *dev,
+                               void (*done)(void *data, int err, int temp, int humi, ktime_t kt),
+                               void *data);
+extern struct device *rotary_find_device(struct device_node *np, const char *name);
+extern void rotary_irq_enable(struct device *dev, bool on);
+extern void rotary_set_event_cb(struct device *dev, void (*cb)(void *), void *data);
+extern int rotary_get_event(struct device *dev);
+enum rotary_evt_type {
+    ROT_EV_NONE = 0,
+    ROT_EV_CW,
+    ROT_EV_CCW,
+    ROT_EV_BTN_DOWN,
+    ROT_EV_BTN_UP,
+};
+
+// 센서 주기 (UI는 이벤트가 있을 때만 깨어남)
 #define SENSE_TICK_MS 1000
 
 #define DRIVER_NAME   "ds1302_oled"
 #define CLASS_NAME    "ds1302_oled_class"
+#define DS_MAX_DEVS   8
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("kkk");
 MODULE_DESCRIPTION("DS1302(bitbang) -> SSD1306(I2C) show date/time every 1s");
 
-struct ds_time;  // 전방 선언
-static int ds1302_read_time(struct ds_time *t);
-static int ds1302_set_datetime(const struct ds_time *t);
-static unsigned long last_sense_j = 0;
-static unsigned long last_blink_j = 0;
-static struct ds_time t_cache;
-
-static int temp_cache = -1, humi_cache = -1;
-static bool cache_ok = false;
-static unsigned long last_sense_j;
-
-//oled/ds1302 모듈에서 dht11값을 직접 호출
-extern int dht11_read_values(int *temp, int *humi);
-extern int rotary_get_event(void);
-enum rotary_evt_type {
-    ROT_EV_NONE = 0,
-    ROT_EV_CW,
-    ROT_EV_CCW,
-    ROT_EV_BTN_DOWN,
-    ROT_EV_BTN_UP,
-};
-static dev_t dev_num;
-static struct cdev ds_cdev;
-static struct class *ds_class;
-static struct device *ds_dev;
-
-static DEFINE_MUTEX(ds_lock); // DS1302 동시접근 방지
+/*
+ * 시계 한 대(SSD1306 하나 + DS1302 하나 + 선택적으로 DHT11/로터리)가 인스턴스 하나.
+ * SSD1306 I2C client에 붙는 i2c 드라이버이고, 나머지는 같은 노드에서 가져온다.
+ *
+ *   device tree:
+ *     clock@3c {
+ *         compatible = "kkk,ds1302-oled";
+ *         reg = <0x3c>;
+ *         ce-gpios = <&gpio 12 0>; clk-gpios = <&gpio 5 0>; dat-gpios = <&gpio 6 0>;
+ *         dht11 = <&dht0>;     // 없으면 온습도 표시 없음
+ *         rotary = <&rot0>;    // 없으면 SET 모드 없음
+ *     };
+ *
+ * DT가 없으면 모듈 로딩 때 아래 파라미터로 기본 인스턴스 하나를 만든다 (i2c_bus=-1이면 안 만듦).
+ * 인스턴스마다 work/timer/lock이 따로라 서로 기다리지 않는다.
+ */
 
-// -------------------- DS1302 GPIO params --------------------
+// -------------------- DS1302 GPIO params (기본 인스턴스) --------------------
 static int ds_ce_gpio  = 12;  // DS1302 CE(RST)
 static int ds_clk_gpio = 5;   // DS1302 CLK
 static int ds_dat_gpio = 6;   // DS1302 DAT (I/O)
-module_param(ds_ce_gpio, int, 0644);
-module_param(ds_clk_gpio, int, 0644);
-module_param(ds_dat_gpio, int, 0644);
+module_param(ds_ce_gpio, int, 0444);
+module_param(ds_clk_gpio, int, 0444);
+module_param(ds_dat_gpio, int, 0444);
+
+// DS1302 전원 전압: 데이터시트 AC 특성이 2.0V/5.0V 두 가지라 4.5V 미만이면 2.0V 값을 쓴다
+// (DT에서는 인스턴스마다 vcc-mv 속성)
+static int ds_vcc_mv = 3300;
+module_param(ds_vcc_mv, int, 0444);
 
 // -------------------- I2C OLED params (i2c-gpio bus=8, addr=0x3C) --------------------
 static int i2c_bus  = 1;
 static int i2c_addr = 0x3C;
-module_param(i2c_bus, int, 0644);
-module_param(i2c_addr, int, 0644);
+module_param(i2c_bus, int, 0444);
+module_param(i2c_addr, int, 0444);
+MODULE_PARM_DESC(i2c_bus, "I2C bus of the default clock (-1 = none, use device tree)");
+
+// 기본 인스턴스가 쓸 센서/엔코더 장치 이름 (""이면 없이)
+static char *dht11_dev = "dht11.0";
+static char *rotary_dev = "rotary.0";
+module_param(dht11_dev, charp, 0444);
+module_param(rotary_dev, charp, 0444);
+
+// /dev/fbN 으로 패널을 user space에 노출 (열려 있는 동안은 시계 화면을 멈춤)
+static bool fbdev = true;
+module_param(fbdev, bool, 0444);
 
-// (선택) 모듈 로딩 시 DS1302 초기 세팅하고 싶으면 init_datetime=YYYYMMDDhhmmss
+// 1이면 윈도우 명령+데이터를 한 i2c_transfer로 보냄, 0이면 예전 16바이트 쪼개기 방식
+static bool oled_single_xfer = true;
+module_param(oled_single_xfer, bool, 0644);
+
+// (선택) 모듈 로딩 시 DS1302 초기 세팅하고 싶으면 init_datetime=YYYYMMDDhhmmss (파라미터로 만든 기본 인스턴스)
 static char *init_datetime = NULL;
 module_param(init_datetime, charp, 0644);
 
-// I2C 객체
-static struct i2c_adapter *oled_adap;
-static struct i2c_client  *oled_i2c;
+// RTC class(/dev/rtcN)로도 등록 (hwclock, rtc-hctosys, RTC 알람)
+static bool rtc_class = true;
+module_param(rtc_class, bool, 0444);
+
+// DS1302 31바이트 배터리 백업 RAM을 nvmem으로 (/sys/bus/nvmem/devices/ds1302_nvram/nvmem)
+static bool nvram = true;
+module_param(nvram, bool, 0444);
+
+// nvmem 쓰기를 모아서 이만큼 뒤에 한 번에 DS1302에 쓴다 (0 = 바로 씀)
+static unsigned int nvram_writeback_ms = 1000;
+module_param(nvram_writeback_ms, uint, 0644);
+MODULE_PARM_DESC(nvram_writeback_ms, "delay before dirty NVRAM bytes are written back (0 = write-through)");
+
+// 시계(NORMAL 화면) 시간 글자 배율: 1=6x8, 2=12x16, 3=18x24, 4=24x32
+// 큰 글리프는 로딩 때 한 번만 만들어 두므로 로딩 후에는 못 바꾼다
+static int clock_scale = 1;
+module_param(clock_scale, int, 0444);
+MODULE_PARM_DESC(clock_scale, "clock digit scale 1..4 (6x8 .. 24x32)");
+
+/*
+ * RTC는 resync_sec마다(또는 쓰기 직후) 한 번만 burst read 하고, 그 사이는 커널 시계로 외삽
+ * (자세한 건 "DS1302 time cache" 참고)
+ */
+static unsigned int resync_sec = 600;
+module_param(resync_sec, uint, 0644);
+MODULE_PARM_DESC(resync_sec, "re-read the DS1302 every N seconds (0 = every time)");
+
+/* 기본 인스턴스 board info (DT 없을 때) */
+struct ds_oled_pdata {
+    int ce_gpio, clk_gpio, dat_gpio;
+    const char *dht11, *rotary;   // 장치 이름
+};
 
 // -------------------- OLED framebuffer --------------------
+// SSD1306 control byte: 0x80 = 명령 1바이트(Co=1), 0x40 = 이후 STOP까지 전부 데이터
+#define OLED_CTRL_CMD1  0x80
+#define OLED_CTRL_DATA  0x40
+#define OLED_XFER_HDR   13      // (0x80,cmd) x 6 + 0x40
+#define OLED_CHUNK_MAX  32      // 쪼개기 방식에서 한 번에 보낼 최대 데이터 바이트
+
 #define OLED_W   128
 #define OLED_H   64
+#define OLED_PAGES (OLED_H / 8)
 #define OLED_BUF (OLED_W * OLED_H / 8)
 
-static u8 fb[OLED_BUF];
-static struct delayed_work tick_work;
+// 같은 페이지 안에서 이 컬럼 수 이하의 틈은 윈도우를 새로 여는 것(명령 6바이트)보다
+// 그냥 같이 보내는 게 싸다
+#define OLED_RUN_GAP 6
+
+/* 페이지별 컬럼 범위 [lo, hi), lo >= hi 이면 비어 있음 */
+struct fb_span {
+    u8 lo, hi;
+};
+
+/* 윈도우 헤더 바로 뒤에 픽셀을 두면 전체 프레임은 복사 없이 메시지 하나로 나간다 */
+struct oled_fb {
+    u8 hdr[OLED_XFER_HDR];
+    u8 px[OLED_BUF];
+    struct fb_span dirty[OLED_PAGES]; // 마지막 flush 이후 바뀌었을 수 있는 영역
+    struct fb_span ink[OLED_PAGES];   // fb_clear 이후 그려진 영역
+};
 
 // -------------------- SET mode state --------------------
 enum ui_mode {
@@ -105,16 +211,204 @@ struct ds_time {
     u8 year; // 0..99 (display: 2000+year)
 };
 
-static enum ui_mode  g_mode = UI_NORMAL;
-static enum set_field g_field = FLD_HOUR;
+#define BTN_LONG_MS 1200
+#define BLINK_MS    500
 
-static struct ds_time g_edit;        // SET 모드에서 편집하는 시간
-static bool g_blink_on = true;
-static unsigned long g_last_blink_j = 0;
+/* DS1302 AC 타이밍 (ns) */
+struct ds_timing {
+    unsigned int tcl, tch;  // CLK low/high 폭
+    unsigned int tcdd;      // CLK↓ -> 읽기 데이터 유효
+    unsigned int tcc;       // CE↑ -> 첫 CLK↑
+    unsigned int tcwh;      // CE 비활성 유지
+};
 
+static const struct ds_timing ds_timing_2v = { 1000, 1000, 800, 4000, 4000 };
+static const struct ds_timing ds_timing_5v = {  250,  250, 200, 1000, 1000 };
 
-#define BTN_LONG_MS 1200
-#define BLINK_MS    500
+#define DS_RAM_SIZE 31
+
+/*
+ * log2 히스토그램 (debugfs). bucket[0] = 0, bucket[i] = [2^(i-1), 2^i), 마지막 칸은 그 이상 전부.
+ * tick과 flush worker가 따로 갱신하므로 히스토그램마다 락 하나.
+ */
+#define DS_HIST_BUCKETS 24
+
+struct ds_hist_data {
+    u32 bucket[DS_HIST_BUCKETS];
+    u64 count, sum, max;
+};
+
+struct ds_hist {
+    spinlock_t lock;
+    const char *unit;
+    struct ds_hist_data v;
+};
+
+/* 인스턴스 하나의 상태 전부 */
+struct ds_oled {
+    struct device *dev;               // SSD1306 i2c client
+    struct i2c_client *oled_i2c;
+    int id;                           // 0 = /dev/ds1302_oled, 나머지 /dev/ds1302_oled.N
+
+    struct device *dht;               // dht11 장치 (없으면 NULL)
+    struct device *rot;               // rotary 장치 (없으면 NULL)
+
+    // DS1302 비트뱅
+    struct mutex ds_lock;             // DS1302 동시접근 방지 (+ 아래 캐시들)
+    struct gpio_desc *ds_ce_d, *ds_clk_d, *ds_dat_d;
+    struct gpio_desc *ds_bus_d[2];    // [0]=CLK, [1]=DAT (gpiod_set_array_value 용)
+    bool ds_dat_is_out;
+    const struct ds_timing *ds_t;
+    unsigned int ds_byte_ns;          // 마지막 clock burst read의 바이트당 시간 (sysfs: rtc_byte_ns)
+
+    // DS1302 time cache
+    struct ds_time ds_anchor;         // 앵커 시각의 RTC 값
+    time64_t ds_anchor_secs;          // ds_anchor를 초 단위로
+    ktime_t ds_anchor_kt;             // ds_anchor에 해당하는 boottime
+    ktime_t ds_sync_kt;               // 마지막으로 실제로 읽은 boottime
+    bool ds_anchor_ok;                // false면 다음 get에서 실제로 읽음
+    bool ds_anchor_aligned;           // ds_anchor_kt가 실제 초 경계인지
+    unsigned int ds_write_gen;        // 쓰기마다 증가 (정렬 도중 쓰기가 끼었는지 확인)
+    unsigned long ds_rtc_reads;       // 실제 burst read 횟수 (sysfs: rtc_reads)
+
+    struct work_struct align_work;
+    struct hrtimer sec_timer;
+    bool sec_timer_on;                // 경계 정렬 완료, sec_timer가 rtc_work를 깨우는 중 (ds_lock에서 켜고 끔)
+    bool ui_stopping;                 // 내리는 중: 더 이상 아무것도 다시 걸지 않음
+
+    // RTC class + 알람 에뮬레이션 (ds_lock)
+    struct rtc_device *ds_rtc;
+    struct hrtimer alarm_timer;
+    time64_t ds_alarm_secs;
+    bool ds_alarm_enabled;
+
+    // DS1302 RAM (ds_lock)
+    u8 ds_ram[DS_RAM_SIZE];
+    bool ds_ram_valid;
+    u32 ds_ram_dirty;                 // BIT(i): ds_ram[i]가 아직 칩에 안 써짐
+    struct delayed_work ram_flush_work;
+
+    // 어댑터 능력 (oled_xfer_setup에서 채움)
+    size_t oled_chunk;                // 쪼개기 방식 데이터 바이트 수
+    size_t oled_max_msg;              // quirks->max_write_len, 0이면 제한 없음
+    int    oled_max_msgs;             // quirks->max_num_msgs, 0이면 제한 없음
+    bool   oled_nostart;              // I2C_M_NOSTART로 헤더+행들을 이어 붙일 수 있음
+
+    /*
+     * front/back 두 장
+     *  - 렌더(tick)는 항상 fb_back에 그리고 버스는 기다리지 않는다.
+     *  - flush worker는 완성된 fb_back을 fb_front와 바꾼 뒤 fb_front를 보낸다.
+     *  - worker가 가져가기 전에 다음 렌더가 시작되면 그 프레임은 버린다(최신 프레임 우선).
+     */
+    struct oled_fb oled_fbs[2];
+    struct oled_fb *fb_back;
+    struct oled_fb *fb_front;
+    spinlock_t fb_lock;               // fb_back/fb_front 교환, fb_drawing, fb_ready
+    bool fb_drawing;                  // 렌더가 fb_back에 그리는 중
+    bool fb_ready;                    // fb_back에 아직 안 나간 완성 프레임이 있음
+    struct workqueue_struct *oled_wq;
+    struct work_struct oled_flush_work;
+    struct mutex render_lock;         // fb_back에 그리는 쪽(tick, fbdev)은 한 번에 하나만
+
+    // 여기서부터는 flush worker만 만진다
+    u8 oled_stage[OLED_XFER_HDR + OLED_BUF]; // NOSTART 없는 어댑터에서 부분 윈도우 모을 때
+    u8 fb_shadow[OLED_BUF];           // 실제 패널에 올라가 있는 내용
+    bool fb_shadow_valid;             // false면 다음 flush는 전체 전송
+    struct fb_span panel_ink[OLED_PAGES]; // 패널에 올라간 프레임의 ink
+    unsigned int flush_windows, flush_bytes; // 지금 보내는 프레임의 윈도우/데이터 바이트 (trace)
+
+    // 프레임 통계 (sysfs: frames_sent, frames_dropped)
+    unsigned long frames_sent, frames_dropped;
+    unsigned long i2c_errors;         // flush 중 I2C 에러 (flush worker만)
+
+    // debugfs: <debugfs>/ds1302_oled/<dev>/
+    struct ds_hist h_tick, h_render, h_flush, h_flush_bytes;
+    unsigned long dbg_frames_base, dbg_dropped_base, dbg_errors_base; // reset 때 값
+    ktime_t dbg_reset_kt;
+
+    // fbdev
+    struct fb_info *oled_fbi;
+    struct fb_deferred_io fb_defio;
+    u8 fbdev_px[OLED_BUF];            // user space 화면을 페이지 형식으로 바꿔 둔 것
+    atomic_t fb_users;
+
+    // UI (tick_work에서만)
+    struct delayed_work tick_work;
+    bool ui_dirty;                    // 화면에 반영할 상태가 바뀌었으면 true
+    unsigned int ui_wakeups, ui_frames;   // 1초 창 단위 통계
+    unsigned int ui_wakeups_ps, ui_frames_ps;
+    unsigned long ui_stat_j;
+    unsigned long last_blink_j;
+    atomic64_t kick_ns;               // 처음 kick한 시각 (ktime ns, 0 = 없음). tick 지연 측정용
+    u32 tick_lat_max_us, tick_run_max_us;         // 1초 창 최대: kick -> tick 시작, tick 실행 시간
+    u32 tick_lat_max_us_ps, tick_run_max_us_ps;
+
+    enum ui_mode  mode;
+    enum set_field field;
+    struct ds_time edit;              // SET 모드에서 편집하는 시간
+    struct ds_time edit_orig;         // SET 진입 때 읽은 값 (저장 시 바뀐 레지스터만 쓰려고)
+    bool blink_on;
+    bool set_saving;                  // 저장 요청을 올리고 rtc_work의 결과를 기다리는 중 (입력 무시)
+
+    /*
+     * 센서 producer (sense_wq). 버스/센서를 기다리는 건 여기서만 하고
+     * 결과는 sense_lock 아래 캐시에 올린다. tick은 복사만 하고 절대 기다리지 않는다.
+     */
+    struct workqueue_struct *sense_wq;
+    struct delayed_work dht_work;     // SENSE_TICK_MS마다 dht11
+    struct delayed_work rtc_work;     // 초 경계마다(sec_timer), 정렬 전에는 SENSE_TICK_MS마다
+    spinlock_t sense_lock;            // 아래 캐시 + sense_changed
+    struct ds_time t_cache;
+    int temp_cache, humi_cache;
+    bool cache_ok;
+    bool sense_changed;               // tick이 아직 안 가져간 변경이 있음
+    // SET 저장: tick이 올리고 rtc_work가 DS1302에 쓴 뒤 결과를 돌려준다
+    struct ds_time set_req;
+    unsigned int set_mask;
+    bool set_pending;                 // rtc_work가 아직 안 씀
+    bool set_done;                    // set_ret이 나왔고 tick이 아직 안 가져감
+    int set_ret;
+
+    // /dev/ds1302_oled
+    wait_queue_head_t poll_wq;        // 초가 넘어가거나 시간이 바뀌면 깨움
+    atomic_t poll_seq;                // 그 이벤트 횟수 (파일마다 마지막으로 본 값과 비교)
+    struct cdev *ds_cdev;             // cdev_alloc: 열린 파일이 남아 있으면 마지막 close까지 산다
+    struct device *ds_dev;
+
+    /*
+     * 열린 파일이 unbind 뒤에도 이 구조체를 잡고 있을 수 있어서 devm이 아니라 kref로 푼다.
+     * probe가 하나, 열린 파일마다 하나. gone(ds_lock)이 선 뒤 파일 경로는 -ENODEV만 돌려준다.
+     */
+    struct kref ref;
+    bool gone;
+};
+
+static dev_t dev_num;
+static struct class *ds_class;
+static DEFINE_IDA(ds_ida);
+static struct ds_oled *ds_devs[DS_MAX_DEVS];   // minor -> 인스턴스 (open에서 찾기)
+static DEFINE_MUTEX(ds_devs_lock);
+static struct i2c_client *ds_legacy;
+
+static struct dentry *ds_debugfs_root;
+
+static int ds1302_get_time(struct ds_oled *d, struct ds_time *t);
+static int ds1302_set_regs(struct ds_oled *d, const struct ds_time *t, unsigned int mask);
+static unsigned int ds_time_diff(const struct ds_time *a, const struct ds_time *b);
+static u8 ds_time_wday(const struct ds_time *t);
+
+static void ds_hist_add(struct ds_hist *h, u64 v)
+{
+    int i = v ? min_t(int, fls64(v), DS_HIST_BUCKETS - 1) : 0;
+
+    spin_lock(&h->lock);
+    h->v.bucket[i]++;
+    h->v.count++;
+    h->v.sum += v;
+    if (v > h->v.max)
+        h->v.max = v;
+    spin_unlock(&h->lock);
+}
 
 static inline int clamp_int(int v, int lo, int hi)
 {
@@ -137,12 +431,12 @@ static int days_in_month(int year4, int mon)
 }
 
 /* 필드 증감 */
-static void edit_add(struct ds_time *t, int delta)
+static void edit_add(struct ds_time *t, enum set_field field, int delta)
 {
     int year4 = 2000 + t->year;
     int v;
 
-    switch (g_field) {
+    switch (field) {
     case FLD_YEAR:
         v = year4 + delta;
         v = clamp_int(v, 2000, 2099);
@@ -195,67 +489,105 @@ static void edit_add(struct ds_time *t, int delta)
     }
 }
 
-static void field_next(void)
+static void field_next(struct ds_oled *d)
 {
-    switch (g_field) {
-    case FLD_YEAR: g_field = FLD_MON;  break;
-    case FLD_MON:  g_field = FLD_MDAY; break;
-    case FLD_MDAY: g_field = FLD_HOUR; break;
-    case FLD_HOUR: g_field = FLD_MIN;  break;
-    case FLD_MIN:  g_field = FLD_SEC;  break;
-    default:       g_field = FLD_YEAR; break; // FLD_SEC 포함해서 여기로
+    switch (d->field) {
+    case FLD_YEAR: d->field = FLD_MON;  break;
+    case FLD_MON:  d->field = FLD_MDAY; break;
+    case FLD_MDAY: d->field = FLD_HOUR; break;
+    case FLD_HOUR: d->field = FLD_MIN;  break;
+    case FLD_MIN:  d->field = FLD_SEC;  break;
+    default:       d->field = FLD_YEAR; break; // FLD_SEC 포함해서 여기로
     }
 }
 
-/* NORMAL->SET 진입: 현재 RTC 읽어서 편집 버퍼에 로드 */
-static int enter_set_mode(void)
+/*
+ * NORMAL->SET 진입: rtc_work가 올려 둔 시간을 편집 버퍼에 로드.
+ * tick에서 불리므로 DS1302를 직접 읽지 않는다. 아직 못 읽었으면 읽기만 재촉하고 진입하지 않음.
+ */
+static int enter_set_mode(struct ds_oled *d)
 {
     struct ds_time t;
-    int ret;
-
-    mutex_lock(&ds_lock);
-    ret = ds1302_read_time(&t);
-    mutex_unlock(&ds_lock);
-    if (ret) 
-        return ret;
+    bool ok;
+
+    spin_lock(&d->sense_lock);
+    t = d->t_cache;
+    ok = d->cache_ok;
+    spin_unlock(&d->sense_lock);
+    if (!ok) {
+        mod_delayed_work(d->sense_wq, &d->rtc_work, 0);
+        return -EAGAIN;
+    }
 
-    g_edit = t;
-    g_mode = UI_SET;
-    g_field = FLD_YEAR;
-    rotary_irq_enable(true);
+    d->edit = t;
+    d->edit_orig = t;
+    d->mode = UI_SET;
+    d->field = FLD_YEAR;
+    rotary_irq_enable(d->rot, true);
 
-    g_blink_on = true;
-    g_last_blink_j = jiffies;
+    d->blink_on = true;
+    d->last_blink_j = jiffies;
     return 0;
 }
 
-static int save_and_exit_set_mode(void)
+/*
+ * SET 저장 요청: 쓰기는 rtc_work가 하고(ds_lock + 비트뱅), tick은 요청만 올린다.
+ * 결과는 save_done_set_mode()가 가져간다. 그때까지 SET 화면 유지, 입력은 무시.
+ */
+static void save_and_exit_set_mode(struct ds_oled *d)
 {
-    int ret;
-
-    /* 요일은 지금 구조상 1固定이니, 최소한 1로 유지 */
-    if (g_edit.wday == 0) g_edit.wday = 1;
+    unsigned int mask;
+
+    // 날짜를 바꿨으면 요일도 다시 계산 (UI에는 요일 필드가 없음)
+    if (d->edit.year != d->edit_orig.year || d->edit.mon != d->edit_orig.mon ||
+        d->edit.mday != d->edit_orig.mday)
+        d->edit.wday = ds_time_wday(&d->edit);
+    mask = ds_time_diff(&d->edit, &d->edit_orig);
+
+    // 사용자가 바꾼 필드만 쓴다 (안 건드린 분/초 등은 RTC에서 계속 흐르던 값 유지)
+    spin_lock(&d->sense_lock);
+    d->set_req = d->edit;
+    d->set_mask = mask;
+    d->set_pending = true;
+    d->set_done = false;
+    spin_unlock(&d->sense_lock);
+
+    d->set_saving = true;
+    mod_delayed_work(d->sense_wq, &d->rtc_work, 0);
+}
 
-   mutex_lock(&ds_lock);
-    ret = ds1302_set_datetime(&g_edit);
-    mutex_unlock(&ds_lock);
+/* rtc_work가 저장을 끝냈으면 결과 반영. 실패면 SET 유지, 로터리 IRQ도 유지 */
+static void save_done_set_mode(struct ds_oled *d)
+{
+    bool done;
+    int ret;
 
-    if (ret)
-        return ret;   // SET 유지, 로터리 IRQ도 유지
+    spin_lock(&d->sense_lock);
+    done = d->set_done;
+    ret = d->set_ret;
+    d->set_done = false;
+    spin_unlock(&d->sense_lock);
+    if (!done)
+        return;
 
-    rotary_irq_enable(false);
-    g_mode = UI_NORMAL;
-    return 0;
+    d->set_saving = false;
+    d->ui_dirty = true;
+    if (ret) {
+        dev_warn(d->dev, "ds1302: saving the time failed: %d\n", ret);
+        return;
+    }
+    rotary_irq_enable(d->rot, false);
+    d->mode = UI_NORMAL;
 }
 
 /* dt: "YYYY-MM-DD" (10 chars), tm: "HH:MM:SS" (8 chars)
  * 선택 필드를 blink_off일 때 공백으로 덮어쓴다.
  */
-static void apply_blink_mask(char *dt, char *tm, bool blink_on)
+static void apply_blink_mask(char *dt, char *tm, enum set_field field, bool blink_on)
 {
     if (blink_on) return;
 
-    switch (g_field) {
+    switch (field) {
     case FLD_YEAR:
         dt[0] = dt[1] = dt[2] = dt[3] = ' ';
         break;
@@ -280,106 +612,158 @@ static void apply_blink_mask(char *dt, char *tm, bool blink_on)
 }
 
 
-// -------------------- 6x8 font: digits + ':' + '-' + ' ' --------------------
-static const u8 font6x8[11][6] = {
-    {0x3E,0x51,0x49,0x45,0x3E,0x00}, //0
-    {0x00,0x42,0x7F,0x40,0x00,0x00}, //1
-    {0x62,0x51,0x49,0x49,0x46,0x00}, //2
-    {0x22,0x49,0x49,0x49,0x36,0x00}, //3
-    {0x18,0x14,0x12,0x7F,0x10,0x00}, //4
-    {0x2F,0x49,0x49,0x49,0x31,0x00}, //5
-    {0x3E,0x49,0x49,0x49,0x32,0x00}, //6
-    {0x01,0x71,0x09,0x05,0x03,0x00}, //7
-    {0x36,0x49,0x49,0x49,0x36,0x00}, //8
-    {0x26,0x49,0x49,0x49,0x3E,0x00}, //9
-    {0x00,0x36,0x36,0x00,0x00,0x00}, //:
-};
-
-// 추가 글리프(6x8): ' ' 'T' 'H' 'C' '%'
-static const u8 glyph_space[6]   = { 0x00,0x00,0x00,0x00,0x00,0x00 };
-static const u8 glyph_T[6]       = { 0x01,0x01,0x7F,0x01,0x01,0x00 };
-static const u8 glyph_H[6]       = { 0x7F,0x08,0x08,0x08,0x7F,0x00 };
-static const u8 glyph_C[6]       = { 0x3E,0x41,0x41,0x41,0x22,0x00 };
-static const u8 glyph_percent[6] = { 0x13,0x2B,0x04,0x32,0x31,0x00 };
-static const u8 glyph_S[6] = { 0x26,0x49,0x49,0x49,0x32,0x00 }; // 'S'
-static const u8 glyph_E[6] = { 0x7F,0x49,0x49,0x49,0x41,0x00 }; // 'E'
-// 너가 이미 추가해둔 '-' 글리프
-static const u8 glyph_dash[6]    = { 0x08,0x08,0x08,0x08,0x08,0x00 };
+// -------------------- 6x8 font: printable ASCII (0x20~0x7E) --------------------
+// font6x8.bdf -> gen_font6x8.py -> font6x8.h (빌드 때 생성, 문자 코드로 바로 인덱싱)
+#include "font6x8.h"
 
 // -------------------- DS1302 helpers --------------------
 
 static inline u8 bcd2bin_u8(u8 bcd) { return ((bcd >> 4) * 10) + (bcd & 0x0F); }
 static inline u8 bin2bcd_u8(u8 v)   { return ((v / 10) << 4) | (v % 10); }
 
-static inline void ds_ce(int v)  { gpio_set_value(ds_ce_gpio, v); }
-static inline void ds_clk(int v) { gpio_set_value(ds_clk_gpio, v); }
+/*
+ * 비트뱅 엔진 (gpiod).
+ * - 쓰기는 비트마다 CLK↓+DAT를 gpiod_set_array_value() 한 번으로 바꾸고 CLK↑ 한 번.
+ *   (컨트롤러가 set_multiple을 지원하면 레지스터 쓰기 한 번)
+ * - DAT 방향은 전송 단계가 바뀔 때만 바꾼다 (start에서 출력, 첫 read에서 입력).
+ * - 지연은 데이터시트 AC 특성(ns)대로.
+ */
+static inline void ds_ce(struct ds_oled *d, int v)  { gpiod_set_value(d->ds_ce_d, v); }
+static inline void ds_clk(struct ds_oled *d, int v) { gpiod_set_value(d->ds_clk_d, v); }
+
+/* CLK와 DAT를 한 번에 */
+static inline void ds_clk_dat(struct ds_oled *d, int clk, int dat)
+{
+    unsigned long v = (clk ? BIT(0) : 0) | (dat ? BIT(1) : 0);
+
+    gpiod_set_array_value(2, d->ds_bus_d, NULL, &v);
+}
+
+static inline void ds_dat_out(struct ds_oled *d)
+{
+    if (!d->ds_dat_is_out) {
+        gpiod_direction_output(d->ds_dat_d, 0);
+        d->ds_dat_is_out = true;
+    }
+}
+
+static inline void ds_dat_in(struct ds_oled *d)
+{
+    if (d->ds_dat_is_out) {
+        gpiod_direction_input(d->ds_dat_d);
+        d->ds_dat_is_out = false;
+    }
+}
 
-static inline void ds_dat_out(int v) { gpio_direction_output(ds_dat_gpio, v); }
-static inline void ds_dat_in(void)   { gpio_direction_input(ds_dat_gpio); }
-static inline int  ds_dat_read(void) { return gpio_get_value(ds_dat_gpio); }
+static inline int ds_dat_read(struct ds_oled *d) { return gpiod_get_value(d->ds_dat_d); }
 
-static void ds1302_start(void)
+static void ds1302_start(struct ds_oled *d)
 {
-    ds_clk(0);
-    ds_ce(1);
-    udelay(4);
+    ds_dat_out(d);
+    ds_clk(d, 0);       // CE↑ 할 때 CLK는 0이어야 함
+    ds_ce(d, 1);
+    ndelay(d->ds_t->tcc);
 }
 
-static void ds1302_stop(void)
+static void ds1302_stop(struct ds_oled *d)
 {
-    ds_ce(0);
-    udelay(4);
+    ds_clk(d, 0);
+    ds_ce(d, 0);
+    ndelay(d->ds_t->tcwh);
 }
 
-static void ds1302_write_byte(u8 val)
+/* LSB부터. 끝나면 CLK=1 (마지막 CLK↓에서 칩이 첫 읽기 비트를 내보냄) */
+static void ds1302_write_byte(struct ds_oled *d, u8 val)
 {
     int i;
+
+    ds_dat_out(d);
     for (i = 0; i < 8; i++) {
-        ds_dat_out(val & 0x01);
-        udelay(1);
-        ds_clk(1);
-        udelay(1);
-        ds_clk(0);
-        udelay(1);
+        ds_clk_dat(d, 0, val & 0x01);
+        ndelay(d->ds_t->tcl);
+        ds_clk(d, 1);   // 칩은 상승 에지에서 샘플
+        ndelay(d->ds_t->tch);
         val >>= 1;
     }
 }
 
-static u8 ds1302_read_byte(void)
+static u8 ds1302_read_byte(struct ds_oled *d)
 {
+    unsigned int tlow = max(d->ds_t->tcl, d->ds_t->tcdd);
     int i;
     u8 val = 0;
 
-    ds_dat_in();
+    ds_dat_in(d);       // 칩이 드라이브하기 전에(CLK↓ 전에) 놓는다
     for (i = 0; i < 8; i++) {
-        ds_clk(1);
-        udelay(1);
-        if (ds_dat_read())
+        ds_clk(d, 0);   // 칩은 하강 에지에서 다음 비트 출력
+        ndelay(tlow);
+        if (ds_dat_read(d))
             val |= (1 << i);
-        ds_clk(0);
-        udelay(1);
+        ds_clk(d, 1);
+        ndelay(d->ds_t->tch);
     }
     return val;
 }
 
-static void ds1302_write_reg(u8 addr_write, u8 data)
+/* board info(번호)면 gpio_request, 아니면 DT의 <con_id>-gpios */
+static struct gpio_desc *ds1302_get_gpio(struct ds_oled *d, int num, const char *con_id,
+                                         const char *label)
+{
+    int ret;
+
+    if (num < 0)
+        return devm_gpiod_get(d->dev, con_id, GPIOD_OUT_LOW);
+
+    ret = devm_gpio_request_one(d->dev, num, GPIOF_OUT_INIT_LOW, label);
+    if (ret)
+        return ERR_PTR(ret);
+    return gpio_to_desc(num);
+}
+
+static int ds1302_gpio_setup(struct ds_oled *d, const struct ds_oled_pdata *pdata)
+{
+    u32 vcc_mv = ds_vcc_mv;
+
+    d->ds_ce_d  = ds1302_get_gpio(d, pdata ? pdata->ce_gpio : -1, "ce", "ds1302_ce");
+    if (IS_ERR(d->ds_ce_d))
+        return PTR_ERR(d->ds_ce_d);
+    d->ds_clk_d = ds1302_get_gpio(d, pdata ? pdata->clk_gpio : -1, "clk", "ds1302_clk");
+    if (IS_ERR(d->ds_clk_d))
+        return PTR_ERR(d->ds_clk_d);
+    d->ds_dat_d = ds1302_get_gpio(d, pdata ? pdata->dat_gpio : -1, "dat", "ds1302_dat");
+    if (IS_ERR(d->ds_dat_d))
+        return PTR_ERR(d->ds_dat_d);
+    d->ds_bus_d[0] = d->ds_clk_d;
+    d->ds_bus_d[1] = d->ds_dat_d;
+    d->ds_dat_is_out = true;
+
+    device_property_read_u32(d->dev, "vcc-mv", &vcc_mv);
+    d->ds_t = vcc_mv >= 4500 ? &ds_timing_5v : &ds_timing_2v;
+    return 0;
+}
+
+static void ds1302_write_reg(struct ds_oled *d, u8 addr_write, u8 data)
 {
-    ds1302_start();
-    ds1302_write_byte(addr_write); // write address (LSB=0)
-    ds1302_write_byte(data);
-    ds1302_stop();
+    ds1302_start(d);
+    ds1302_write_byte(d, addr_write); // write address (LSB=0)
+    ds1302_write_byte(d, data);
+    ds1302_stop(d);
 }
 
-static int ds1302_read_time(struct ds_time *t)
+static int ds1302_read_time(struct ds_oled *d, struct ds_time *t)
 {
     u8 raw[8];
+    ktime_t t0;
     int i;
 
-    ds1302_start();
-    ds1302_write_byte(0xBF); // Clock Burst Read
+    t0 = ktime_get();
+    ds1302_start(d);
+    ds1302_write_byte(d, 0xBF); // Clock Burst Read
     for (i = 0; i < 8; i++)
-        raw[i] = ds1302_read_byte();
-    ds1302_stop();
+        raw[i] = ds1302_read_byte(d);
+    ds1302_stop(d);
+    d->ds_byte_ns = ktime_to_ns(ktime_sub(ktime_get(), t0)) / 9; // 명령 1 + 데이터 8
+    trace_ds1302_burst(d->dev, 0xBF, 8, (u64)d->ds_byte_ns * 9);
 
     t->sec  = bcd2bin_u8(raw[0] & 0x7F);
     t->min  = bcd2bin_u8(raw[1] & 0x7F);
@@ -398,356 +782,2079 @@ static int ds1302_read_time(struct ds_time *t)
 
     if (t->sec > 59 || t->min > 59 || t->hour > 23)
         return -EINVAL;
+    if (t->mon < 1 || t->mon > 12 || t->mday < 1 || t->mday > 31)
+        return -EINVAL;
     return 0;
 }
 
-static int ds1302_set_datetime(const struct ds_time *t)
-{
-    // WP off
-    ds1302_write_reg(0x8E, 0x00);
+// -------------------- DS1302 time cache (read once, extrapolate) --------------------
+/*
+ * RTC는 resync_sec마다(또는 쓰기 직후) 한 번만 burst read 하고, 그 값을
+ * 커널 boottime(suspend 시간 포함, 단조 증가)에 묶어 둔 뒤 경과 시간만큼 더해서 돌려준다.
+ *
+ * 처음(그리고 쓰기 후)에는 align_work가 DS1302 초 레지스터가 바뀌는 순간을 찾아서
+ * 앵커를 초 경계에 맞춘다. 그 뒤로는 외삽한 초가 RTC와 같은 순간에 넘어가고,
+ * sec_timer(hrtimer)가 매 경계 직후에 tick을 깨운다.
+ * 경계에 맞추기 전에는 앵커를 잡은 순간의 초 안 위치만큼(1초 미만) 늦을 수 있다.
+ */
 
-    // CH(bit7)=0
-    ds1302_write_reg(0x80, bin2bcd_u8(t->sec)  & 0x7F);
-    ds1302_write_reg(0x82, bin2bcd_u8(t->min)  & 0x7F);
-    ds1302_write_reg(0x84, bin2bcd_u8(t->hour) & 0x3F);
-    ds1302_write_reg(0x86, bin2bcd_u8(t->mday) & 0x3F);
-    ds1302_write_reg(0x88, bin2bcd_u8(t->mon)  & 0x1F);
-    ds1302_write_reg(0x8A, bin2bcd_u8(t->wday) & 0x07);
-    ds1302_write_reg(0x8C, bin2bcd_u8(t->year));
+// 초 경계 맞추기: 50ms 간격으로 경계 구간을 찾고, 그 구간을 다음 초들에서 이분 탐색해 1ms까지 좁힌다
+#define DS_EDGE_COARSE_US 50000
+#define DS_EDGE_FINE_US   1000
+#define DS_EDGE_MAX_PROBES 16                   // 이분 탐색 읽기 상한 (보통 6~7번)
+#define DS_EDGE_SLACK_NS  (2 * NSEC_PER_MSEC)   // 경계 뒤 이만큼 지나서 깨어남
 
-    // WP on (선택)
-    ds1302_write_reg(0x8E, 0x80);
+/*
+ * RTC 알람(과 RTC core가 알람으로 구현하는 UIE) 에뮬레이션.
+ * DS1302에는 알람/인터럽트가 없으므로 알람 시각을 앵커 기준 boottime으로 바꿔 hrtimer를 건다.
+ * 앵커가 바뀌면(재동기화, 경계 정렬) ds_alarm_arm()으로 다시 건다. ds_lock으로 보호.
+ */
+static enum hrtimer_restart alarm_timer_fn(struct hrtimer *timer)
+{
+    struct ds_oled *d = container_of(timer, struct ds_oled, alarm_timer);
 
-    return 0;
+    if (d->ds_rtc)
+        rtc_update_irq(d->ds_rtc, 1, RTC_AF | RTC_IRQF);
+    return HRTIMER_NORESTART;
 }
 
-// -------------------- parse YYYYMMDDhhmmss --------------------
-static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+/* ds_lock 잡고 호출 */
+static void ds_alarm_arm(struct ds_oled *d)
+{
+    ktime_t at;
 
-static int parse_2d(const char *s, u8 *out)
+    if (!d->ds_alarm_enabled || !d->ds_anchor_ok || READ_ONCE(d->ui_stopping)) {
+        hrtimer_try_to_cancel(&d->alarm_timer);
+        return;
+    }
+    at = ktime_add_ns(d->ds_anchor_kt, (d->ds_alarm_secs - d->ds_anchor_secs) * NSEC_PER_SEC);
+    hrtimer_start(&d->alarm_timer, at, HRTIMER_MODE_ABS);
+}
+
+static time64_t ds_time_to_secs(const struct ds_time *t)
 {
-    if (!is_digit(s[0]) || !is_digit(s[1])) return -EINVAL;
-    *out = (s[0]-'0')*10 + (s[1]-'0');
-    return 0;
+    return mktime64(2000 + t->year, t->mon, t->mday, t->hour, t->min, t->sec);
 }
 
-static int parse_4d_year(const char *s, int *year)
+static void ds_secs_to_time(time64_t secs, struct ds_time *t)
 {
-    int i, y = 0;
-    for (i = 0; i < 4; i++) {
-        if (!is_digit(s[i])) return -EINVAL;
-        y = y*10 + (s[i]-'0');
-    }
-    *year = y;
-    return 0;
+    struct tm tm;
+
+    time64_to_tm(secs, 0, &tm);
+    t->sec  = tm.tm_sec;
+    t->min  = tm.tm_min;
+    t->hour = tm.tm_hour;
+    t->mday = tm.tm_mday;
+    t->mon  = tm.tm_mon + 1;
+    t->year = (u8)clamp_int(tm.tm_year + 1900 - 2000, 0, 99);
 }
 
-static int parse_datetime_14(const char *s14, struct ds_time *t)
+/* 앵커에서 at 시점의 시간을 외삽 */
+static void ds_extrapolate(struct ds_oled *d, ktime_t at, struct ds_time *t, time64_t *secs_out)
 {
-    int ret, year4;
-    u8 mon, mday, hour, min, sec;
+    time64_t secs;
+    s64 days;
 
-    ret = parse_4d_year(s14 + 0, &year4); if (ret) return ret;
-    ret = parse_2d(s14 + 4, &mon);        if (ret) return ret;
-    ret = parse_2d(s14 + 6, &mday);       if (ret) return ret;
-    ret = parse_2d(s14 + 8, &hour);       if (ret) return ret;
-    ret = parse_2d(s14 +10, &min);        if (ret) return ret;
-    ret = parse_2d(s14 +12, &sec);        if (ret) return ret;
+    secs = d->ds_anchor_secs +
+           div_s64(ktime_to_ns(ktime_sub(at, d->ds_anchor_kt)), NSEC_PER_SEC);
+    ds_secs_to_time(secs, t);
 
-    if (year4 < 2000 || year4 > 2099) return -ERANGE;
-    if (mon < 1 || mon > 12) return -ERANGE;
-    if (mday < 1 || mday > 31) return -ERANGE;
-    if (hour > 23 || min > 59 || sec > 59) return -ERANGE;
+    // 요일은 RTC에 들어 있던 값(1..7)에서 지난 날수만큼 돌린다
+    days = div_s64(secs, 86400) - div_s64(d->ds_anchor_secs, 86400);
+    if (d->ds_anchor.wday >= 1 && d->ds_anchor.wday <= 7)
+        t->wday = (d->ds_anchor.wday - 1 + days) % 7 + 1;
+    else
+        t->wday = d->ds_anchor.wday;
 
-    t->year = (u8)(year4 - 2000);
-    t->mon  = mon;
-    t->mday = mday;
-    t->hour = hour;
-    t->min  = min;
-    t->sec  = sec;
-    t->wday = 1; // 요일 입력 없으면 임시(필요하면 나중에 계산해서 넣기)
-    return 0;
+    if (secs_out)
+        *secs_out = secs;
 }
 
-// -------------------- I2C SSD1306 helpers --------------------
-static int oled_i2c_create_client(void)
+/*
+ * ds_lock 잡고 호출: 앵커 위상이 바뀜 -> sec_timer는 옛 경계에 맞춰져 있으므로 멈추고
+ * rtc_work가 다시 1초마다 돌게 한다. 다음 앵커에서 ds_align_fn이 새로 맞춘다.
+ */
+static void ds_sec_timer_stop(struct ds_oled *d)
 {
-    struct i2c_board_info info = { I2C_BOARD_INFO("ssd1306", 0) };
-    info.addr = i2c_addr;
-
-    oled_adap = i2c_get_adapter(i2c_bus);
-    if (!oled_adap)
-        return -ENODEV;
-
-    oled_i2c = i2c_new_client_device(oled_adap, &info); //8번 버스 객체에 0x3c 장치(client)를 만들었다.
-    if (IS_ERR(oled_i2c)) {
-        int ret = PTR_ERR(oled_i2c);
-        oled_i2c = NULL;
-        i2c_put_adapter(oled_adap);
-        oled_adap = NULL;
-        return ret;
-    }
-    return 0;
+    if (!READ_ONCE(d->sec_timer_on))
+        return;
+    WRITE_ONCE(d->sec_timer_on, false);
+    hrtimer_cancel(&d->sec_timer);   // 콜백은 ds_lock을 안 잡음
+    if (!READ_ONCE(d->ui_stopping))
+        mod_delayed_work(d->sense_wq, &d->rtc_work, 0);
 }
 
-static void oled_i2c_destroy_client(void)
+/* ds_lock 잡고 호출: 다음 get에서 실제로 읽게 한다 */
+static void ds_anchor_drop(struct ds_oled *d)
 {
-    if (oled_i2c) {
-        i2c_unregister_device(oled_i2c);
-        oled_i2c = NULL;
-    }
-    if (oled_adap) {
-        i2c_put_adapter(oled_adap);
-        oled_adap = NULL;
-    }
+    d->ds_anchor_ok = false;
+    ds_sec_timer_stop(d);
 }
 
-// control byte: cmd=0x00, data=0x40
-static int oled_i2c_write(bool is_data, const u8 *buf, size_t len)
+/* ds_lock 잡고 호출. RTC가 아니라 앵커에서 외삽한 현재 시간 */
+static int ds1302_get_time(struct ds_oled *d, struct ds_time *t)
 {
-    u8 tmp[1 + 16];
-    size_t off = 0;
+    ktime_t now = ktime_get_boottime();
+    struct ds_time rt;
+    time64_t predicted;
     int ret;
 
-    if (!oled_i2c)
-        return -ENODEV;
-
-    tmp[0] = is_data ? 0x40 : 0x00;// command면 0x00 data면 0x01
+    if (d->ds_anchor_ok &&
+        ktime_ms_delta(now, d->ds_sync_kt) < (s64)resync_sec * MSEC_PER_SEC) {
+        ds_extrapolate(d, now, t, NULL);
+        return 0;
+    }
 
-    while (off < len) {
-        size_t n = min((size_t)16, len - off);
-        memcpy(&tmp[1], &buf[off], n);//tmp[1]에 buf[off]를 n바이트 만큼 복사
-        ret = i2c_master_send(oled_i2c, tmp, 1 + n); //oled_12c에 tmp의 주소값을 통해 
-        // 1+n만큼의 바이트를 보냄?.client로
-        if (ret < 0) return ret;
-        if (ret != 1 + n) return -EIO;
-        off += n;
+    d->ds_rtc_reads++;
+    ret = ds1302_read_time(d, &rt);
+    if (ret) {
+        ds_anchor_drop(d);
+        return ret;
+    }
+    now = ktime_get_boottime();
+    d->ds_sync_kt = now;
+
+    // 경계에 맞춰진 앵커가 읽은 값과 그대로 맞으면 위상은 유지
+    if (d->ds_anchor_ok && d->ds_anchor_aligned) {
+        ds_extrapolate(d, now, t, &predicted);
+        if (predicted == ds_time_to_secs(&rt))
+            return 0;
     }
+
+    d->ds_anchor = rt;
+    d->ds_anchor_secs = ds_time_to_secs(&rt);
+    d->ds_anchor_kt = now;
+    d->ds_anchor_ok = true;
+    d->ds_anchor_aligned = false;
+    ds_sec_timer_stop(d);   // 재동기화로 앵커가 옮겨짐 -> 새 앵커로 다시 정렬
+    ds_alarm_arm(d);
+    if (!READ_ONCE(d->ui_stopping))
+        queue_work(system_long_wq, &d->align_work);
+
+    *t = rt;
     return 0;
 }
 
-static inline int oled_cmd(u8 c) { return oled_i2c_write(false, &c, 1); }
-static inline int oled_data(const u8 *p, size_t n) { return oled_i2c_write(true, p, n); }
-
-static void fb_clear(void) { memset(fb, 0x00, sizeof(fb)); }
-
-static void fb_draw_char6x8(int x, int page, char c)
-{
-    const u8 *g = NULL;
-    int i, idx;
-
-    if (c >= '0' && c <= '9') {
-        idx = c - '0';
-        g = font6x8[idx];
-    } else if (c == ':') {
-        g = font6x8[10];
-    } else if (c == '-') {
-        g = glyph_dash;
-    } else if (c == ' ') {
-        g = glyph_space;
-    } else if (c == 'T') {
-        g = glyph_T;
-     } else if (c == 'S') {
-    g = glyph_S;
-    } else if (c == 'E') {
-    g = glyph_E;   
-    } else if (c == 'H') {
-        g = glyph_H;
-    } else if (c == 'C') {
-        g = glyph_C;
-    } else if (c == '%') {
-        g = glyph_percent;
-    } else {
-        return;
-    }
-
-    if (page < 0 || page >= 8) return;
-    if (x < 0 || x + 6 > OLED_W) return;
+/* 초 레지스터 하나만 읽기 (2바이트 트랜잭션) */
+static u8 ds1302_read_sec(struct ds_oled *d)
+{
+    u8 v;
 
-    for (i = 0; i < 6; i++)
-        fb[page * OLED_W + x + i] = g[i];
+    ds1302_start(d);
+    ds1302_write_byte(d, 0x81);
+    v = ds1302_read_byte(d);
+    ds1302_stop(d);
+    return bcd2bin_u8(v & 0x7F);
 }
 
-
-static void fb_draw_str6x8(int x, int page, const char *s)
+/*
+ * 초 레지스터가 from에서 바뀔 때까지 step_us 간격으로 읽는다.
+ * 경계는 (*lo, *hi] 안에 있다. 바뀐 값 또는 -ETIMEDOUT.
+ */
+static int ds_wait_sec_change(struct ds_oled *d, u8 from, unsigned int step_us, int max_polls,
+                              ktime_t *lo, ktime_t *hi)
 {
-    while (*s) {
-        fb_draw_char6x8(x, page, *s++);
-        x += 6;
-        if (x >= OLED_W) break;
+    int i;
+    u8 v;
+
+    for (i = 0; i < max_polls; i++) {
+        usleep_range(step_us, step_us + step_us / 4);
+
+        mutex_lock(&d->ds_lock);
+        *hi = ktime_get_boottime();
+        v = ds1302_read_sec(d);
+        mutex_unlock(&d->ds_lock);
+
+        if (v != from)
+            return v;
+        *lo = *hi;
     }
+    return -ETIMEDOUT;
 }
 
-static int oled_init(void)
+/* /dev/ds1302_oled 읽기 대기자 깨우기: 초 경계마다, 시간 쓰기마다 (hrtimer에서도 불림) */
+static void ds_poll_signal(struct ds_oled *d)
 {
-    // RST 핀 없음 -> reset pulse 없음
-
-    // SSD1306 init (128x64, charge pump on)
-    oled_cmd(0xAE);                // display off
-    oled_cmd(0xD5); oled_cmd(0x80);
-    oled_cmd(0xA8); oled_cmd(0x3F);
-    oled_cmd(0xD3); oled_cmd(0x00);
-    oled_cmd(0x40);
-    oled_cmd(0x8D); oled_cmd(0x14); // charge pump on
-    oled_cmd(0x20); oled_cmd(0x00); // horizontal addressing
-    oled_cmd(0xA1);
-    oled_cmd(0xC8);
-    oled_cmd(0xDA); oled_cmd(0x12);
-    oled_cmd(0x81); oled_cmd(0xCF);
-    oled_cmd(0xD9); oled_cmd(0xF1);
-    oled_cmd(0xDB); oled_cmd(0x40);
-    oled_cmd(0xA4);
-    oled_cmd(0xA6);
-    oled_cmd(0xAF);                // display on
-    return 0;
+    atomic_inc(&d->poll_seq);
+    wake_up_interruptible(&d->poll_wq);
 }
 
-static void oled_flush(void)
+static enum hrtimer_restart sec_timer_fn(struct hrtimer *timer)
 {
-    int page;
-    for (page = 0; page < 8; page++) {
-        oled_cmd(0xB0 | page);
-        oled_cmd(0x00);
-        oled_cmd(0x10);
-        oled_data(&fb[page * OLED_W], OLED_W);
-    }
-}
+    struct ds_oled *d = container_of(timer, struct ds_oled, sec_timer);
 
-// -------------------- tick work (1s) --------------------
-static void tick_fn(struct work_struct *work)
-{   
-    int ev;
-    int guard = 8;
+    if (READ_ONCE(d->ui_stopping))
+        return HRTIMER_NORESTART;
 
-    char buf_th[16];      // "T25C H60%"
-    char buf_dt[24];      // "2025-12-17"
-    char buf_tm[16];      // "17:40:00"
-    int year4;
+    mod_delayed_work(d->sense_wq, &d->rtc_work, 0);
+    ds_poll_signal(d);
 
-    /* =========================
-     * 1) 로터리 이벤트: 즉시 반영
-     * ========================= */
-  while (guard-- > 0 && (ev = rotary_get_event()) != ROT_EV_NONE) {
+    hrtimer_forward_now(timer, ns_to_ktime(NSEC_PER_SEC));
+    return HRTIMER_RESTART;
+}
 
-    if (ev == ROT_EV_BTN_DOWN) {
-            if (g_mode == UI_NORMAL) {
-                enter_set_mode();
-            } else { // UI_SET
-                if (g_field == FLD_SEC) {          
-                    save_and_exit_set_mode();
-                } else {
-                    field_next();
-                }
-            }
-            continue;
-        }
+/* DS1302 초 경계를 찾아 앵커를 거기에 맞추고 sec_timer를 건다 */
+static void ds_align_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(work, struct ds_oled, align_work);
+    struct ds_time t0;
+    ktime_t lo, hi, mid, last, wake;
+    unsigned int gen, k;
+    int s1, cur, v, i, ret;
+    s64 us;
+
+    mutex_lock(&d->ds_lock);
+    gen = d->ds_write_gen;
+    d->ds_rtc_reads++;
+    ret = ds1302_read_time(d, &t0);
+    lo = ktime_get_boottime();
+    mutex_unlock(&d->ds_lock);
+    if (ret)
+        return;
 
-        /* 회전은 SET 모드에서만 편집 */
-        if (g_mode == UI_SET) {
-            if (ev == ROT_EV_CW)  edit_add(&g_edit, +1);
-            if (ev == ROT_EV_CCW) edit_add(&g_edit, -1);
-        }
+    // 1) 50ms 간격: 경계는 (lo, hi]
+    s1 = ds_wait_sec_change(d, t0.sec, DS_EDGE_COARSE_US,
+                            2 * USEC_PER_SEC / DS_EDGE_COARSE_US, &lo, &hi);
+    if (s1 < 0) {
+        dev_warn(d->dev, "ds1302: seconds not ticking, cannot align (CH set?)\n");
+        return;
     }
 
-    /* =========================
-     * 2) 센서/RTC 캐시: 1초마다만
-     * ========================= */
-   if (jiffies - last_sense_j >= msecs_to_jiffies(SENSE_TICK_MS)) {
-    last_sense_j = jiffies;
-        int ret;
-        pr_info("DHT: try read (j=%lu)\n", jiffies);
-
-        ret = dht11_read_values(&temp_cache, &humi_cache);
-        if (ret) {
-            pr_info("DHT: read FAIL ret=%d\n", ret);
-            temp_cache = -1;
-            humi_cache = -1;
-        } else {
-            pr_info("DHT: read OK t=%d h=%d\n", temp_cache, humi_cache);
+    /*
+     * 2) 이분 탐색. 구간 가운데에서 한 번만 읽는다:
+     *    아직 안 바뀌었으면 경계는 뒤쪽 절반, 바뀌었으면 앞쪽 절반인데 그 초는 이미 지났으니
+     *    구간을 1초 뒤로 옮겨 다음 경계에서 계속한다.
+     *    읽기 한 번에 구간이 절반 -> 50ms에서 1ms까지 6~7번 (1ms 폴링이면 수십 번). 대신 몇 초 걸린다.
+     */
+    cur = s1;
+    k = 1;      // cur == t0.sec + k, (lo, hi]는 다음 경계 (t0.sec + k + 1이 되는 순간)
+    lo = ktime_add_ns(lo, NSEC_PER_SEC);
+    hi = ktime_add_ns(hi, NSEC_PER_SEC);
+    last = hi;
+    for (i = 0; ktime_us_delta(hi, lo) > DS_EDGE_FINE_US; i++) {
+        if (READ_ONCE(d->ui_stopping))
+            return;
+        if (i == DS_EDGE_MAX_PROBES)
+            goto lost;
+
+        mid = ktime_add_ns(lo, ktime_to_ns(ktime_sub(hi, lo)) / 2);
+        us = ktime_us_delta(mid, ktime_get_boottime());
+        if (us > 0)
+            usleep_range(us, us + 50);
+
+        mutex_lock(&d->ds_lock);
+        last = ktime_get_boottime();
+        v = ds1302_read_sec(d);
+        mutex_unlock(&d->ds_lock);
+
+        if (v == cur) {
+            if (!ktime_before(last, hi))
+                goto lost;      // 구간 끝을 넘겼는데 안 바뀜 -> 잘못 잡은 구간
+            lo = last;
+            continue;
         }
-
-    if (g_mode == UI_NORMAL) {
-        mutex_lock(&ds_lock);
-        cache_ok = (ds1302_read_time(&t_cache) == 0);
-        mutex_unlock(&ds_lock);
+        if (v != (cur + 1) % 60)
+            goto lost;          // 너무 늦게 깨어나 경계를 둘 이상 지남
+        if (ktime_before(last, hi))
+            hi = last;
+        cur = v;
+        k++;
+        lo = ktime_add_ns(lo, NSEC_PER_SEC);
+        hi = ktime_add_ns(hi, NSEC_PER_SEC);
     }
-}
 
-    /* =========================
-     * 3) 커서 깜빡임: 1초 토글(SET에서만)
-     * ========================= */
-    if (g_mode == UI_SET) {
-        if (time_after(jiffies, last_blink_j + msecs_to_jiffies(BLINK_MS))) {
-            last_blink_j = jiffies;
-            g_blink_on = !g_blink_on;
-        }
-    } else {
-        g_blink_on = true; // NORMAL에선 마스크 안 쓰게 항상 ON 처리
+    mutex_lock(&d->ds_lock);
+    if (gen != d->ds_write_gen) {
+        // 정렬 도중 시간이 바뀜 -> 다음 get에서 다시 시작
+        mutex_unlock(&d->ds_lock);
+        return;
     }
+    // hi가 t0 + k + 1초가 되는 순간
+    d->ds_anchor = t0;
+    d->ds_anchor_secs = ds_time_to_secs(&t0);
+    d->ds_anchor_kt = ktime_sub_ns(hi, (u64)(k + 1) * NSEC_PER_SEC);
+    d->ds_sync_kt = last;
+    d->ds_anchor_ok = true;
+    d->ds_anchor_aligned = true;
+    ds_alarm_arm(d);
+    // ds_lock 안에서: 풀자마자 앵커가 버려지면 ds_sec_timer_stop이 이 타이머를 멈춰야 함
+    if (!READ_ONCE(d->ui_stopping)) {
+        // hi는 아직 안 온 경계일 수도, 방금 지난 경계일 수도 있다
+        wake = ktime_add_ns(hi, DS_EDGE_SLACK_NS);
+        while (!ktime_after(wake, ktime_get_boottime()))
+            wake = ktime_add_ns(wake, NSEC_PER_SEC);
+        hrtimer_start(&d->sec_timer, wake, HRTIMER_MODE_ABS);
+        WRITE_ONCE(d->sec_timer_on, true);
+    }
+    mutex_unlock(&d->ds_lock);
 
-    /* =========================
-     * 4) 화면에 출력할 문자열 만들기
-     * ========================= */
+    if (READ_ONCE(d->ui_stopping))
+        return;
 
-    /* (A) 온습도: 캐시값만 사용 -> 안 깜빡임 */
-    if (temp_cache >= 0 && humi_cache >= 0)
-        snprintf(buf_th, sizeof(buf_th), "T%02dC H%02d%%", temp_cache, humi_cache);
-    else
-        snprintf(buf_th, sizeof(buf_th), "T--C H--%%");
+    dev_info(d->dev, "ds1302: aligned to second edge (+-%lld us, %d reads)\n",
+             ktime_us_delta(hi, lo), i);
 
-    /* (B) 날짜/시간: SET이면 g_edit, NORMAL이면 t_cache */
-    if (g_mode == UI_SET) {
-        year4 = 2000 + g_edit.year;
-        snprintf(buf_dt, sizeof(buf_dt), "%04d-%02u-%02u", year4, g_edit.mon, g_edit.mday);
-        snprintf(buf_tm, sizeof(buf_tm), "%02u:%02u:%02u", g_edit.hour, g_edit.min, g_edit.sec);
+    // 정렬된 앵커로 바로 한 번 갱신
+    mod_delayed_work(d->sense_wq, &d->rtc_work, 0);
+    return;
 
-        /* blink는 표시만 가리기(값 변경과 무관) */
-        apply_blink_mask(buf_dt, buf_tm, g_blink_on);
+lost:
+    dev_warn(d->dev, "ds1302: lost the second edge while aligning\n");
+}
 
-    } else {
-        if (cache_ok) {
-            year4 = 2000 + t_cache.year;
-            snprintf(buf_dt, sizeof(buf_dt), "%04d-%02u-%02u", year4, t_cache.mon, t_cache.mday);
-            snprintf(buf_tm, sizeof(buf_tm), "%02u:%02u:%02u", t_cache.hour, t_cache.min, t_cache.sec);
-        } else {
-            snprintf(buf_dt, sizeof(buf_dt), "---- -- --");
-            snprintf(buf_tm, sizeof(buf_tm), "--:--:--");
-        }
-    }
+/* 시계 레지스터 순서 (write 주소 = 0x80 + 2*idx) */
+enum ds_reg {
+    DS_REG_SEC = 0,
+    DS_REG_MIN,
+    DS_REG_HOUR,
+    DS_REG_MDAY,
+    DS_REG_MON,
+    DS_REG_WDAY,
+    DS_REG_YEAR,
+    DS_REG_NUM
+};
 
-    /* =========================
-     * 5) OLED draw
-     * ========================= */
-    fb_clear();
-    if (g_mode == UI_SET)
-    fb_draw_str6x8(0, 0, "SET");
-    fb_draw_str6x8(74, 0, buf_th);
-    fb_draw_str6x8(0, 2, buf_dt);
-    fb_draw_str6x8(0, 4, buf_tm);
-    oled_flush();
+// 바뀐 레지스터가 이 개수 이하면 단일 쓰기, 넘으면 burst 한 번이 더 짧다
+// (단일: (n+2) CE x 2바이트, burst: WP off + 9바이트 = 2 CE x 11바이트)
+#define DS_SINGLE_MAX 2
 
-    /* =========================
-     * 6) 다음 UI tick: 50ms
-     * ========================= */
-    mod_delayed_work(system_wq, &tick_work, msecs_to_jiffies(UI_TICK_MS));
+static void ds1302_time_to_raw(const struct ds_time *t, u8 *raw)
+{
+    raw[DS_REG_SEC]  = bin2bcd_u8(t->sec)  & 0x7F;  // CH(bit7)=0
+    raw[DS_REG_MIN]  = bin2bcd_u8(t->min)  & 0x7F;
+    raw[DS_REG_HOUR] = bin2bcd_u8(t->hour) & 0x3F;  // 24h
+    raw[DS_REG_MDAY] = bin2bcd_u8(t->mday) & 0x3F;
+    raw[DS_REG_MON]  = bin2bcd_u8(t->mon)  & 0x1F;
+    raw[DS_REG_WDAY] = bin2bcd_u8(t->wday) & 0x07;
+    raw[DS_REG_YEAR] = bin2bcd_u8(t->year);
 }
 
+/* Clock Burst Write(0xBE): 7개 시계 레지스터 + control(WP)까지 8바이트를 한 CE 안에 */
+static int ds1302_set_datetime(struct ds_oled *d, const struct ds_time *t)
+{
+    u8 raw[DS_REG_NUM + 1];
+    u64 t0 = trace_ds1302_burst_enabled() ? ktime_get_ns() : 0;
+    int i;
 
-// -------------------- char device fops --------------------
-static int my_open(struct inode *inode, struct file *file) { return 0; }
-static int my_release(struct inode *inode, struct file *file) { return 0; }
+    ds1302_time_to_raw(t, raw);
+    raw[DS_REG_NUM] = 0x80;          // control: WP on
 
-static ssize_t my_read(struct file *file, char __user *ubuf, size_t count, loff_t *ppos)
-{
+    // WP off
+    ds1302_write_reg(d, 0x8E, 0x00);
+
+    ds1302_start(d);
+    ds1302_write_byte(d, 0xBE);
+    for (i = 0; i < DS_REG_NUM + 1; i++)
+        ds1302_write_byte(d, raw[i]);
+    ds1302_stop(d);
+    if (t0)
+        trace_ds1302_burst(d->dev, 0xBE, DS_REG_NUM + 1, ktime_get_ns() - t0);
+
+    ds_anchor_drop(d);   // 바로 다시 읽어서 앵커 재설정
+    d->ds_write_gen++;
+    ds_poll_signal(d);
+    return 0;
+}
+
+#define DS_DATE_MASK (BIT(DS_REG_YEAR) | BIT(DS_REG_MON) | BIT(DS_REG_MDAY))
+
+/* 날짜에서 요일 (1 = 일요일, RTC class와 같은 규칙) */
+static u8 ds_time_wday(const struct ds_time *t)
+{
+    struct tm tm;
+
+    time64_to_tm(ds_time_to_secs(t), 0, &tm);
+    return tm.tm_wday + 1;
+}
+
+/* ds_lock 잡고 호출. mask(BIT(DS_REG_x))에 있는 레지스터만 쓴다 */
+static int ds1302_set_regs(struct ds_oled *d, const struct ds_time *t, unsigned int mask)
+{
+    struct ds_time now;
+    u8 raw[DS_REG_NUM];
+    u64 t0;
+    int i, ret;
+
+    if (!mask)
+        return 0;
+    if (hweight32(mask) > DS_SINGLE_MAX) {
+        /*
+         * burst는 7개를 다 쓰므로 mask 밖의 필드는 지금 시간으로 채운다.
+         * t는 SET 모드에 들어갈 때 찍은 값일 수 있어서 그대로 쓰면 편집한 시간만큼 시계가 뒤로 감.
+         */
+        ret = ds1302_get_time(d, &now);
+        if (ret)
+            return ret;
+        for (i = 0; i < DS_REG_NUM; i++) {
+            if (!(mask & BIT(i)))
+                continue;
+            switch (i) {
+            case DS_REG_SEC:  now.sec  = t->sec;  break;
+            case DS_REG_MIN:  now.min  = t->min;  break;
+            case DS_REG_HOUR: now.hour = t->hour; break;
+            case DS_REG_MDAY: now.mday = t->mday; break;
+            case DS_REG_MON:  now.mon  = t->mon;  break;
+            case DS_REG_WDAY: now.wday = t->wday; break;
+            case DS_REG_YEAR: now.year = t->year; break;
+            }
+        }
+        if ((mask & DS_DATE_MASK) && !(mask & BIT(DS_REG_WDAY)))
+            now.wday = ds_time_wday(&now);   // 날짜가 바뀌면 요일도 따라감
+        return ds1302_set_datetime(d, &now);
+    }
+
+    t0 = trace_ds1302_write_regs_enabled() ? ktime_get_ns() : 0;
+    ds1302_time_to_raw(t, raw);
+
+    ds1302_write_reg(d, 0x8E, 0x00);    // WP off
+    for (i = 0; i < DS_REG_NUM; i++)
+        if (mask & BIT(i))
+            ds1302_write_reg(d, 0x80 + 2 * i, raw[i]);
+    ds1302_write_reg(d, 0x8E, 0x80);    // WP on
+    if (t0)
+        trace_ds1302_write_regs(d->dev, mask, ktime_get_ns() - t0);
+
+    ds_anchor_drop(d);
+    d->ds_write_gen++;
+    ds_poll_signal(d);
+    return 0;
+}
+
+static unsigned int ds_time_diff(const struct ds_time *a, const struct ds_time *b)
+{
+    unsigned int mask = 0;
+
+    if (a->sec  != b->sec)  mask |= BIT(DS_REG_SEC);
+    if (a->min  != b->min)  mask |= BIT(DS_REG_MIN);
+    if (a->hour != b->hour) mask |= BIT(DS_REG_HOUR);
+    if (a->mday != b->mday) mask |= BIT(DS_REG_MDAY);
+    if (a->mon  != b->mon)  mask |= BIT(DS_REG_MON);
+    if (a->wday != b->wday) mask |= BIT(DS_REG_WDAY);
+    if (a->year != b->year) mask |= BIT(DS_REG_YEAR);
+    return mask;
+}
+
+// -------------------- RTC class --------------------
+/*
+ * 시간 읽기는 /dev/ds1302_oled, UI와 같은 캐시(ds1302_get_time)를 쓰므로
+ * rtc-hctosys는 burst read 한 번(첫 앵커)으로 끝나고 그 뒤 hwclock 등은 버스를 안 건드린다.
+ */
+static int ds_rtc_read_time(struct device *dev, struct rtc_time *tm)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+    struct ds_time t;
+    int ret;
+
+    mutex_lock(&d->ds_lock);
+    ret = ds1302_get_time(d, &t);
+    mutex_unlock(&d->ds_lock);
+    if (ret)
+        return ret;
+
+    // 요일/연중일까지 일관되게 채우려고 초 단위에서 다시 푼다
+    rtc_time64_to_tm(ds_time_to_secs(&t), tm);
+    return 0;
+}
+
+static int ds_rtc_set_time(struct device *dev, struct rtc_time *tm)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+    struct ds_time t;
+    int ret;
+
+    t.sec  = tm->tm_sec;
+    t.min  = tm->tm_min;
+    t.hour = tm->tm_hour;
+    t.mday = tm->tm_mday;
+    t.mon  = tm->tm_mon + 1;
+    t.wday = tm->tm_wday + 1;          // DS1302: 1..7
+    t.year = tm->tm_year + 1900 - 2000; // range_min/max로 2000..2099 보장
+
+    mutex_lock(&d->ds_lock);
+    ret = ds1302_set_datetime(d, &t);
+    mutex_unlock(&d->ds_lock);
+    return ret;
+}
+
+static int ds_rtc_read_alarm(struct device *dev, struct rtc_wkalrm *alrm)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    mutex_lock(&d->ds_lock);
+    rtc_time64_to_tm(d->ds_alarm_secs, &alrm->time);
+    alrm->enabled = d->ds_alarm_enabled;
+    alrm->pending = 0;
+    mutex_unlock(&d->ds_lock);
+    return 0;
+}
+
+static int ds_rtc_set_alarm(struct device *dev, struct rtc_wkalrm *alrm)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+    struct ds_time t;
+    int ret;
+
+    mutex_lock(&d->ds_lock);
+    ret = ds1302_get_time(d, &t);  // 앵커가 유효해야 boottime으로 바꿀 수 있음
+    if (!ret) {
+        d->ds_alarm_secs = rtc_tm_to_time64(&alrm->time);
+        d->ds_alarm_enabled = alrm->enabled;
+        ds_alarm_arm(d);
+    }
+    mutex_unlock(&d->ds_lock);
+    return ret;
+}
+
+static int ds_rtc_alarm_irq_enable(struct device *dev, unsigned int enabled)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+    struct ds_time t;
+    int ret = 0;
+
+    mutex_lock(&d->ds_lock);
+    d->ds_alarm_enabled = enabled;
+    if (enabled)
+        ret = ds1302_get_time(d, &t);
+    ds_alarm_arm(d);
+    mutex_unlock(&d->ds_lock);
+    return ret;
+}
+
+static const struct rtc_class_ops ds_rtc_ops = {
+    .read_time        = ds_rtc_read_time,
+    .set_time         = ds_rtc_set_time,
+    .read_alarm       = ds_rtc_read_alarm,
+    .set_alarm        = ds_rtc_set_alarm,
+    .alarm_irq_enable = ds_rtc_alarm_irq_enable,
+};
+
+/*
+ * rtc 등록 바로 뒤에 거는 devm 액션이라 unbind 때 rtc가 내려가고 해제되기 전에 돈다.
+ * ds_stop은 그보다 먼저 걸려 있어서 더 늦게 돌므로 여기서 알람 타이머를 멈추고 ds_rtc를 끊는다.
+ */
+static void ds_rtc_unhook(void *data)
+{
+    struct ds_oled *d = data;
+
+    mutex_lock(&d->ds_lock);
+    d->ds_alarm_enabled = false;      // ds_alarm_arm이 다시 걸지 않게
+    hrtimer_cancel(&d->alarm_timer);  // 돌고 있는 alarm_timer_fn이 끝날 때까지
+    d->ds_rtc = NULL;
+    mutex_unlock(&d->ds_lock);
+}
+
+/* i2c client에 devm으로 묶는다 */
+static int ds_rtc_register(struct ds_oled *d)
+{
+    struct rtc_device *rtc;
+    int ret;
+
+    rtc = devm_rtc_allocate_device(d->dev);
+    if (IS_ERR(rtc))
+        return PTR_ERR(rtc);
+
+    rtc->ops = &ds_rtc_ops;
+    rtc->range_min = RTC_TIMESTAMP_BEGIN_2000;
+    rtc->range_max = RTC_TIMESTAMP_END_2099;
+    d->ds_rtc = rtc;   // 등록 중에 알람을 읽을 수 있으므로 먼저
+
+    ret = devm_rtc_register_device(rtc);
+    if (ret) {
+        d->ds_rtc = NULL;
+        return ret;
+    }
+    return devm_add_action_or_reset(d->dev, ds_rtc_unhook, d);
+}
+
+// -------------------- DS1302 RAM as nvmem --------------------
+/*
+ * 31바이트 RAM은 처음 읽을 때 RAM burst read(0xFF) 한 번으로 통째로 가져와 캐시한다.
+ * 쓰기는 캐시만 바꾸고 dirty 표시 -> nvram_writeback_ms 뒤에 RAM burst write(0xFE)로
+ * 0번부터 마지막 dirty 바이트까지 한 CE 안에 쓴다 (burst는 항상 0번부터 시작).
+ * 내릴 때 남은 dirty는 바로 쓴다. 캐시와 버스는 ds_lock으로 보호.
+ */
+
+/* ds_lock 잡고 호출 */
+static void ds1302_ram_load(struct ds_oled *d)
+{
+    u64 t0;
+    int i;
+
+    if (d->ds_ram_valid)
+        return;
+
+    t0 = trace_ds1302_burst_enabled() ? ktime_get_ns() : 0;
+    ds1302_start(d);
+    ds1302_write_byte(d, 0xFF); // RAM Burst Read
+    for (i = 0; i < DS_RAM_SIZE; i++)
+        d->ds_ram[i] = ds1302_read_byte(d);
+    ds1302_stop(d);
+    if (t0)
+        trace_ds1302_burst(d->dev, 0xFF, DS_RAM_SIZE, ktime_get_ns() - t0);
+    d->ds_ram_valid = true;
+}
+
+/* ds_lock 잡고 호출 */
+static void ds1302_ram_writeback(struct ds_oled *d)
+{
+    u64 t0;
+    int i, last;
+
+    if (!d->ds_ram_dirty)
+        return;
+    last = fls(d->ds_ram_dirty);   // 0..last-1 까지 쓰면 됨
+
+    ds1302_write_reg(d, 0x8E, 0x00);    // WP off
+    t0 = trace_ds1302_burst_enabled() ? ktime_get_ns() : 0;
+    ds1302_start(d);
+    ds1302_write_byte(d, 0xFE); // RAM Burst Write
+    for (i = 0; i < last; i++)
+        ds1302_write_byte(d, d->ds_ram[i]);
+    ds1302_stop(d);
+    if (t0)
+        trace_ds1302_burst(d->dev, 0xFE, last, ktime_get_ns() - t0);
+    ds1302_write_reg(d, 0x8E, 0x80);    // WP on
+
+    d->ds_ram_dirty = 0;
+}
+
+static void ram_flush_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(to_delayed_work(work), struct ds_oled, ram_flush_work);
+
+    mutex_lock(&d->ds_lock);
+    ds1302_ram_writeback(d);
+    mutex_unlock(&d->ds_lock);
+}
+
+static int ds_nvram_read(void *priv, unsigned int off, void *val, size_t bytes)
+{
+    struct ds_oled *d = priv;
+
+    mutex_lock(&d->ds_lock);
+    ds1302_ram_load(d);
+    memcpy(val, d->ds_ram + off, bytes);
+    mutex_unlock(&d->ds_lock);
+    return 0;
+}
+
+static int ds_nvram_write(void *priv, unsigned int off, void *val, size_t bytes)
+{
+    struct ds_oled *d = priv;
+    unsigned int delay = READ_ONCE(nvram_writeback_ms);
+
+    mutex_lock(&d->ds_lock);
+    // 부분 쓰기여도 나머지가 칩과 같아야 prefix burst로 덮어쓸 수 있음
+    ds1302_ram_load(d);
+    memcpy(d->ds_ram + off, val, bytes);
+    d->ds_ram_dirty |= GENMASK(off + bytes - 1, off);
+    if (!delay)
+        ds1302_ram_writeback(d);
+    mutex_unlock(&d->ds_lock);
+
+    if (delay)
+        mod_delayed_work(system_wq, &d->ram_flush_work, msecs_to_jiffies(delay));
+    return 0;
+}
+
+/* nvmem이 내려간 뒤에 불림: 더 이상 쓰기가 안 들어오므로 남은 dirty를 바로 내린다 */
+static void ds_nvram_flush(void *data)
+{
+    struct ds_oled *d = data;
+
+    cancel_delayed_work_sync(&d->ram_flush_work);
+    ram_flush_fn(&d->ram_flush_work.work);
+}
+
+static int ds_nvram_register(struct ds_oled *d)
+{
+    struct nvmem_config cfg = {
+        .name      = "ds1302_nvram",
+        .id        = d->id ? d->id : NVMEM_DEVID_NONE,  // 0번은 예전 이름 그대로
+        .dev       = d->dev,
+        .owner     = THIS_MODULE,
+        .type      = NVMEM_TYPE_BATTERY_BACKED,
+        .size      = DS_RAM_SIZE,
+        .word_size = 1,
+        .stride    = 1,
+        .priv      = d,
+        .reg_read  = ds_nvram_read,
+        .reg_write = ds_nvram_write,
+    };
+    struct nvmem_device *nvmem;
+    int ret;
+
+    // 순서: flush 액션을 먼저 걸어야 unbind 때 nvmem이 먼저 내려가고 그 뒤에 flush
+    ret = devm_add_action_or_reset(d->dev, ds_nvram_flush, d);
+    if (ret)
+        return ret;
+
+    nvmem = devm_nvmem_register(d->dev, &cfg);
+    return PTR_ERR_OR_ZERO(nvmem);
+}
+
+// -------------------- parse YYYYMMDDhhmmss --------------------
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+static int parse_2d(const char *s, u8 *out)
+{
+    if (!is_digit(s[0]) || !is_digit(s[1])) return -EINVAL;
+    *out = (s[0]-'0')*10 + (s[1]-'0');
+    return 0;
+}
+
+static int parse_4d_year(const char *s, int *year)
+{
+    int i, y = 0;
+    for (i = 0; i < 4; i++) {
+        if (!is_digit(s[i])) return -EINVAL;
+        y = y*10 + (s[i]-'0');
+    }
+    *year = y;
+    return 0;
+}
+
+static int parse_datetime_14(const char *s14, struct ds_time *t)
+{
+    int ret, year4;
+    u8 mon, mday, hour, min, sec;
+
+    ret = parse_4d_year(s14 + 0, &year4); if (ret) return ret;
+    ret = parse_2d(s14 + 4, &mon);        if (ret) return ret;
+    ret = parse_2d(s14 + 6, &mday);       if (ret) return ret;
+    ret = parse_2d(s14 + 8, &hour);       if (ret) return ret;
+    ret = parse_2d(s14 +10, &min);        if (ret) return ret;
+    ret = parse_2d(s14 +12, &sec);        if (ret) return ret;
+
+    if (year4 < 2000 || year4 > 2099) return -ERANGE;
+    if (mon < 1 || mon > 12) return -ERANGE;
+    if (mday < 1 || mday > days_in_month(year4, mon)) return -ERANGE;
+    if (hour > 23 || min > 59 || sec > 59) return -ERANGE;
+
+    t->year = (u8)(year4 - 2000);
+    t->mon  = mon;
+    t->mday = mday;
+    t->hour = hour;
+    t->min  = min;
+    t->sec  = sec;
+    t->wday = ds_time_wday(t);
+    return 0;
+}
+
+// -------------------- I2C SSD1306 helpers --------------------
+/* 어댑터 quirk를 보고 전송 크기를 정한다 */
+static int oled_xfer_setup(struct ds_oled *d)
+{
+    struct i2c_adapter *adap = d->oled_i2c->adapter;
+    const struct i2c_adapter_quirks *q = adap->quirks;
+
+    // control byte 하나 + 데이터 1바이트도 못 보내는 컨트롤러로는 아무것도 못 씀
+    if (q && q->max_write_len && q->max_write_len < 2) {
+        dev_err(d->dev, "i2c adapter max_write_len %u too small\n", q->max_write_len);
+        return -EOPNOTSUPP;
+    }
+
+    d->oled_max_msg  = (q && q->max_write_len) ? q->max_write_len : 0;
+    d->oled_max_msgs = (q && q->max_num_msgs) ? q->max_num_msgs : 0;
+    d->oled_nostart  = i2c_check_functionality(adap, I2C_FUNC_NOSTART);
+
+    d->oled_chunk = OLED_CHUNK_MAX;
+    if (d->oled_max_msg && d->oled_max_msg - 1 < d->oled_chunk)
+        d->oled_chunk = d->oled_max_msg - 1;
+
+    dev_info(d->dev, "oled xfer: max_msg=%zu max_msgs=%d nostart=%d chunk=%zu\n",
+            d->oled_max_msg, d->oled_max_msgs, d->oled_nostart, d->oled_chunk);
+    return 0;
+}
+
+// control byte: cmd=0x00, data=0x40
+static int oled_i2c_write(struct ds_oled *d, bool is_data, const u8 *buf, size_t len)
+{
+    u8 tmp[1 + OLED_CHUNK_MAX];
+    size_t off = 0;
+    int ret;
+
+    if (!d->oled_i2c)
+        return -ENODEV;
+
+    tmp[0] = is_data ? 0x40 : 0x00;// command면 0x00 data면 0x01
+
+    while (off < len) {
+        size_t n = min(d->oled_chunk, len - off);
+        memcpy(&tmp[1], &buf[off], n);//tmp[1]에 buf[off]를 n바이트 만큼 복사
+        ret = i2c_master_send(d->oled_i2c, tmp, 1 + n); //oled_12c에 tmp의 주소값을 통해 
+        // 1+n만큼의 바이트를 보냄?.client로
+        if (ret < 0) return ret;
+        if (ret != 1 + n) return -EIO;
+        off += n;
+    }
+    return 0;
+}
+
+static inline int oled_cmd(struct ds_oled *d, u8 c) { return oled_i2c_write(d, false, &c, 1); }
+static inline int oled_data(struct ds_oled *d, const u8 *p, size_t n) { return oled_i2c_write(d, true, p, n); }
+
+static inline bool span_empty(const struct fb_span *s) { return s->lo >= s->hi; }
+
+static inline void span_add(struct fb_span *s, int lo, int hi)
+{
+    if (span_empty(s)) {
+        s->lo = lo;
+        s->hi = hi;
+        return;
+    }
+    if (lo < s->lo) s->lo = lo;
+    if (hi > s->hi) s->hi = hi;
+}
+
+static inline void span_reset(struct fb_span *s) { s->lo = s->hi = 0; }
+
+/* 그려진 영역만 지우고, 지운 자리는 dirty로 넘긴다 */
+static void fb_clear(struct oled_fb *f)
+{
+    int page;
+
+    for (page = 0; page < OLED_PAGES; page++) {
+        struct fb_span *ink = &f->ink[page];
+
+        if (span_empty(ink))
+            continue;
+        memset(&f->px[page * OLED_W + ink->lo], 0x00, ink->hi - ink->lo);
+        span_add(&f->dirty[page], ink->lo, ink->hi);
+        span_reset(ink);
+    }
+}
+
+/* 인쇄 가능한 ASCII 밖의 문자는 '?'로 */
+static inline const u8 *font6x8_glyph(char c)
+{
+    unsigned int idx = (u8)c - FONT6X8_FIRST;
+
+    if (idx >= FONT6X8_COUNT)
+        idx = '?' - FONT6X8_FIRST;
+    return font6x8[idx];
+}
+
+static void fb_draw_char6x8(struct oled_fb *f, int x, int page, char c)
+{
+    if (page < 0 || page >= OLED_PAGES) return;
+    if (x < 0 || x + 6 > OLED_W) return;
+
+    memcpy(&f->px[page * OLED_W + x], font6x8_glyph(c), 6);
+
+    span_add(&f->dirty[page], x, x + 6);
+    span_add(&f->ink[page], x, x + 6);
+}
+
+/* 한 페이지 행에 글리프를 연달아 복사하고 dirty/ink는 문자열 전체로 한 번만 갱신 */
+static void fb_draw_str6x8(struct oled_fb *f, int x, int page, const char *s)
+{
+    u8 *p;
+    int x0 = x;
+
+    if (page < 0 || page >= OLED_PAGES) return;
+    if (x < 0) return;
+
+    p = &f->px[page * OLED_W + x];
+    while (*s && x + 6 <= OLED_W) {
+        memcpy(p, font6x8_glyph(*s++), 6);
+        p += 6;
+        x += 6;
+    }
+
+    if (x > x0) {
+        span_add(&f->dirty[page], x0, x);
+        span_add(&f->ink[page], x0, x);
+    }
+}
+
+// -------------------- big clock digits (2x/3x/4x) --------------------
+/*
+ * 6x8 글리프를 clock_scale 배로 키운 것을 init 때 한 번 만들어 둔다.
+ * 페이지 단위([page][x])로 저장해서 그릴 때는 페이지마다 memcpy 한 번이면 끝.
+ * ':'는 폭을 4칸으로 줄여서 4x에서도 HH:MM + 작은 SS가 128 안에 들어가게 한다.
+ */
+#define BIG_MAX_SCALE 4
+#define BIG_CHARS     "0123456789:- "
+
+struct big_glyph {
+    u8 w;                                        // 픽셀 폭
+    u8 col[BIG_MAX_SCALE][6 * BIG_MAX_SCALE];    // [page][x]
+};
+
+static struct big_glyph big_font[sizeof(BIG_CHARS) - 1];
+static s8 big_map[FONT6X8_COUNT];                // 문자 -> big_font 인덱스, 없으면 -1
+
+static void big_font_build(int scale)
+{
+    int i, x, r, p, k;
+
+    memset(big_map, -1, sizeof(big_map));
+
+    for (i = 0; i < (int)sizeof(BIG_CHARS) - 1; i++) {
+        char c = BIG_CHARS[i];
+        const u8 *g = font6x8_glyph(c);
+        struct big_glyph *bg = &big_font[i];
+        int w = (c == ':') ? 4 : 6;
+
+        bg->w = w * scale;
+        for (x = 0; x < w; x++) {
+            u32 v = 0;
+
+            for (r = 0; r < 8; r++)
+                if (g[x] & BIT(r))
+                    v |= ((1u << scale) - 1) << (r * scale);
+
+            for (p = 0; p < scale; p++)
+                for (k = 0; k < scale; k++)
+                    bg->col[p][x * scale + k] = (v >> (8 * p)) & 0xFF;
+        }
+        big_map[c - FONT6X8_FIRST] = i;
+    }
+}
+
+/* clock_scale 페이지 높이로 문자열을 그리고 끝난 x를 돌려준다 (BIG_CHARS 밖은 공백) */
+static int fb_draw_big(struct oled_fb *f, int x, int page, const char *s)
+{
+    int p, x0 = x;
+
+    if (page < 0 || page + clock_scale > OLED_PAGES) return x;
+    if (x < 0) return x;
+
+    while (*s) {
+        unsigned int idx = (u8)*s++ - FONT6X8_FIRST;
+        int bi = (idx < FONT6X8_COUNT) ? big_map[idx] : -1;
+        const struct big_glyph *bg = &big_font[bi >= 0 ? bi : sizeof(BIG_CHARS) - 2];
+
+        if (x + bg->w > OLED_W)
+            break;
+        for (p = 0; p < clock_scale; p++)
+            memcpy(&f->px[(page + p) * OLED_W + x], bg->col[p], bg->w);
+        x += bg->w;
+    }
+
+    if (x > x0) {
+        for (p = 0; p < clock_scale; p++) {
+            span_add(&f->dirty[page + p], x0, x);
+            span_add(&f->ink[page + p], x0, x);
+        }
+    }
+    return x;
+}
+
+/* tm: "HH:MM:SS". 2x는 전부 크게, 3x/4x는 HH:MM만 크게 + SS는 6x8로 마지막 페이지 옆에 */
+static void fb_draw_clock(struct oled_fb *f, int page, const char *tm)
+{
+    char hm[6];
+    int x;
+
+    if (clock_scale <= 1) {
+        fb_draw_str6x8(f, 0, page, tm);
+        return;
+    }
+    if (clock_scale == 2) {
+        fb_draw_big(f, 0, page, tm);
+        return;
+    }
+
+    memcpy(hm, tm, 5);
+    hm[5] = '\0';
+    x = fb_draw_big(f, 0, page, hm);
+    fb_draw_str6x8(f, x + 2, page + clock_scale - 1, tm + 6);
+}
+
+static int oled_init(struct ds_oled *d)
+{
+    // RST 핀 없음 -> reset pulse 없음
+
+    // SSD1306 init (128x64, charge pump on)
+    oled_cmd(d, 0xAE);                // display off
+    oled_cmd(d, 0xD5); oled_cmd(d, 0x80);
+    oled_cmd(d, 0xA8); oled_cmd(d, 0x3F);
+    oled_cmd(d, 0xD3); oled_cmd(d, 0x00);
+    oled_cmd(d, 0x40);
+    oled_cmd(d, 0x8D); oled_cmd(d, 0x14); // charge pump on
+    oled_cmd(d, 0x20); oled_cmd(d, 0x00); // horizontal addressing
+    oled_cmd(d, 0xA1);
+    oled_cmd(d, 0xC8);
+    oled_cmd(d, 0xDA); oled_cmd(d, 0x12);
+    oled_cmd(d, 0x81); oled_cmd(d, 0xCF);
+    oled_cmd(d, 0xD9); oled_cmd(d, 0xF1);
+    oled_cmd(d, 0xDB); oled_cmd(d, 0x40);
+    oled_cmd(d, 0xA4);
+    oled_cmd(d, 0xA6);
+    oled_cmd(d, 0xAF);                // display on
+    return 0;
+}
+
+static void oled_build_hdr(u8 *hdr, const u8 *cmd)
+{
+    int i;
+
+    for (i = 0; i < 6; i++) {
+        hdr[2 * i]     = OLED_CTRL_CMD1;
+        hdr[2 * i + 1] = cmd[i];
+    }
+    hdr[OLED_XFER_HDR - 1] = OLED_CTRL_DATA;
+}
+
+/*
+ * 윈도우 명령과 데이터를 START 한 번(i2c_transfer 한 번)으로 보낸다.
+ *  - 0페이지부터 전체 폭: f->hdr 뒤에 px가 붙어 있으니 메시지 하나, 복사 없음
+ *  - NOSTART 지원: 헤더 + 행 조각들을 I2C_M_NOSTART로 이어 붙임, 복사 없음
+ *  - 그 외: oled_stage에 행 단위로 모아서 메시지 하나
+ * 어댑터가 메시지 길이를 제한해서 안 들어가면 -E2BIG -> 호출자가 쪼개기 방식으로 보냄
+ */
+static int oled_xfer_window(struct ds_oled *d, struct oled_fb *f, const u8 *cmd,
+                            int page0, int page1, int x0, int x1)
+{
+    struct i2c_msg msgs[1 + OLED_PAGES];
+    int w = x1 - x0;
+    int rows = (w == OLED_W) ? 1 : page1 - page0 + 1;
+    size_t seg = (w == OLED_W) ? (size_t)(page1 - page0 + 1) * OLED_W : w;
+    size_t len = OLED_XFER_HDR + seg * rows;
+    int i, n, ret;
+
+    if (!d->oled_i2c)
+        return -ENODEV;
+    if (d->oled_max_msg && len > d->oled_max_msg)
+        return -E2BIG;
+
+    if (rows == 1 && page0 == 0 && x0 == 0) {
+        oled_build_hdr(f->hdr, cmd);
+        msgs[0].addr  = d->oled_i2c->addr;
+        msgs[0].flags = 0;
+        msgs[0].len   = len;
+        msgs[0].buf   = f->hdr;
+        n = 1;
+    } else if (d->oled_nostart && (!d->oled_max_msgs || 1 + rows <= d->oled_max_msgs)) {
+        oled_build_hdr(f->hdr, cmd);
+        msgs[0].addr  = d->oled_i2c->addr;
+        msgs[0].flags = 0;
+        msgs[0].len   = OLED_XFER_HDR;
+        msgs[0].buf   = f->hdr;
+        for (i = 0; i < rows; i++) {
+            msgs[1 + i].addr  = d->oled_i2c->addr;
+            msgs[1 + i].flags = I2C_M_NOSTART;
+            msgs[1 + i].len   = seg;
+            msgs[1 + i].buf   = &f->px[(page0 + i) * OLED_W + x0];
+        }
+        n = 1 + rows;
+    } else {
+        oled_build_hdr(d->oled_stage, cmd);
+        for (i = 0; i < rows; i++)
+            memcpy(&d->oled_stage[OLED_XFER_HDR + i * seg],
+                   &f->px[(page0 + i) * OLED_W + x0], seg);
+        msgs[0].addr  = d->oled_i2c->addr;
+        msgs[0].flags = 0;
+        msgs[0].len   = len;
+        msgs[0].buf   = d->oled_stage;
+        n = 1;
+    }
+
+    ret = i2c_transfer(d->oled_i2c->adapter, msgs, n);
+    if (ret < 0) return ret;
+    if (ret != n) return -EIO;
+    return 0;
+}
+
+/* horizontal addressing 모드이므로 0x21/0x22로 컬럼/페이지 윈도우를 잡고 데이터를 민다 */
+static int oled_flush_window(struct ds_oled *d, struct oled_fb *f, int page0, int page1, int x0, int x1)
+{
+    u8 cmd[6] = { 0x21, x0, x1 - 1, 0x22, page0, page1 };
+    int ret;
+
+    d->flush_windows++;
+    d->flush_bytes += (page1 - page0 + 1) * (x1 - x0);
+    if (oled_single_xfer) {
+        ret = oled_xfer_window(d, f, cmd, page0, page1, x0, x1);
+        if (ret != -E2BIG)
+            return ret;
+    }
+
+    ret = oled_i2c_write(d, false, cmd, sizeof(cmd));
+    if (ret) return ret;
+
+    if (page0 == page1)
+        return oled_data(d, &f->px[page0 * OLED_W + x0], x1 - x0);
+
+    // 여러 페이지는 전체 폭일 때만 (px가 연속이라 그대로 보낼 수 있음)
+    return oled_data(d, &f->px[page0 * OLED_W], (page1 - page0 + 1) * OLED_W);
+}
+
+/*
+ * 한 페이지에서 (이 프레임의 dirty ∪ 패널에 있던 ink) 범위 안에서
+ * shadow와 다른 컬럼 구간만 골라 보낸다.
+ * 렌더가 매번 fb_clear 후 다시 그리므로 이 범위 밖은 양쪽 다 0이다.
+ */
+static int oled_flush_page(struct ds_oled *d, struct oled_fb *f, int page)
+{
+    const u8 *row = &f->px[page * OLED_W];
+    u8 *sh = &d->fb_shadow[page * OLED_W];
+    struct fb_span sp = f->dirty[page];
+    int x, start, end, ret;
+
+    if (!span_empty(&d->panel_ink[page]))
+        span_add(&sp, d->panel_ink[page].lo, d->panel_ink[page].hi);
+
+    x = sp.lo;
+    while (x < sp.hi) {
+        while (x < sp.hi && row[x] == sh[x])
+            x++;
+        if (x >= sp.hi)
+            break;
+
+        start = x;
+        end = x + 1;
+        for (x = start + 1; x < sp.hi; x++) {
+            if (row[x] != sh[x])
+                end = x + 1;
+            else if (x - end >= OLED_RUN_GAP)
+                break;
+        }
+
+        ret = oled_flush_window(d, f, page, page, start, end);
+        if (ret) return ret;
+        memcpy(&sh[start], &row[start], end - start);
+        x = end;
+    }
+    return 0;
+}
+
+/* flush worker에서만 호출 */
+static void oled_flush_frame(struct ds_oled *d, struct oled_fb *f)
+{
+    u64 t0 = ktime_get_ns();
+    int page, ret = 0;
+
+    d->flush_windows = 0;
+    d->flush_bytes = 0;
+    trace_oled_flush_begin(d->dev, !d->fb_shadow_valid);
+
+    if (!d->fb_shadow_valid) {
+        // 패널 내용을 모를 때(초기화 직후, I2C 에러 후)는 한 번 전체 전송
+        ret = oled_flush_window(d, f, 0, OLED_PAGES - 1, 0, OLED_W);
+        if (!ret) {
+            memcpy(d->fb_shadow, f->px, sizeof(d->fb_shadow));
+            d->fb_shadow_valid = true;
+        }
+    } else {
+        for (page = 0; page < OLED_PAGES; page++) {
+            if (span_empty(&f->dirty[page]) && span_empty(&d->panel_ink[page]))
+                continue;
+            ret = oled_flush_page(d, f, page);
+            if (ret) break;
+        }
+    }
+    trace_oled_flush_end(d->dev, d->flush_windows, d->flush_bytes, ret);
+
+    ds_hist_add(&d->h_flush, div_u64(ktime_get_ns() - t0, NSEC_PER_USEC));
+    ds_hist_add(&d->h_flush_bytes, d->flush_bytes);
+
+    if (ret) {
+        d->i2c_errors++;
+        dev_err_ratelimited(d->dev, "oled_flush failed: %d\n", ret);
+        d->fb_shadow_valid = false;   // 어디까지 갔는지 모르니 다음에 전체 재전송
+    }
+
+    memcpy(d->panel_ink, f->ink, sizeof(d->panel_ink));
+    for (page = 0; page < OLED_PAGES; page++)
+        span_reset(&f->dirty[page]);
+}
+
+/* 완성된 최신 프레임만 보낸다. 보내는 동안 새 프레임이 완성되면 한 번 더 돈다 */
+static void flush_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(work, struct ds_oled, oled_flush_work);
+
+    for (;;) {
+        spin_lock(&d->fb_lock);
+        if (!d->fb_ready) {
+            spin_unlock(&d->fb_lock);
+            return;
+        }
+        swap(d->fb_front, d->fb_back);
+        d->fb_ready = false;
+        spin_unlock(&d->fb_lock);
+
+        oled_flush_frame(d, d->fb_front);
+        d->frames_sent++;
+    }
+}
+
+/* 렌더 시작: fb_back을 잡는다. 아직 안 나간 프레임이 있으면 그 위에 덮어쓴다 */
+static void oled_begin_frame(struct ds_oled *d)
+{
+    spin_lock(&d->fb_lock);
+    if (d->fb_ready) {
+        d->fb_ready = false;
+        d->frames_dropped++;
+    }
+    d->fb_drawing = true;
+    spin_unlock(&d->fb_lock);
+}
+
+/* 렌더 끝: worker에 넘기고 바로 리턴 (버스 안 기다림) */
+static void oled_submit_frame(struct ds_oled *d)
+{
+    spin_lock(&d->fb_lock);
+    d->fb_drawing = false;
+    d->fb_ready = true;
+    spin_unlock(&d->fb_lock);
+
+    queue_work(d->oled_wq, &d->oled_flush_work);
+}
+
+/* init/exit용: 화면을 지우고 실제로 나갈 때까지 기다린다 */
+static void oled_clear_sync(struct ds_oled *d)
+{
+    mutex_lock(&d->render_lock);
+    oled_begin_frame(d);
+    fb_clear(d->fb_back);
+    oled_submit_frame(d);
+    mutex_unlock(&d->render_lock);
+    flush_work(&d->oled_flush_work);
+}
+
+// -------------------- fbdev (deferred I/O mmap) --------------------
+/*
+ * user space용 메모리는 1bpp 행 단위(한 줄 16바이트, 바이트 안에서는 LSB가 왼쪽).
+ * mmap 쓰기는 fb_deferred_io가 페이지 폴트로 잡아 모아두었다가 oled_fb_deferred_io를
+ * 부르고, 여기서 건드린 행이 속한 페이지만 SSD1306 페이지 형식으로 바꾼다.
+ * 실제로 I2C로 나가는 건 flush worker가 shadow와 비교해서 바뀐 컬럼뿐이다.
+ */
+#define OLED_FB_LINE  (OLED_W / 8)
+#define OLED_FB_SIZE  (OLED_FB_LINE * OLED_H)
+
+static void ui_kick(struct ds_oled *d);
+
+static void oled_fb_convert(struct ds_oled *d, const u8 *vmem, int page0, int page1)
+{
+    int page, x, bit;
+
+    for (page = page0; page <= page1; page++) {
+        for (x = 0; x < OLED_W; x++) {
+            const u8 *src = &vmem[page * 8 * OLED_FB_LINE + x / 8];
+            u8 b = 0;
+
+            for (bit = 0; bit < 8; bit++)
+                if ((src[bit * OLED_FB_LINE] >> (x % 8)) & 1)
+                    b |= BIT(bit);
+            d->fbdev_px[page * OLED_W + x] = b;
+        }
+    }
+}
+
+/* 행 [y0, y1)이 바뀜 -> 해당 페이지만 변환하고 프레임으로 제출 */
+static void oled_fb_update(struct ds_oled *d, int y0, int y1)
+{
+    int page;
+
+    if (!atomic_read(&d->fb_users))
+        return;   // 아무도 안 열었으면 패널은 시계 화면 차지
+    if (y1 > OLED_H) y1 = OLED_H;
+    if (y0 >= y1) return;
+
+    mutex_lock(&d->render_lock);
+    oled_fb_convert(d, d->oled_fbi->screen_buffer, y0 / 8, (y1 - 1) / 8);
+
+    oled_begin_frame(d);
+    memcpy(d->fb_back->px, d->fbdev_px, OLED_BUF);
+    for (page = 0; page < OLED_PAGES; page++) {
+        // 어디가 켜져 있는지 모르니 전체를 ink로 -> flush가 shadow와 통째로 비교
+        d->fb_back->ink[page].lo = 0;
+        d->fb_back->ink[page].hi = OLED_W;
+        span_add(&d->fb_back->dirty[page], 0, OLED_W);
+    }
+    oled_submit_frame(d);
+    mutex_unlock(&d->render_lock);
+}
+
+static void oled_fb_deferred_io(struct fb_info *info, struct list_head *pagereflist)
+{
+    struct ds_oled *d = info->par;
+
+    struct fb_deferred_io_pageref *pageref;
+    unsigned long lo = ULONG_MAX, hi = 0;
+
+    list_for_each_entry(pageref, pagereflist, list) {
+        lo = min(lo, pageref->offset);
+        hi = max(hi, pageref->offset + PAGE_SIZE);
+    }
+    if (lo >= hi)
+        return;
+
+    hi = min_t(unsigned long, hi, OLED_FB_SIZE);
+    oled_fb_update(d, lo / OLED_FB_LINE, DIV_ROUND_UP(hi, OLED_FB_LINE));
+}
+
+static ssize_t oled_fb_write(struct fb_info *info, const char __user *buf,
+                             size_t count, loff_t *ppos)
+{
+    struct ds_oled *d = info->par;
+    loff_t pos = *ppos;
+    ssize_t ret;
+
+    ret = fb_sys_write(info, buf, count, ppos);
+    if (ret > 0)
+        oled_fb_update(d, pos / OLED_FB_LINE, DIV_ROUND_UP(*ppos, OLED_FB_LINE));
+    return ret;
+}
+
+static void oled_fb_fillrect(struct fb_info *info, const struct fb_fillrect *rect)
+{
+    struct ds_oled *d = info->par;
+
+    sys_fillrect(info, rect);
+    oled_fb_update(d, 0, OLED_H);
+}
+
+static void oled_fb_copyarea(struct fb_info *info, const struct fb_copyarea *area)
+{
+    struct ds_oled *d = info->par;
+
+    sys_copyarea(info, area);
+    oled_fb_update(d, 0, OLED_H);
+}
+
+static void oled_fb_imageblit(struct fb_info *info, const struct fb_image *image)
+{
+    struct ds_oled *d = info->par;
+
+    sys_imageblit(info, image);
+    oled_fb_update(d, 0, OLED_H);
+}
+
+/* user space가 열면 패널을 넘겨주고, 마지막으로 닫으면 시계 화면을 다시 그린다 */
+static int oled_fb_open(struct fb_info *info, int user)
+{
+    struct ds_oled *d = info->par;
+
+    if (user && atomic_inc_return(&d->fb_users) == 1)
+        oled_fb_update(d, 0, OLED_H);
+    return 0;
+}
+
+static int oled_fb_release(struct fb_info *info, int user)
+{
+    struct ds_oled *d = info->par;
+
+    if (user && atomic_dec_and_test(&d->fb_users))
+        ui_kick(d);
+    return 0;
+}
+
+static const struct fb_ops oled_fb_ops = {
+    .owner        = THIS_MODULE,
+    .fb_open      = oled_fb_open,
+    .fb_release   = oled_fb_release,
+    .fb_read      = fb_sys_read,
+    .fb_write     = oled_fb_write,
+    .fb_fillrect  = oled_fb_fillrect,
+    .fb_copyarea  = oled_fb_copyarea,
+    .fb_imageblit = oled_fb_imageblit,
+    .fb_mmap      = fb_deferred_io_mmap,
+};
+
+/* devm 액션: 등록 역순으로 내린다 */
+static void oled_fb_unregister(void *data)
+{
+    struct ds_oled *d = data;
+    struct fb_info *info = d->oled_fbi;
+
+    unregister_framebuffer(info);
+    fb_deferred_io_cleanup(info);
+    free_pages((unsigned long)info->screen_buffer, get_order(OLED_FB_SIZE));
+    framebuffer_release(info);
+    d->oled_fbi = NULL;
+}
+
+static int oled_fb_register(struct ds_oled *d)
+{
+    struct fb_info *info;
+    void *vmem;
+    int ret;
+
+    info = framebuffer_alloc(0, d->dev);
+    if (!info)
+        return -ENOMEM;
+
+    // defio는 페이지 단위로 매핑하므로 페이지 할당
+    vmem = (void *)__get_free_pages(GFP_KERNEL | __GFP_ZERO, get_order(OLED_FB_SIZE));
+    if (!vmem) {
+        ret = -ENOMEM;
+        goto err_release;
+    }
+
+    // defio 상태(페이지 목록, 락)는 fb마다 따로
+    d->fb_defio.delay       = HZ / 20;
+    d->fb_defio.deferred_io = oled_fb_deferred_io;
+
+    info->par    = d;
+    info->fbops  = &oled_fb_ops;
+    info->fbdefio = &d->fb_defio;
+    info->flags  = FBINFO_VIRTFB;
+    info->screen_buffer = vmem;
+    info->screen_size   = OLED_FB_SIZE;
+
+    strscpy(info->fix.id, "ssd1306", sizeof(info->fix.id));
+    info->fix.type        = FB_TYPE_PACKED_PIXELS;
+    info->fix.visual      = FB_VISUAL_MONO10;
+    info->fix.line_length = OLED_FB_LINE;
+    info->fix.accel       = FB_ACCEL_NONE;
+    info->fix.smem_start  = __pa(vmem);
+    info->fix.smem_len    = OLED_FB_SIZE;
+
+    info->var.xres = info->var.xres_virtual = OLED_W;
+    info->var.yres = info->var.yres_virtual = OLED_H;
+    info->var.bits_per_pixel = 1;
+    info->var.red.length = info->var.green.length = info->var.blue.length = 1;
+
+    ret = fb_deferred_io_init(info);
+    if (ret)
+        goto err_free;
+
+    ret = register_framebuffer(info);
+    if (ret)
+        goto err_defio;
+
+    d->oled_fbi = info;
+    dev_info(d->dev, "panel exposed as /dev/fb%d\n", info->node);
+    return devm_add_action_or_reset(d->dev, oled_fb_unregister, d);
+
+err_defio:
+    fb_deferred_io_cleanup(info);
+err_free:
+    free_pages((unsigned long)vmem, get_order(OLED_FB_SIZE));
+err_release:
+    framebuffer_release(info);
+    return ret;
+}
+
+// -------------------- tick work (event driven) --------------------
+/* 로터리 IRQ에서 불림: 기다리지 말고 바로 tick */
+static void ui_kick(struct ds_oled *d)
+{
+    if (READ_ONCE(d->ui_stopping))
+        return;
+    // 이미 대기 중인 kick이 있으면 그 시각을 유지 (지연은 처음 kick부터 잰다)
+    atomic64_cmpxchg(&d->kick_ns, 0, ktime_get_ns());
+    mod_delayed_work(system_wq, &d->tick_work, 0);
+}
+
+static void ui_kick_cb(void *data)
+{
+    ui_kick(data);
+}
+
+// -------------------- sensor producers (sense_wq) --------------------
+/* 새 값을 캐시에 올리고, 바뀌었으면 tick을 깨운다 */
+static void sense_publish_th(struct ds_oled *d, int t, int h)
+{
+    bool changed;
+
+    spin_lock(&d->sense_lock);
+    changed = (t != d->temp_cache || h != d->humi_cache);
+    if (changed) {
+        d->temp_cache = t;
+        d->humi_cache = h;
+        d->sense_changed = true;
+    }
+    spin_unlock(&d->sense_lock);
+
+    if (changed)
+        ui_kick(d);
+}
+
+/* dht11 캡처 완료 (dht11의 workqueue에서). 실패면 -1/-1로 "--" 표시 */
+static void ds_dht_done(void *data, int err, int t, int h, ktime_t kt)
+{
+    struct ds_oled *d = data;
+
+    sense_publish_th(d, err ? -1 : t, err ? -1 : h);
+}
+
+/* dht11: 요청만 걸고 바로 돌아온다. 시작 펄스와 캡처는 dht11 쪽 work가 진행 */
+static void dht_work_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(to_delayed_work(work), struct ds_oled, dht_work);
+
+    if (dht11_read_async(d->dht, ds_dht_done, d))
+        sense_publish_th(d, -1, -1);
+
+    if (!READ_ONCE(d->ui_stopping))
+        queue_delayed_work(d->sense_wq, &d->dht_work, msecs_to_jiffies(SENSE_TICK_MS));
+}
+
+/*
+ * RTC: 정렬 후에는 sec_timer가 초 경계마다 깨우고, 정렬 전에는 스스로 1초마다.
+ * 시간 캐시는 resync 때만 버스를 쓰지만 그때는 ds_lock을 잡고 비트뱅하므로 tick 밖에서.
+ * SET 모드 저장 쓰기도 여기서 한다 (tick은 set_pending만 올림).
+ */
+static void rtc_work_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(to_delayed_work(work), struct ds_oled, rtc_work);
+    struct ds_time now, req;
+    unsigned int mask;
+    bool ok, changed, edge, save;
+    int ret = 0;
+
+    spin_lock(&d->sense_lock);
+    save = d->set_pending;
+    req = d->set_req;
+    mask = d->set_mask;
+    d->set_pending = false;
+    spin_unlock(&d->sense_lock);
+
+    mutex_lock(&d->ds_lock);
+    if (save)
+        ret = ds1302_set_regs(d, &req, mask);
+    ok = (ds1302_get_time(d, &now) == 0);   // 방금 쓴 시간도 바로 다시 읽힘
+    mutex_unlock(&d->ds_lock);
+
+    spin_lock(&d->sense_lock);
+    if (save) {
+        d->set_ret = ret;
+        d->set_done = true;
+    }
+    edge = ok && (!d->cache_ok || now.sec != d->t_cache.sec);
+    // 초가 넘어갔거나 읽기 성공/실패가 바뀌었을 때만 다시 그림
+    changed = (ok != d->cache_ok || (ok && memcmp(&now, &d->t_cache, sizeof(now))));
+    if (changed) {
+        if (ok)
+            d->t_cache = now;
+        d->cache_ok = ok;
+        d->sense_changed = true;
+    }
+    spin_unlock(&d->sense_lock);
+
+    if (READ_ONCE(d->sec_timer_on))
+        goto out;
+
+    // 경계 정렬 전(sec_timer 없음)에는 초가 넘어가는 것을 여기서 알린다
+    if (edge)
+        ds_poll_signal(d);
+    if (!READ_ONCE(d->ui_stopping))
+        queue_delayed_work(d->sense_wq, &d->rtc_work, msecs_to_jiffies(SENSE_TICK_MS));
+out:
+    if (changed || save)
+        ui_kick(d);
+}
+
+/*
+ * 다음 SET 모드 blink까지 남은 jiffies.
+ * NORMAL 모드에서는 스스로 할 일이 없으므로 -1 -> producer/로터리가 깨울 때까지 잔다.
+ */
+static long ui_next_delay(struct ds_oled *d)
+{
+    unsigned long now = jiffies;
+    unsigned long next;
+
+    if (d->mode != UI_SET)
+        return -1;
+    next = d->last_blink_j + msecs_to_jiffies(BLINK_MS);
+    return time_after(next, now) ? (long)(next - now) : 0;
+}
+
+static void ui_stat_roll(struct ds_oled *d)
+{
+    unsigned long el = jiffies - d->ui_stat_j;
+
+    if (el < HZ)
+        return;
+    d->ui_wakeups_ps = DIV_ROUND_UP(d->ui_wakeups * HZ, el);
+    d->ui_frames_ps  = DIV_ROUND_UP(d->ui_frames * HZ, el);
+    d->ui_wakeups = 0;
+    d->ui_frames = 0;
+    d->tick_lat_max_us_ps = d->tick_lat_max_us;
+    d->tick_run_max_us_ps = d->tick_run_max_us;
+    d->tick_lat_max_us = 0;
+    d->tick_run_max_us = 0;
+    d->ui_stat_j = jiffies;
+}
+
+/* 화면 한 장: 버스/락/인스턴스 상태와 무관 (KUnit 벤치마크도 이걸 그린다) */
+static void ui_draw(struct oled_fb *f, bool set_mode, const char *th, const char *dt, const char *tm)
+{
+    fb_clear(f);
+    if (set_mode)
+        fb_draw_str6x8(f, 0, 0, "SET");
+    fb_draw_str6x8(f, 74, 0, th);
+    fb_draw_str6x8(f, 0, 2, dt);
+    if (set_mode)
+        fb_draw_str6x8(f, 0, 4, tm);   // 편집 중에는 모든 필드가 보이게 작은 글씨
+    else
+        fb_draw_clock(f, 4, tm);
+}
+
+static void ui_render(struct ds_oled *d)
+{
+    char buf_th[16];      // "T25C H60%"
+    char buf_dt[24];      // "2025-12-17"
+    char buf_tm[16];      // "17:40:00"
+    struct ds_time tc;
+    int year4, temp, humi;
+    bool ok;
+
+    // producer가 올려 둔 값의 복사본으로만 그린다
+    spin_lock(&d->sense_lock);
+    tc = d->t_cache;
+    ok = d->cache_ok;
+    temp = d->temp_cache;
+    humi = d->humi_cache;
+    spin_unlock(&d->sense_lock);
+
+    /* (A) 온습도: 캐시값만 사용 -> 안 깜빡임 */
+    if (temp >= 0 && humi >= 0)
+        snprintf(buf_th, sizeof(buf_th), "T%02dC H%02d%%", temp, humi);
+    else
+        snprintf(buf_th, sizeof(buf_th), "T--C H--%%");
+
+    /* (B) 날짜/시간: SET이면 edit, NORMAL이면 t_cache */
+    if (d->mode == UI_SET) {
+        year4 = 2000 + d->edit.year;
+        snprintf(buf_dt, sizeof(buf_dt), "%04d-%02u-%02u", year4, d->edit.mon, d->edit.mday);
+        snprintf(buf_tm, sizeof(buf_tm), "%02u:%02u:%02u", d->edit.hour, d->edit.min, d->edit.sec);
+
+        /* blink는 표시만 가리기(값 변경과 무관) */
+        apply_blink_mask(buf_dt, buf_tm, d->field, d->blink_on);
+
+    } else {
+        if (ok) {
+            year4 = 2000 + tc.year;
+            snprintf(buf_dt, sizeof(buf_dt), "%04d-%02u-%02u", year4, tc.mon, tc.mday);
+            snprintf(buf_tm, sizeof(buf_tm), "%02u:%02u:%02u", tc.hour, tc.min, tc.sec);
+        } else {
+            snprintf(buf_dt, sizeof(buf_dt), "---- -- --");
+            snprintf(buf_tm, sizeof(buf_tm), "--:--:--");
+        }
+    }
+
+    mutex_lock(&d->render_lock);
+    oled_begin_frame(d);
+    ui_draw(d->fb_back, d->mode == UI_SET, buf_th, buf_dt, buf_tm);
+    oled_submit_frame(d);
+    mutex_unlock(&d->render_lock);
+}
+
+static void tick_fn(struct work_struct *work)
+{
+    struct ds_oled *d = container_of(to_delayed_work(work), struct ds_oled, tick_work);
+    u64 start = ktime_get_ns();
+    u64 kicked = atomic64_xchg(&d->kick_ns, 0);
+    u32 us;
+    int ev;
+    int guard = 8;
+
+    d->ui_wakeups++;
+    if (kicked && start > kicked) {
+        us = div_u64(start - kicked, NSEC_PER_USEC);
+        d->tick_lat_max_us = max(d->tick_lat_max_us, us);
+    }
+
+    /* =========================
+     * 1) 로터리 이벤트: 즉시 반영 (로터리가 없으면 NORMAL 고정)
+     * ========================= */
+    if (d->set_saving)
+        save_done_set_mode(d);
+    while (d->rot && guard-- > 0 && (ev = rotary_get_event(d->rot)) != ROT_EV_NONE) {
+
+        // 저장 결과를 기다리는 동안 들어온 입력은 버린다
+        if (d->set_saving)
+            continue;
+
+        if (ev == ROT_EV_BTN_DOWN) {
+            if (d->mode == UI_NORMAL) {
+                enter_set_mode(d);
+            } else { // UI_SET
+                if (d->field == FLD_SEC) {
+                    save_and_exit_set_mode(d);
+                } else {
+                    field_next(d);
+                }
+            }
+            d->ui_dirty = true;
+            continue;
+        }
+
+        /* 회전은 SET 모드에서만 편집 */
+        if (d->mode == UI_SET) {
+            if (ev == ROT_EV_CW)  edit_add(&d->edit, d->field, +1);
+            if (ev == ROT_EV_CCW) edit_add(&d->edit, d->field, -1);
+            d->ui_dirty = true;
+        }
+    }
+    if (guard < 0)
+        ui_kick(d);  // 아직 남은 이벤트가 있을 수 있음
+
+    /* =========================
+     * 2) 센서/RTC 캐시: producer(dht_work, rtc_work)가 올려 둔 변경만 가져간다.
+     *    여기서는 센서나 DS1302를 기다리지 않는다.
+     * ========================= */
+    spin_lock(&d->sense_lock);
+    if (d->sense_changed) {
+        d->sense_changed = false;
+        d->ui_dirty = true;
+    }
+    spin_unlock(&d->sense_lock);
+
+    /* =========================
+     * 3) 커서 깜빡임: SET에서만
+     * ========================= */
+    if (d->mode == UI_SET) {
+        if (time_after_eq(jiffies, d->last_blink_j + msecs_to_jiffies(BLINK_MS))) {
+            d->last_blink_j = jiffies;
+            d->blink_on = !d->blink_on;
+            d->ui_dirty = true;
+        }
+    } else if (!d->blink_on) {
+        d->blink_on = true; // NORMAL에선 마스크 안 쓰게 항상 ON 처리
+        d->ui_dirty = true;
+    }
+
+    /* =========================
+     * 4) 바뀐 게 있을 때만 문자열 만들고 그리기
+     *    (/dev/fbN 을 user space가 열고 있으면 패널은 그쪽 차지, dirty는 남겨 둠)
+     * ========================= */
+    if (d->ui_dirty && !atomic_read(&d->fb_users)) {
+        u64 r0 = ktime_get_ns();
+
+        d->ui_dirty = false;
+        ui_render(d);
+        d->ui_frames++;
+        ds_hist_add(&d->h_render, div_u64(ktime_get_ns() - r0, NSEC_PER_USEC));
+    }
+    us = div_u64(ktime_get_ns() - start, NSEC_PER_USEC);
+    d->tick_run_max_us = max(d->tick_run_max_us, us);
+    ds_hist_add(&d->h_tick, us);
+    ui_stat_roll(d);
+
+    /* =========================
+     * 5) 다음 tick: 다음 blink 시점까지 잔다.
+     *    새 센서/RTC 값과 로터리 이벤트는 ui_kick(d)이 깨운다.
+     *    (mod_가 아니라 queue_: 실행 중에 들어온 kick(0)을 덮어쓰지 않게)
+     * ========================= */
+    {
+        long delay = ui_next_delay(d);
+
+        if (delay >= 0 && !READ_ONCE(d->ui_stopping))
+            queue_delayed_work(system_wq, &d->tick_work, delay);
+    }
+}
+
+// -------------------- sysfs: UI 통계 --------------------
+static ssize_t wakeups_per_sec_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", d->ui_wakeups_ps);
+}
+static DEVICE_ATTR_RO(wakeups_per_sec);
+
+static ssize_t frames_per_sec_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", d->ui_frames_ps);
+}
+static DEVICE_ATTR_RO(frames_per_sec);
+
+static ssize_t frames_sent_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%lu\n", d->frames_sent);
+}
+static DEVICE_ATTR_RO(frames_sent);
+
+/* 버스가 렌더를 못 따라가서 보내지 못하고 덮어쓴 프레임 수 */
+static ssize_t frames_dropped_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%lu\n", d->frames_dropped);
+}
+static DEVICE_ATTR_RO(frames_dropped);
+
+/* 실제 DS1302 burst read 횟수 (나머지 읽기는 캐시에서 외삽) */
+static ssize_t rtc_reads_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%lu\n", d->ds_rtc_reads);
+}
+static DEVICE_ATTR_RO(rtc_reads);
+
+/* DS1302 바이트 하나 보내고/받는 데 걸린 시간 (마지막 clock burst read 기준) */
+static ssize_t rtc_byte_ns_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", d->ds_byte_ns);
+}
+static DEVICE_ATTR_RO(rtc_byte_ns);
+
+/*
+ * tick 지터 (1초 창 최대, us): kick(producer/로터리) -> tick 시작까지, tick 한 번 실행 시간.
+ * tick 안에서 센서를 기다리지 않으므로 run은 렌더 시간 정도여야 한다.
+ */
+static ssize_t tick_latency_us_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", d->tick_lat_max_us_ps);
+}
+static DEVICE_ATTR_RO(tick_latency_us);
+
+static ssize_t tick_run_us_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+    struct ds_oled *d = dev_get_drvdata(dev);
+
+    return sysfs_emit(buf, "%u\n", d->tick_run_max_us_ps);
+}
+static DEVICE_ATTR_RO(tick_run_us);
+
+static struct attribute *ds_attrs[] = {
+    &dev_attr_wakeups_per_sec.attr,
+    &dev_attr_frames_per_sec.attr,
+    &dev_attr_frames_sent.attr,
+    &dev_attr_frames_dropped.attr,
+    &dev_attr_rtc_reads.attr,
+    &dev_attr_rtc_byte_ns.attr,
+    &dev_attr_tick_latency_us.attr,
+    &dev_attr_tick_run_us.attr,
+    NULL,
+};
+ATTRIBUTE_GROUPS(ds);
+
+
+// -------------------- debugfs: 지연 히스토그램 + 카운터 --------------------
+/*
+ * <debugfs>/ds1302_oled/<dev>/
+ *  hist_tick_us     tick_fn 한 번 (rotary 처리 + 렌더)
+ *  hist_render_us   ui_render (fb_back에 그리기만, 버스 안 기다림)
+ *  hist_flush_us    flush worker가 프레임 하나를 보내는 동안 (= I2C 버스 잡고 있는 시간)
+ *  hist_flush_bytes 프레임 하나에 보낸 픽셀 데이터 바이트
+ *  counters         reset 이후 frames/dropped/i2c_errors, 평균 fps
+ *  reset            아무거나 쓰면 위를 전부 0으로
+ */
+static int ds_hist_show(struct seq_file *m, void *unused)
+{
+    struct ds_hist *h = m->private;
+    struct ds_hist_data v;
+    int i, last = 0;
+
+    spin_lock(&h->lock);
+    v = h->v;
+    spin_unlock(&h->lock);
+
+    seq_printf(m, "count %llu avg %llu max %llu (%s)\n", v.count,
+               v.count ? div64_u64(v.sum, v.count) : 0, v.max, h->unit);
+    for (i = 0; i < DS_HIST_BUCKETS; i++)
+        if (v.bucket[i])
+            last = i;
+    for (i = 0; i <= last; i++) {
+        u64 lo = i ? 1ULL << (i - 1) : 0;
+
+        if (i == DS_HIST_BUCKETS - 1)
+            seq_printf(m, "%10llu ..            : %u\n", lo, v.bucket[i]);
+        else
+            seq_printf(m, "%10llu .. %-10llu : %u\n", lo, i ? (1ULL << i) - 1 : 0, v.bucket[i]);
+    }
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(ds_hist);
+
+static int ds_counters_show(struct seq_file *m, void *unused)
+{
+    struct ds_oled *d = m->private;
+    unsigned long frames = d->frames_sent - d->dbg_frames_base;
+    u64 ms = ktime_ms_delta(ktime_get(), d->dbg_reset_kt);
+    u64 fps100 = ms ? div64_u64((u64)frames * 100000, ms) : 0;
+
+    seq_printf(m, "frames     %lu\n", frames);
+    seq_printf(m, "dropped    %lu\n", d->frames_dropped - d->dbg_dropped_base);
+    seq_printf(m, "i2c_errors %lu\n", d->i2c_errors - d->dbg_errors_base);
+    seq_printf(m, "fps        %llu.%02llu\n", div_u64(fps100, 100), fps100 % 100);
+    seq_printf(m, "elapsed_ms %llu\n", ms);
+    return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(ds_counters);
+
+static void ds_hist_reset(struct ds_hist *h)
+{
+    spin_lock(&h->lock);
+    memset(&h->v, 0, sizeof(h->v));
+    spin_unlock(&h->lock);
+}
+
+static void ds_dbg_reset(struct ds_oled *d)
+{
+    ds_hist_reset(&d->h_tick);
+    ds_hist_reset(&d->h_render);
+    ds_hist_reset(&d->h_flush);
+    ds_hist_reset(&d->h_flush_bytes);
+    d->dbg_frames_base = d->frames_sent;
+    d->dbg_dropped_base = d->frames_dropped;
+    d->dbg_errors_base = d->i2c_errors;
+    d->dbg_reset_kt = ktime_get();
+}
+
+static ssize_t ds_dbg_reset_write(struct file *file, const char __user *buf,
+                                  size_t len, loff_t *ppos)
+{
+    ds_dbg_reset(file->private_data);
+    return len;
+}
+
+static const struct file_operations ds_dbg_reset_fops = {
+    .owner  = THIS_MODULE,
+    .open   = simple_open,
+    .write  = ds_dbg_reset_write,
+    .llseek = noop_llseek,
+};
+
+static void ds_hist_init(struct ds_hist *h, const char *unit)
+{
+    spin_lock_init(&h->lock);
+    h->unit = unit;
+}
+
+static void ds_debugfs_remove(void *data)
+{
+    debugfs_remove_recursive(data);
+}
+
+/* 디렉터리 이름은 /dev 이름과 같게. debugfs가 없어도 드라이버는 동작해야 하므로 에러는 안 본다 */
+static int ds_debugfs_add(struct ds_oled *d)
+{
+    struct dentry *dir = debugfs_create_dir(dev_name(d->ds_dev), ds_debugfs_root);
+
+    debugfs_create_file("hist_tick_us", 0444, dir, &d->h_tick, &ds_hist_fops);
+    debugfs_create_file("hist_render_us", 0444, dir, &d->h_render, &ds_hist_fops);
+    debugfs_create_file("hist_flush_us", 0444, dir, &d->h_flush, &ds_hist_fops);
+    debugfs_create_file("hist_flush_bytes", 0444, dir, &d->h_flush_bytes, &ds_hist_fops);
+    debugfs_create_file("counters", 0444, dir, d, &ds_counters_fops);
+    debugfs_create_file("reset", 0200, dir, d, &ds_dbg_reset_fops);
+    return devm_add_action_or_reset(d->dev, ds_debugfs_remove, dir);
+}
+
+// -------------------- char device fops --------------------
+/*
+ * 읽기는 시간 캐시(ds1302_get_time)에서. 버스는 resync 때만 건드린다.
+ *  - 열고 처음 읽기는 바로 돌려준다.
+ *  - 그 다음부터 읽기는 다음 초 경계나 시간 설정까지 잔다. O_NONBLOCK이면 -EAGAIN.
+ *    poll/select는 그때 POLLIN -> poll() 뒤 read()를 같은 fd로 그대로 반복하면 된다.
+ *  - 파일이 아니라 시각의 흐름이라 offset은 보지 않는다 (EOF 없음, cat은 매초 한 줄).
+ */
+struct ds_file {
+    struct ds_oled *d;
+    unsigned int seen;      // 마지막으로 돌려준 때의 poll_seq
+    bool fresh;             // 열고 아직 안 읽음
+};
+
+static bool ds_file_ready(struct ds_file *f)
+{
+    return f->fresh || READ_ONCE(f->d->gone) ||
+           (unsigned int)atomic_read(&f->d->poll_seq) != f->seen;
+}
+
+/* 파일 경로에서 DS1302를 만지기 전: ds_lock을 잡되, 장치가 빠졌으면 잡지 않고 -ENODEV */
+static int ds_file_lock(struct ds_oled *d)
+{
+    mutex_lock(&d->ds_lock);
+    if (d->gone) {
+        mutex_unlock(&d->ds_lock);
+        return -ENODEV;
+    }
+    return 0;
+}
+
+static void ds_free(struct kref *kref)
+{
+    kfree(container_of(kref, struct ds_oled, ref));
+}
+
+static void ds_put(void *data)
+{
+    struct ds_oled *d = data;
+
+    kref_put(&d->ref, ds_free);
+}
+
+static int my_open(struct inode *inode, struct file *file)
+{
+    struct ds_oled *d;
+    struct ds_file *f;
+
+    f = kzalloc(sizeof(*f), GFP_KERNEL);
+    if (!f)
+        return -ENOMEM;
+
+    // ds_cdev_remove가 표에서 빼고 나면 새로 열 수 없다
+    mutex_lock(&ds_devs_lock);
+    d = ds_devs[iminor(inode)];
+    if (d)
+        kref_get(&d->ref);
+    mutex_unlock(&ds_devs_lock);
+    if (!d) {
+        kfree(f);
+        return -ENODEV;
+    }
+
+    f->d = d;
+    f->fresh = true;
+    file->private_data = f;
+    return stream_open(inode, file);   // 시간 스트림: 위치 없음 (lseek/pread는 -ESPIPE)
+}
+
+static int my_release(struct inode *inode, struct file *file)
+{
+    struct ds_file *f = file->private_data;
+
+    ds_put(f->d);
+    kfree(f);
+    return 0;
+}
+
+static __poll_t my_poll(struct file *file, poll_table *wait)
+{
+    struct ds_file *f = file->private_data;
+    __poll_t mask = EPOLLOUT | EPOLLWRNORM;   // 쓰기는 기다리지 않음
+
+    poll_wait(file, &f->d->poll_wq, wait);
+    if (READ_ONCE(f->d->gone))
+        return EPOLLHUP | EPOLLERR;
+    if (ds_file_ready(f))
+        mask |= EPOLLIN | EPOLLRDNORM;
+    return mask;
+}
+
+static ssize_t my_read(struct file *file, char __user *ubuf, size_t count, loff_t *ppos)
+{
+    struct ds_file *f = file->private_data;
+    struct ds_oled *d = f->d;
     struct ds_time t;
     char out[32];
+    unsigned int seq;
     int len, ret, year4;
 
-    if (*ppos > 0) return 0; // EOF
+    // 한 줄("YYYYMMDDhhmmss\n")이 안 들어가면 아무것도 소비하지 않고 실패
+    if (count < 15) return -EINVAL;
 
-    mutex_lock(&ds_lock);
-    ret = ds1302_read_time(&t);
-    mutex_unlock(&ds_lock);
+    if (!ds_file_ready(f)) {
+        if (file->f_flags & O_NONBLOCK)
+            return -EAGAIN;
+        ret = wait_event_interruptible(d->poll_wq, ds_file_ready(f));
+        if (ret) return ret;
+    }
+    // 시간을 읽기 전에 기록: 읽는 도중 넘어간 초는 다음 읽기에서 잡힌다
+    seq = atomic_read(&d->poll_seq);
+
+    ret = ds_file_lock(d);
+    if (ret) return ret;
+    ret = ds1302_get_time(d, &t);
+    mutex_unlock(&d->ds_lock);
     if (ret) return ret;
 
     year4 = 2000 + t.year;
@@ -757,12 +2864,15 @@ static ssize_t my_read(struct file *file, char __user *ubuf, size_t count, loff_
     if (count < len) return -EINVAL;
     if (copy_to_user(ubuf, out, len)) return -EFAULT;
 
-    *ppos += len;
+    // 사용자에게 건네진 뒤에야 이 초를 본 것으로 친다
+    f->seen = seq;
+    f->fresh = false;
     return len;
 }
 
 static ssize_t my_write(struct file *file, const char __user *ubuf, size_t count, loff_t *ppos)
 {
+    struct ds_oled *d = ((struct ds_file *)file->private_data)->d;
     char kbuf[32];
     size_t n;
     struct ds_time t;
@@ -780,141 +2890,612 @@ static ssize_t my_write(struct file *file, const char __user *ubuf, size_t count
     ret = parse_datetime_14(kbuf, &t);
     if (ret) return ret;
 
-    mutex_lock(&ds_lock);
-    ret = ds1302_set_datetime(&t);
-    mutex_unlock(&ds_lock);
+    ret = ds_file_lock(d);
+    if (ret) return ret;
+    ret = ds1302_set_datetime(d, &t);
+    mutex_unlock(&d->ds_lock);
     if (ret) return ret;
 
     return count;
 }
 
+// -------------------- binary ioctl (ds1302_oled_ioctl.h) --------------------
+// ioctl 필드 비트를 ds1302_set_regs()의 레지스터 마스크로 그대로 넘긴다
+static_assert(DS1302_F_SEC  == BIT(DS_REG_SEC)  && DS1302_F_MIN  == BIT(DS_REG_MIN) &&
+              DS1302_F_HOUR == BIT(DS_REG_HOUR) && DS1302_F_MDAY == BIT(DS_REG_MDAY) &&
+              DS1302_F_MON  == BIT(DS_REG_MON)  && DS1302_F_WDAY == BIT(DS_REG_WDAY) &&
+              DS1302_F_YEAR == BIT(DS_REG_YEAR) && DS1302_F_ALL == GENMASK(DS_REG_NUM - 1, 0));
+
+static void ds_time_to_ioc(const struct ds_time *t, struct ds1302_time *u)
+{
+    memset(u, 0, sizeof(*u));
+    u->year = 2000 + t->year;
+    u->mon  = t->mon;
+    u->mday = t->mday;
+    u->hour = t->hour;
+    u->min  = t->min;
+    u->sec  = t->sec;
+    u->wday = t->wday;
+}
+
+/* 범위 검사 + wday가 0이면 날짜에서 계산 (1 = 일요일, RTC class와 같은 규칙) */
+static int ds_time_from_ioc(const struct ds1302_time *u, struct ds_time *t)
+{
+    if (u->year < 2000 || u->year > 2099) return -ERANGE;
+    if (u->mon < 1 || u->mon > 12) return -ERANGE;
+    if (u->mday < 1 || u->mday > days_in_month(u->year, u->mon)) return -ERANGE;
+    if (u->hour > 23 || u->min > 59 || u->sec > 59) return -ERANGE;
+    if (u->wday > 7) return -ERANGE;
+
+    t->year = u->year - 2000;
+    t->mon  = u->mon;
+    t->mday = u->mday;
+    t->hour = u->hour;
+    t->min  = u->min;
+    t->sec  = u->sec;
+    t->wday = u->wday ? u->wday : ds_time_wday(t);
+    return 0;
+}
+
+static bool ds_time_fields_equal(const struct ds_time *a, const struct ds_time *b, u32 fields)
+{
+    return !(ds_time_diff(a, b) & fields);
+}
+
+/* ds_lock 잡고 호출. t를 쓰되 cur과 다른 레지스터만 */
+static int ds_ioc_write(struct ds_oled *d, const struct ds_time *t, const struct ds_time *cur)
+{
+    return ds1302_set_regs(d, t, ds_time_diff(t, cur));
+}
+
+static long ds_ioctl_cas(struct ds_oled *d, struct ds1302_cas __user *uarg)
+{
+    struct ds1302_cas c;
+    struct ds_time expect, cur, t;
+    int ret;
+
+    if (copy_from_user(&c, uarg, sizeof(c))) return -EFAULT;
+    if ((c.check | c.mask) & ~DS1302_F_ALL) return -EINVAL;
+
+    // expect/set은 쓰는 필드만 의미가 있으므로 범위 검사도 그 필드만
+    expect.year = c.expect.year >= 2000 ? c.expect.year - 2000 : 0xff;
+    expect.mon  = c.expect.mon;
+    expect.mday = c.expect.mday;
+    expect.hour = c.expect.hour;
+    expect.min  = c.expect.min;
+    expect.sec  = c.expect.sec;
+    expect.wday = c.expect.wday;
+
+    ret = ds_file_lock(d);
+    if (ret) return ret;
+    ret = ds1302_get_time(d, &cur);
+    if (ret) {
+        mutex_unlock(&d->ds_lock);
+        return ret;
+    }
+
+    if (!ds_time_fields_equal(&cur, &expect, c.check)) {
+        ret = -EBUSY;
+        goto out;
+    }
+
+    t = cur;
+    if (c.mask & DS1302_F_YEAR) t.year = c.set.year >= 2000 ? c.set.year - 2000 : 0xff;
+    if (c.mask & DS1302_F_MON)  t.mon  = c.set.mon;
+    if (c.mask & DS1302_F_MDAY) t.mday = c.set.mday;
+    if (c.mask & DS1302_F_HOUR) t.hour = c.set.hour;
+    if (c.mask & DS1302_F_MIN)  t.min  = c.set.min;
+    if (c.mask & DS1302_F_SEC)  t.sec  = c.set.sec;
+    if (c.mask & DS1302_F_WDAY) t.wday = c.set.wday;
+
+    // 합친 결과 전체가 유효한 날짜여야 함 (예: 31일인데 달만 4월로 -> -EINVAL)
+    ds_time_to_ioc(&t, &c.set);
+    if (!(c.mask & DS1302_F_WDAY) && (c.mask & (DS1302_F_YEAR | DS1302_F_MON | DS1302_F_MDAY)))
+        c.set.wday = 0;   // 날짜가 바뀌면 요일도 따라감
+    ret = ds_time_from_ioc(&c.set, &t);
+    if (ret) {
+        ret = -EINVAL;
+        goto out;
+    }
+
+    ret = ds_ioc_write(d, &t, &cur);
+    if (!ret)
+        cur = t;
+out:
+    mutex_unlock(&d->ds_lock);
+
+    ds_time_to_ioc(&cur, &c.cur);
+    if (copy_to_user(&uarg->cur, &c.cur, sizeof(c.cur))) return -EFAULT;
+    return ret;
+}
+
+static long my_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    struct ds_oled *d = ((struct ds_file *)file->private_data)->d;
+    void __user *uarg = (void __user *)arg;
+    struct ds1302_time u;
+    struct ds_time t, cur;
+    s64 secs;
+    int ret;
+
+    switch (cmd) {
+    case DS1302_IOC_GET_TIME:
+    case DS1302_IOC_GET_EPOCH:
+        ret = ds_file_lock(d);
+        if (ret) return ret;
+        ret = ds1302_get_time(d, &t);
+        mutex_unlock(&d->ds_lock);
+        if (ret) return ret;
+
+        if (cmd == DS1302_IOC_GET_EPOCH) {
+            secs = ds_time_to_secs(&t);
+            return copy_to_user(uarg, &secs, sizeof(secs)) ? -EFAULT : 0;
+        }
+        ds_time_to_ioc(&t, &u);
+        return copy_to_user(uarg, &u, sizeof(u)) ? -EFAULT : 0;
+
+    case DS1302_IOC_SET_TIME:
+        if (copy_from_user(&u, uarg, sizeof(u))) return -EFAULT;
+        ret = ds_time_from_ioc(&u, &t);
+        if (ret) return ret;
+        break;
+
+    case DS1302_IOC_SET_EPOCH:
+        if (copy_from_user(&secs, uarg, sizeof(secs))) return -EFAULT;
+        if (secs < RTC_TIMESTAMP_BEGIN_2000 || secs > RTC_TIMESTAMP_END_2099) return -ERANGE;
+        ds_secs_to_time(secs, &t);
+        t.wday = 0;
+        ds_time_to_ioc(&t, &u);
+        ret = ds_time_from_ioc(&u, &t);   // 요일 채우기
+        if (ret) return ret;
+        break;
+
+    case DS1302_IOC_CAS_FIELDS:
+        return ds_ioctl_cas(d, uarg);
+
+    default:
+        return -ENOTTY;
+    }
+
+    // SET_TIME / SET_EPOCH: 지금 값과 다른 레지스터만 쓴다 (분만 바꾸면 단일 쓰기 한 번)
+    ret = ds_file_lock(d);
+    if (ret) return ret;
+    ret = ds1302_get_time(d, &cur);
+    if (ret)
+        ret = ds1302_set_datetime(d, &t);   // 지금 값을 모르면 전부
+    else
+        ret = ds_ioc_write(d, &t, &cur);
+    mutex_unlock(&d->ds_lock);
+    return ret;
+}
+
 static const struct file_operations fops = {
     .owner   = THIS_MODULE,
     .open    = my_open,
     .read    = my_read,
     .write   = my_write,
+    .poll    = my_poll,
+    .unlocked_ioctl = my_ioctl,
+    .compat_ioctl   = compat_ptr_ioctl,
     .release = my_release,
 };
 
-// -------------------- module init/exit --------------------
-static int __init ds1302_oled_init(void)
+// -------------------- i2c driver (인스턴스마다 probe) --------------------
+/*
+ * 해제는 전부 devm 액션으로 건다. unbind 때 등록 역순으로 풀리므로
+ * /dev -> RTC -> nvmem(+RAM flush) -> fbdev -> 로터리 콜백 -> tick/타이머 정지
+ * -> 화면 지우기 -> workqueue 순서가 된다.
+ */
+
+static void ds_put_supplier(void *data)
 {
+    put_device(data);
+}
+
+/*
+ * dht11/rotary 장치 찾기: DT면 phandle 속성(prop), 아니면 board info의 이름.
+ * 둘 다 없으면 그 기능 없이 동작(NULL). 지정했는데 아직 probe 안 됐으면 -EPROBE_DEFER.
+ * 찾으면 device link로 묶어서 공급자가 먼저 내려갈 때 이 장치부터 unbind 된다.
+ */
+static struct device *ds_get_supplier(struct ds_oled *d, const char *prop, const char *name,
+                                      struct device *(*find)(struct device_node *, const char *))
+{
+    struct device_node *np = NULL;
+    struct device *sup;
     int ret;
-    struct ds_time t;
 
-    pr_info("=== ds1302_oled init (i2c=%d addr=0x%x) ===\n", i2c_bus, i2c_addr);
+    if (d->dev->of_node) {
+        np = of_parse_phandle(d->dev->of_node, prop, 0);
+        if (!np)
+            return NULL;
+        sup = find(np, NULL);
+        of_node_put(np);
+    } else {
+        if (!name || !*name)
+            return NULL;
+        sup = find(NULL, name);
+    }
+    if (!sup)
+        return ERR_PTR(-EPROBE_DEFER);
 
-    // 1) chrdev
-    ret = alloc_chrdev_region(&dev_num, 0, 1, DRIVER_NAME);
-    if (ret) return ret;
+    ret = devm_add_action_or_reset(d->dev, ds_put_supplier, sup);
+    if (ret)
+        return ERR_PTR(ret);
+    if (!device_link_add(d->dev, sup, DL_FLAG_AUTOREMOVE_CONSUMER))
+        return ERR_PTR(-EINVAL);
+    return sup;
+}
 
-    cdev_init(&ds_cdev, &fops);
-    ret = cdev_add(&ds_cdev, dev_num, 1);
-    if (ret) goto err_chr;
+static void ds_destroy_wq(void *data)
+{
+    destroy_workqueue(data);
+}
 
-    ds_class = class_create(THIS_MODULE, CLASS_NAME);
-    if (IS_ERR(ds_class)) {
-        ret = PTR_ERR(ds_class);
-        ds_class = NULL;
-        goto err_cdev;
-    }
+static void ds_panel_clear(void *data)
+{
+    oled_clear_sync(data);
+}
 
-    ds_dev = device_create(ds_class, NULL, dev_num, NULL, DRIVER_NAME);
-    if (IS_ERR(ds_dev)) {
-        ret = PTR_ERR(ds_dev);
-        ds_dev = NULL;
-        goto err_class;
-    }
+// 순서 중요: 플래그를 먼저 세우면 timer/align/kick이 더 이상 다시 걸지 않는다
+static void ds_stop(void *data)
+{
+    struct ds_oled *d = data;
+
+    WRITE_ONCE(d->ui_stopping, true);
+    // producer가 tick을 다시 걸 수 있으므로 producer부터
+    cancel_work_sync(&d->align_work);
+    hrtimer_cancel(&d->sec_timer);
+    cancel_delayed_work_sync(&d->dht_work);
+    if (d->dht)
+        dht11_cancel_async(d->dht, ds_dht_done, d);   // 걸어 둔 캡처의 콜백도 (ui_kick을 부름)
+    cancel_delayed_work_sync(&d->rtc_work);
+    cancel_delayed_work_sync(&d->tick_work);
+    hrtimer_cancel(&d->alarm_timer);   // 이중 안전장치: 보통은 ds_rtc_unhook에서 이미 멈춤
+}
+
+static void ds_unhook_rotary(void *data)
+{
+    struct ds_oled *d = data;
+
+    rotary_set_event_cb(d->rot, NULL, NULL);
+}
+
+/*
+ * 새 open을 막고, 열려 있는 파일은 gone을 보고 -ENODEV로 끝나게 한다.
+ * ds_lock 안에서 세우므로 이미 DS1302를 만지던 파일 경로는 여기서 끝까지 기다린다
+ * (이 뒤에 풀리는 devm 자원: GPIO, workqueue ...). 구조체는 마지막 close 때 ds_put에서.
+ */
+static void ds_cdev_remove(void *data)
+{
+    struct ds_oled *d = data;
+
+    mutex_lock(&ds_devs_lock);
+    ds_devs[d->id] = NULL;
+    mutex_unlock(&ds_devs_lock);
+
+    mutex_lock(&d->ds_lock);
+    d->gone = true;
+    mutex_unlock(&d->ds_lock);
+    wake_up_interruptible_all(&d->poll_wq);
 
-    // 2) GPIO for DS1302
-    ret = gpio_request(ds_ce_gpio, "ds1302_ce");
-    if (ret) goto err_dev;
-    ret = gpio_request(ds_clk_gpio, "ds1302_clk");
-    if (ret) goto err_gpio1;
-    ret = gpio_request(ds_dat_gpio, "ds1302_dat");
-    if (ret) goto err_gpio2;
+    device_destroy(ds_class, MKDEV(MAJOR(dev_num), d->id));
+    cdev_del(d->ds_cdev);
+    ida_free(&ds_ida, d->id);
+}
+
+/* 0번은 예전 이름(/dev/ds1302_oled), 나머지는 /dev/ds1302_oled.N */
+static int ds_cdev_add(struct ds_oled *d)
+{
+    dev_t devt;
+    int ret;
 
-    gpio_direction_output(ds_ce_gpio, 0);
-    gpio_direction_output(ds_clk_gpio, 0);
-    gpio_direction_output(ds_dat_gpio, 0);
+    d->id = ida_alloc_max(&ds_ida, DS_MAX_DEVS - 1, GFP_KERNEL);
+    if (d->id < 0)
+        return d->id;
+    devt = MKDEV(MAJOR(dev_num), d->id);
 
-    // 3) I2C client
-    ret = oled_i2c_create_client();
+    d->ds_cdev = cdev_alloc();
+    if (!d->ds_cdev) {
+        ret = -ENOMEM;
+        goto err_ida;
+    }
+    d->ds_cdev->owner = THIS_MODULE;
+    d->ds_cdev->ops = &fops;
+    ret = cdev_add(d->ds_cdev, devt, 1);
     if (ret) {
-        pr_err("cannot create I2C client (bus=%d addr=0x%x)\n", i2c_bus, i2c_addr);
-        goto err_gpio3;
+        kobject_put(&d->ds_cdev->kobj);
+        goto err_ida;
     }
 
-    // 4) OLED init + clear
-    ret = oled_init();
-    if (ret) {
-        pr_err("oled_init failed: %d\n", ret);
-        goto err_i2c;
+    if (d->id == 0)
+        d->ds_dev = device_create_with_groups(ds_class, d->dev, devt, d,
+                                              ds_groups, DRIVER_NAME);
+    else
+        d->ds_dev = device_create_with_groups(ds_class, d->dev, devt, d,
+                                              ds_groups, DRIVER_NAME ".%d", d->id);
+    if (IS_ERR(d->ds_dev)) {
+        ret = PTR_ERR(d->ds_dev);
+        goto err_cdev;
     }
-    fb_clear();
-    oled_flush();
+    mutex_lock(&ds_devs_lock);
+    ds_devs[d->id] = d;
+    mutex_unlock(&ds_devs_lock);
+    return devm_add_action_or_reset(d->dev, ds_cdev_remove, d);
+
+err_cdev:
+    cdev_del(d->ds_cdev);
+err_ida:
+    ida_free(&ds_ida, d->id);
+    return ret;
+}
+
+static int ds1302_oled_probe(struct i2c_client *client)
+{
+    struct device *dev = &client->dev;
+    struct ds_oled_pdata *pdata = dev_get_platdata(dev);
+    struct ds_oled *d;
+    struct ds_time t;
+    int ret;
+
+    d = kzalloc(sizeof(*d), GFP_KERNEL);
+    if (!d)
+        return -ENOMEM;
+    kref_init(&d->ref);
+    // 제일 먼저 건 devm 액션이라 제일 나중에 풀린다. 열린 파일이 있으면 마지막 close까지 남음
+    ret = devm_add_action_or_reset(dev, ds_put, d);
+    if (ret)
+        return ret;
+    d->dev = dev;
+    d->oled_i2c = client;
+    i2c_set_clientdata(client, d);
+
+    mutex_init(&d->ds_lock);
+    mutex_init(&d->render_lock);
+    spin_lock_init(&d->fb_lock);
+    spin_lock_init(&d->sense_lock);
+    d->fb_back  = &d->oled_fbs[0];
+    d->fb_front = &d->oled_fbs[1];
+    d->oled_chunk = 16;
+    d->temp_cache = -1;
+    d->humi_cache = -1;
+    d->ui_dirty = true;
+    d->mode = UI_NORMAL;
+    d->field = FLD_HOUR;
+    d->blink_on = true;
+    atomic_set(&d->fb_users, 0);
+    atomic64_set(&d->kick_ns, 0);
+    init_waitqueue_head(&d->poll_wq);
+    atomic_set(&d->poll_seq, 0);
+    ds_hist_init(&d->h_tick, "us");
+    ds_hist_init(&d->h_render, "us");
+    ds_hist_init(&d->h_flush, "us");
+    ds_hist_init(&d->h_flush_bytes, "bytes");
+    d->dbg_reset_kt = ktime_get();
+    INIT_WORK(&d->oled_flush_work, flush_fn);
+    INIT_DELAYED_WORK(&d->tick_work, tick_fn);
+    INIT_DELAYED_WORK(&d->dht_work, dht_work_fn);
+    INIT_DELAYED_WORK(&d->rtc_work, rtc_work_fn);
+    INIT_WORK(&d->align_work, ds_align_fn);
+    INIT_DELAYED_WORK(&d->ram_flush_work, ram_flush_fn);
+    hrtimer_init(&d->sec_timer, CLOCK_BOOTTIME, HRTIMER_MODE_ABS);
+    d->sec_timer.function = sec_timer_fn;
+    hrtimer_init(&d->alarm_timer, CLOCK_BOOTTIME, HRTIMER_MODE_ABS);
+    d->alarm_timer.function = alarm_timer_fn;
+
+    // 1) DS1302 GPIO
+    ret = ds1302_gpio_setup(d, pdata);
+    if (ret)
+        return dev_err_probe(dev, ret, "ds1302 gpios\n");
+
+    // 2) dht11 / rotary (없으면 온습도는 "--", 시간 설정은 /dev 또는 RTC로만)
+    d->dht = ds_get_supplier(d, "dht11", pdata ? pdata->dht11 : NULL, dht11_find_device);
+    if (IS_ERR(d->dht))
+        return dev_err_probe(dev, PTR_ERR(d->dht), "dht11 not ready\n");
+    d->rot = ds_get_supplier(d, "rotary", pdata ? pdata->rotary : NULL, rotary_find_device);
+    if (IS_ERR(d->rot))
+        return dev_err_probe(dev, PTR_ERR(d->rot), "rotary not ready\n");
+
+    // 3) flush worker
+    d->oled_wq = alloc_ordered_workqueue("ds1302_oled_flush.%s", WQ_HIGHPRI, dev_name(dev));
+    if (!d->oled_wq)
+        return -ENOMEM;
+    ret = devm_add_action_or_reset(dev, ds_destroy_wq, d->oled_wq);
+    if (ret)
+        return ret;
+
+    // 센서 producer: 오래 기다리는 일이라 unbound (tick과 같은 CPU를 붙잡지 않게)
+    d->sense_wq = alloc_workqueue("ds1302_oled_sense.%s", WQ_UNBOUND, 0, dev_name(dev));
+    if (!d->sense_wq)
+        return -ENOMEM;
+    ret = devm_add_action_or_reset(dev, ds_destroy_wq, d->sense_wq);
+    if (ret)
+        return ret;
+
+    // 4) OLED init + clear
+    ret = oled_xfer_setup(d);
+    if (ret)
+        return ret;
+    ret = oled_init(d);
+    if (ret)
+        return dev_err_probe(dev, ret, "oled_init failed\n");
+    oled_clear_sync(d);
+    ret = devm_add_action_or_reset(dev, ds_panel_clear, d);
+    if (ret)
+        return ret;
 
-    // 5) (optional) init datetime set
-    if (init_datetime && strlen(init_datetime) == 14) {
+    // 5) (optional) init datetime set: 모듈 파라미터로 만든 기본 인스턴스에만
+    if (pdata && init_datetime && strlen(init_datetime) == 14) {
         ret = parse_datetime_14(init_datetime, &t);
         if (!ret) {
-            mutex_lock(&ds_lock);
-            ds1302_set_datetime(&t);
-            mutex_unlock(&ds_lock);
-            pr_info("init_datetime applied: %s\n", init_datetime);
+            mutex_lock(&d->ds_lock);
+            ds1302_set_datetime(d, &t);
+            mutex_unlock(&d->ds_lock);
+            dev_info(dev, "init_datetime applied: %s\n", init_datetime);
         } else {
-            pr_err("init_datetime invalid: %s\n", init_datetime);
+            dev_err(dev, "init_datetime invalid: %s\n", init_datetime);
         }
     }
-    last_sense_j = jiffies - msecs_to_jiffies(SENSE_TICK_MS);
+    d->ui_stat_j = jiffies;
+
+    ret = devm_add_action_or_reset(dev, ds_stop, d);
+    if (ret)
+        return ret;
+
+    if (d->rot) {
+        rotary_set_event_cb(d->rot, ui_kick_cb, d);
+        ret = devm_add_action_or_reset(dev, ds_unhook_rotary, d);
+        if (ret)
+            return ret;
+    }
+
+    if (fbdev) {
+        // 없어도 시계는 동작하므로 실패해도 계속
+        ret = oled_fb_register(d);
+        if (ret)
+            dev_err(dev, "fbdev register failed: %d\n", ret);
+    }
+    if (nvram) {
+        ret = ds_nvram_register(d);
+        if (ret)
+            dev_err(dev, "nvmem register failed: %d\n", ret);
+    }
+    if (rtc_class) {
+        // 없어도 /dev/ds1302_oled로 쓸 수 있으므로 실패해도 계속
+        ret = ds_rtc_register(d);
+        if (ret)
+            dev_err(dev, "rtc register failed: %d\n", ret);
+    }
+
+    // 6) /dev/ds1302_oled[.N] + sysfs 통계
+    ret = ds_cdev_add(d);
+    if (ret)
+        return ret;
+    ret = ds_debugfs_add(d);
+    if (ret)
+        return ret;
 
-    // 6) start tick
-    INIT_DELAYED_WORK(&tick_work, tick_fn);
-    schedule_delayed_work(&tick_work, HZ);
+    // 7) start producers + tick (producer가 첫 값을 올리면 tick이 깨어난다)
+    if (d->dht)
+        queue_delayed_work(d->sense_wq, &d->dht_work, 0);
+    queue_delayed_work(d->sense_wq, &d->rtc_work, 0);
+    schedule_delayed_work(&d->tick_work, HZ);
 
-    pr_info("ds1302_oled started: /dev/%s\n", DRIVER_NAME);
+    dev_info(dev, "started: /dev/%s\n", dev_name(d->ds_dev));
     return 0;
+}
 
-err_i2c:
-    oled_i2c_destroy_client();
-err_gpio3:
-    gpio_free(ds_dat_gpio);
-err_gpio2:
-    gpio_free(ds_clk_gpio);
-err_gpio1:
-    gpio_free(ds_ce_gpio);
-err_dev:
-    if (ds_dev) { device_destroy(ds_class, dev_num); ds_dev = NULL; }
-err_class:
-    if (ds_class) { class_destroy(ds_class); ds_class = NULL; }
-err_cdev:
-    cdev_del(&ds_cdev);
-err_chr:
-    unregister_chrdev_region(dev_num, 1);
-    return ret;
+static const struct i2c_device_id ds1302_oled_id[] = {
+    { DRIVER_NAME, 0 },
+    { }
+};
+MODULE_DEVICE_TABLE(i2c, ds1302_oled_id);
+
+static const struct of_device_id ds1302_oled_of_match[] = {
+    { .compatible = "kkk,ds1302-oled" },
+    { }
+};
+MODULE_DEVICE_TABLE(of, ds1302_oled_of_match);
+
+static struct i2c_driver ds1302_oled_driver = {
+    .driver = {
+        .name           = DRIVER_NAME,
+        .of_match_table = ds1302_oled_of_match,
+    },
+    .probe_new = ds1302_oled_probe,
+    .id_table  = ds1302_oled_id,
+};
+
+// -------------------- module init/exit --------------------
+/* DT 없이 쓰던 예전 구성: i2c_bus/i2c_addr + ds_*_gpio 파라미터로 기본 인스턴스 하나 */
+static int ds_legacy_create(void)
+{
+    static struct ds_oled_pdata pdata;
+    struct i2c_board_info info = { I2C_BOARD_INFO(DRIVER_NAME, 0) };
+    struct i2c_adapter *adap;
+
+    pdata.ce_gpio  = ds_ce_gpio;
+    pdata.clk_gpio = ds_clk_gpio;
+    pdata.dat_gpio = ds_dat_gpio;
+    pdata.dht11    = dht11_dev;
+    pdata.rotary   = rotary_dev;
+    info.addr = i2c_addr;
+    info.platform_data = &pdata;
+
+    adap = i2c_get_adapter(i2c_bus);
+    if (!adap)
+        return -ENODEV;
+    ds_legacy = i2c_new_client_device(adap, &info);
+    i2c_put_adapter(adap);
+    if (IS_ERR(ds_legacy)) {
+        int ret = PTR_ERR(ds_legacy);
+
+        ds_legacy = NULL;
+        return ret;
+    }
+    return 0;
 }
 
-static void __exit ds1302_oled_exit(void)
+static int __init ds1302_oled_init(void)
 {
-    cancel_delayed_work_sync(&tick_work);
+    int ret;
+
+    pr_info("=== ds1302_oled init (i2c=%d addr=0x%x) ===\n", i2c_bus, i2c_addr);
+
+    // 1) chrdev (인스턴스마다 minor 하나)
+    ret = alloc_chrdev_region(&dev_num, 0, DS_MAX_DEVS, DRIVER_NAME);
+    if (ret) return ret;
 
-    fb_clear();
-    oled_flush();
+    ds_class = class_create(THIS_MODULE, CLASS_NAME);
+    if (IS_ERR(ds_class)) {
+        ret = PTR_ERR(ds_class);
+        goto err_chr;
+    }
 
-    oled_i2c_destroy_client();
+    // 2) 큰 시계 글리프는 모든 인스턴스가 같이 쓰므로 여기서 한 번
+    clock_scale = clamp(clock_scale, 1, BIG_MAX_SCALE);
+    if (clock_scale > 1)
+        big_font_build(clock_scale);
 
-    gpio_free(ds_dat_gpio);
-    gpio_free(ds_clk_gpio);
-    gpio_free(ds_ce_gpio);
+    // 3) 드라이버 등록 -> DT 노드마다 probe (debugfs 디렉터리는 인스턴스마다 그 아래)
+    ds_debugfs_root = debugfs_create_dir(DRIVER_NAME, NULL);
+    ret = i2c_add_driver(&ds1302_oled_driver);
+    if (ret)
+        goto err_debugfs;
+
+    // 4) 예전 구성
+    if (i2c_bus >= 0) {
+        ret = ds_legacy_create();
+        if (ret) {
+            pr_err("cannot create I2C client (bus=%d addr=0x%x)\n", i2c_bus, i2c_addr);
+            goto err_drv;
+        }
+    }
+    return 0;
 
-    if (ds_dev) { device_destroy(ds_class, dev_num); ds_dev = NULL; }
-    if (ds_class) { class_destroy(ds_class); ds_class = NULL; }
+err_drv:
+    i2c_del_driver(&ds1302_oled_driver);
+err_debugfs:
+    debugfs_remove_recursive(ds_debugfs_root);
+    class_destroy(ds_class);
+err_chr:
+    unregister_chrdev_region(dev_num, DS_MAX_DEVS);
+    return ret;
+}
 
-    cdev_del(&ds_cdev);
-    unregister_chrdev_region(dev_num, 1);
+static void __exit ds1302_oled_exit(void)
+{
+    i2c_unregister_device(ds_legacy);
+    i2c_del_driver(&ds1302_oled_driver);
+    debugfs_remove_recursive(ds_debugfs_root);
+    class_destroy(ds_class);
+    unregister_chrdev_region(dev_num, DS_MAX_DEVS);
 
     pr_info("ds1302_oled exit\n");
 }
 
 module_init(ds1302_oled_init);
 module_exit(ds1302_oled_exit);
+
+#ifdef KKK_KUNIT_TEST
+#include "ds1302_oled_test.c"
+#endif
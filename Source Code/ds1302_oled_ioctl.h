@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: GPL-2.0 WITH Linux-syscall-note */
+/*
+ * /dev/ds1302_oled[.N] 바이너리 ioctl (커널 모듈과 user space가 같이 include)
+ *
+ * 시간은 DS1302에 들어 있는 그대로 (RTC class와 같은 기준, 보통 UTC).
+ * 읽기는 모두 드라이버 시간 캐시에서 오고, 쓰기는 바뀐 레지스터만 쓴다.
+ */
+#ifndef DS1302_OLED_IOCTL_H
+#define DS1302_OLED_IOCTL_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+struct ds1302_time {
+    __u16 year;     // 2000..2099
+    __u8  mon;      // 1..12
+    __u8  mday;     // 1..31 (그 달의 날수까지)
+    __u8  hour;     // 0..23
+    __u8  min;      // 0..59
+    __u8  sec;      // 0..59
+    __u8  wday;     // 1..7, 1 = 일요일. 쓸 때 0이면 날짜에서 계산
+};
+
+/* 필드 비트 (DS1302 시계 레지스터 순서) */
+#define DS1302_F_SEC   (1u << 0)
+#define DS1302_F_MIN   (1u << 1)
+#define DS1302_F_HOUR  (1u << 2)
+#define DS1302_F_MDAY  (1u << 3)
+#define DS1302_F_MON   (1u << 4)
+#define DS1302_F_WDAY  (1u << 5)
+#define DS1302_F_YEAR  (1u << 6)
+#define DS1302_F_ALL   0x7fu
+
+/*
+ * compare-and-set: 현재 시간의 check 필드가 expect와 모두 같을 때만
+ * mask 필드를 set 값으로 바꾼다 (나머지 필드는 그대로 흐름). 판단과 쓰기는 락 하나 안에서.
+ * 성공/실패 모두 cur에 판단에 쓴 현재 시간(성공이면 바꾼 뒤 값)을 돌려준다.
+ * 조건이 안 맞으면 -EBUSY, 바꾼 결과가 유효한 날짜가 아니면 -EINVAL.
+ */
+struct ds1302_cas {
+    __u32 check;
+    __u32 mask;
+    struct ds1302_time expect;
+    struct ds1302_time set;
+    struct ds1302_time cur;     // out
+};
+
+#define DS1302_IOC_MAGIC  'D'
+
+#define DS1302_IOC_GET_TIME   _IOR(DS1302_IOC_MAGIC, 1, struct ds1302_time)
+#define DS1302_IOC_SET_TIME   _IOW(DS1302_IOC_MAGIC, 2, struct ds1302_time)
+#define DS1302_IOC_GET_EPOCH  _IOR(DS1302_IOC_MAGIC, 3, __s64)  // 1970-01-01 기준 초
+#define DS1302_IOC_SET_EPOCH  _IOW(DS1302_IOC_MAGIC, 4, __s64)
+#define DS1302_IOC_CAS_FIELDS _IOWR(DS1302_IOC_MAGIC, 5, struct ds1302_cas)
+
+#endif /* DS1302_OLED_IOCTL_H */
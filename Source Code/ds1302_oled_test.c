@@ -0,0 +1,290 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * ds1302_oled KUnit 테스트 (ds1302_oled.c 끝에서 include, make KUNIT=1)
+ * 버스/GPIO 없이 도는 부분만: 날짜 계산, 편집, 파싱, blink 마스크, fb_draw_* 렌더러.
+ * 벤치마크는 kunit_info로 ns/op를 찍는다.
+ *
+ * clock_scale과 큰 글리프 표는 모듈 전역이라 테스트 중에 바꿨다가 되돌린다.
+ * 인스턴스가 없을 때 돌릴 것 (insmod ds1302_oled.ko i2c_bus=-1, DT 노드 없음).
+ */
+#include <kunit/test.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+
+#define DS_BENCH_FRAMES 10000
+#define DS_BENCH_PARSE  100000
+
+static struct ds_time ds_test_time(int year4, int mon, int mday, int hour, int min, int sec)
+{
+    struct ds_time t = {
+        .year = year4 - 2000, .mon = mon, .mday = mday,
+        .hour = hour, .min = min, .sec = sec,
+    };
+
+    t.wday = ds_time_wday(&t);
+    return t;
+}
+
+static void ds_set_clock_scale(int scale)
+{
+    clock_scale = scale;
+    if (scale > 1)
+        big_font_build(scale);
+}
+
+static void ds_test_days_in_month(struct kunit *test)
+{
+    KUNIT_EXPECT_EQ(test, days_in_month(2023, 1), 31);
+    KUNIT_EXPECT_EQ(test, days_in_month(2023, 2), 28);
+    KUNIT_EXPECT_EQ(test, days_in_month(2024, 2), 29);
+    KUNIT_EXPECT_EQ(test, days_in_month(2000, 2), 29);
+    KUNIT_EXPECT_EQ(test, days_in_month(2023, 4), 30);
+    KUNIT_EXPECT_EQ(test, days_in_month(2023, 12), 31);
+}
+
+static void ds_test_edit_add(struct kunit *test)
+{
+    struct ds_time t = ds_test_time(2024, 1, 31, 23, 59, 59);
+
+    // 시/분/초는 범위 안에서 돈다
+    edit_add(&t, FLD_SEC, +1);
+    KUNIT_EXPECT_EQ(test, t.sec, 0);
+    edit_add(&t, FLD_SEC, -1);
+    KUNIT_EXPECT_EQ(test, t.sec, 59);
+    edit_add(&t, FLD_MIN, +1);
+    KUNIT_EXPECT_EQ(test, t.min, 0);
+    edit_add(&t, FLD_HOUR, +1);
+    KUNIT_EXPECT_EQ(test, t.hour, 0);
+    edit_add(&t, FLD_HOUR, -1);
+    KUNIT_EXPECT_EQ(test, t.hour, 23);
+    // 자리 올림은 없다
+    KUNIT_EXPECT_EQ(test, t.mday, 31);
+
+    // 1/31 -> 2월: 그 달 마지막 날로 당겨짐
+    edit_add(&t, FLD_MON, +1);
+    KUNIT_EXPECT_EQ(test, t.mon, 2);
+    KUNIT_EXPECT_EQ(test, t.mday, 29);
+    // 윤년 2/29 -> 2025: 28로
+    edit_add(&t, FLD_YEAR, +1);
+    KUNIT_EXPECT_EQ(test, t.year, 25);
+    KUNIT_EXPECT_EQ(test, t.mday, 28);
+
+    edit_add(&t, FLD_MDAY, +1);
+    KUNIT_EXPECT_EQ(test, t.mday, 1);
+    edit_add(&t, FLD_MDAY, -1);
+    KUNIT_EXPECT_EQ(test, t.mday, 28);
+
+    t.mon = 12;
+    edit_add(&t, FLD_MON, +1);
+    KUNIT_EXPECT_EQ(test, t.mon, 1);
+    edit_add(&t, FLD_MON, -1);
+    KUNIT_EXPECT_EQ(test, t.mon, 12);
+
+    // 연도는 2000..2099에서 멈춘다
+    t.year = 99;
+    edit_add(&t, FLD_YEAR, +1);
+    KUNIT_EXPECT_EQ(test, t.year, 99);
+    t.year = 0;
+    edit_add(&t, FLD_YEAR, -1);
+    KUNIT_EXPECT_EQ(test, t.year, 0);
+}
+
+static void ds_test_parse_datetime(struct kunit *test)
+{
+    struct ds_time t;
+
+    KUNIT_ASSERT_EQ(test, parse_datetime_14("20251217174005", &t), 0);
+    KUNIT_EXPECT_EQ(test, t.year, 25);
+    KUNIT_EXPECT_EQ(test, t.mon, 12);
+    KUNIT_EXPECT_EQ(test, t.mday, 17);
+    KUNIT_EXPECT_EQ(test, t.hour, 17);
+    KUNIT_EXPECT_EQ(test, t.min, 40);
+    KUNIT_EXPECT_EQ(test, t.sec, 5);
+    KUNIT_EXPECT_EQ(test, t.wday, 4);               // 수요일 (1 = 일요일)
+
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20000101000000", &t), 0);
+    KUNIT_EXPECT_EQ(test, t.wday, 7);               // 토요일
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20991231235959", &t), 0);
+    KUNIT_EXPECT_EQ(test, t.wday, 5);               // 목요일
+
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("2025121717400x", &t), -EINVAL);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("2025-12-17 174", &t), -EINVAL);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("19991231235959", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("21000101000000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20251317000000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20251200000000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20250229000000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20240229000000", &t), 0);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20251217240000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20251217236000", &t), -ERANGE);
+    KUNIT_EXPECT_EQ(test, parse_datetime_14("20251217235960", &t), -ERANGE);
+}
+
+static void ds_test_blink_mask(struct kunit *test)
+{
+    static const struct {
+        enum set_field field;
+        const char *dt, *tm;
+    } cases[] = {
+        { FLD_YEAR, "    -12-17", "17:40:05" },
+        { FLD_MON,  "2025-  -17", "17:40:05" },
+        { FLD_MDAY, "2025-12-  ", "17:40:05" },
+        { FLD_HOUR, "2025-12-17", "  :40:05" },
+        { FLD_MIN,  "2025-12-17", "17:  :05" },
+        { FLD_SEC,  "2025-12-17", "17:40:  " },
+    };
+    char dt[16], tm[16];
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(cases); i++) {
+        strscpy(dt, "2025-12-17", sizeof(dt));
+        strscpy(tm, "17:40:05", sizeof(tm));
+        apply_blink_mask(dt, tm, cases[i].field, false);
+        KUNIT_EXPECT_STREQ(test, dt, cases[i].dt);
+        KUNIT_EXPECT_STREQ(test, tm, cases[i].tm);
+
+        // blink_on이면 그대로
+        strscpy(dt, "2025-12-17", sizeof(dt));
+        strscpy(tm, "17:40:05", sizeof(tm));
+        apply_blink_mask(dt, tm, cases[i].field, true);
+        KUNIT_EXPECT_STREQ(test, dt, "2025-12-17");
+        KUNIT_EXPECT_STREQ(test, tm, "17:40:05");
+    }
+}
+
+static void ds_test_draw_str(struct kunit *test)
+{
+    struct oled_fb *f = kunit_kzalloc(test, sizeof(*f), GFP_KERNEL);
+    int page;
+
+    KUNIT_ASSERT_NOT_ERR_OR_NULL(test, f);
+
+    fb_draw_str6x8(f, 10, 2, "AB");
+    KUNIT_EXPECT_EQ(test, memcmp(&f->px[2 * OLED_W + 10], font6x8_glyph('A'), 6), 0);
+    KUNIT_EXPECT_EQ(test, memcmp(&f->px[2 * OLED_W + 16], font6x8_glyph('B'), 6), 0);
+    KUNIT_EXPECT_EQ(test, f->ink[2].lo, 10);
+    KUNIT_EXPECT_EQ(test, f->ink[2].hi, 22);
+    KUNIT_EXPECT_EQ(test, f->dirty[2].lo, 10);
+    KUNIT_EXPECT_EQ(test, f->dirty[2].hi, 22);
+    for (page = 0; page < OLED_PAGES; page++)
+        if (page != 2)
+            KUNIT_EXPECT_TRUE(test, span_empty(&f->ink[page]));
+
+    // 인쇄 불가 문자는 '?'
+    fb_draw_char6x8(f, 0, 0, '\x01');
+    KUNIT_EXPECT_EQ(test, memcmp(&f->px[0], font6x8_glyph('?'), 6), 0);
+
+    // 오른쪽 끝: 다 안 들어가는 글자는 안 그림
+    fb_draw_str6x8(f, OLED_W - 8, 7, "XY");
+    KUNIT_EXPECT_EQ(test, f->ink[7].lo, OLED_W - 8);
+    KUNIT_EXPECT_EQ(test, f->ink[7].hi, OLED_W - 2);
+    fb_draw_char6x8(f, OLED_W - 5, 6, 'Z');
+    KUNIT_EXPECT_TRUE(test, span_empty(&f->ink[6]));
+
+    // 지우면 ink는 비고, 지운 자리는 dirty로 남는다
+    span_reset(&f->dirty[2]);
+    fb_clear(f);
+    KUNIT_EXPECT_TRUE(test, span_empty(&f->ink[2]));
+    KUNIT_EXPECT_EQ(test, f->dirty[2].lo, 10);
+    KUNIT_EXPECT_EQ(test, f->dirty[2].hi, 22);
+    KUNIT_EXPECT_TRUE(test, !memchr_inv(f->px, 0, sizeof(f->px)));
+}
+
+/* 시계는 배율마다 128 안에 들어가고 clock_scale 페이지만 쓴다 */
+static void ds_test_draw_clock(struct kunit *test)
+{
+    struct oled_fb *f = kunit_kzalloc(test, sizeof(*f), GFP_KERNEL);
+    int saved = clock_scale;
+    int scale, page;
+
+    KUNIT_ASSERT_NOT_ERR_OR_NULL(test, f);
+
+    for (scale = 1; scale <= BIG_MAX_SCALE; scale++) {
+        ds_set_clock_scale(scale);
+        fb_clear(f);
+        fb_draw_clock(f, 4, "23:59:59");
+
+        for (page = 0; page < OLED_PAGES; page++) {
+            bool used = page >= 4 && page < 4 + scale;
+
+            KUNIT_EXPECT_EQ_MSG(test, !span_empty(&f->ink[page]), used,
+                                "scale %d page %d", scale, page);
+            if (used)
+                KUNIT_EXPECT_LE(test, f->ink[page].hi, OLED_W);
+        }
+        // 2x는 HH:MM:SS 전부 큰 글씨 (6*2*6 + 4*2*2 = 88)
+        if (scale == 2)
+            KUNIT_EXPECT_EQ(test, f->ink[4].hi, 88);
+    }
+    ds_set_clock_scale(saved);
+}
+
+/* 화면 한 장(ui_draw) ns/op: NORMAL은 배율별, SET은 6x8만 */
+static void ds_bench_render(struct kunit *test)
+{
+    struct oled_fb *f = kunit_kzalloc(test, sizeof(*f), GFP_KERNEL);
+    int saved = clock_scale;
+    char tm[16];
+    int scale, i;
+    u64 t0, ns;
+
+    KUNIT_ASSERT_NOT_ERR_OR_NULL(test, f);
+
+    for (scale = 1; scale <= BIG_MAX_SCALE; scale++) {
+        ds_set_clock_scale(scale);
+        t0 = ktime_get_ns();
+        for (i = 0; i < DS_BENCH_FRAMES; i++) {
+            snprintf(tm, sizeof(tm), "%02d:%02d:%02d", (i / 3600) % 24, (i / 60) % 60, i % 60);
+            ui_draw(f, false, "T25C H60%", "2025-12-17", tm);
+        }
+        ns = ktime_get_ns() - t0;
+        kunit_info(test, "render NORMAL x%d: %llu ns/frame\n", scale, div_u64(ns, DS_BENCH_FRAMES));
+    }
+    ds_set_clock_scale(saved);
+
+    t0 = ktime_get_ns();
+    for (i = 0; i < DS_BENCH_FRAMES; i++)
+        ui_draw(f, true, "T25C H60%", "2025-12-17", (i & 1) ? "17:40:05" : "  :40:05");
+    ns = ktime_get_ns() - t0;
+    kunit_info(test, "render SET: %llu ns/frame\n", div_u64(ns, DS_BENCH_FRAMES));
+
+    KUNIT_EXPECT_FALSE(test, span_empty(&f->ink[0]));
+}
+
+static void ds_bench_parse(struct kunit *test)
+{
+    struct ds_time t;
+    char s[16];
+    int i, bad = 0;
+    u64 t0, ns;
+
+    strscpy(s, "20251217000000", sizeof(s));
+    t0 = ktime_get_ns();
+    for (i = 0; i < DS_BENCH_PARSE; i++) {
+        s[12] = '0' + (i / 10) % 6;
+        s[13] = '0' + i % 10;
+        bad += parse_datetime_14(s, &t) != 0;
+    }
+    ns = ktime_get_ns() - t0;
+
+    KUNIT_EXPECT_EQ(test, bad, 0);
+    kunit_info(test, "parse_datetime_14: %llu ns/op\n", div_u64(ns, DS_BENCH_PARSE));
+}
+
+static struct kunit_case ds1302_oled_test_cases[] = {
+    KUNIT_CASE(ds_test_days_in_month),
+    KUNIT_CASE(ds_test_edit_add),
+    KUNIT_CASE(ds_test_parse_datetime),
+    KUNIT_CASE(ds_test_blink_mask),
+    KUNIT_CASE(ds_test_draw_str),
+    KUNIT_CASE(ds_test_draw_clock),
+    KUNIT_CASE(ds_bench_render),
+    KUNIT_CASE(ds_bench_parse),
+    {}
+};
+
+static struct kunit_suite ds1302_oled_test_suite = {
+    .name = "ds1302_oled",
+    .test_cases = ds1302_oled_test_cases,
+};
+kunit_test_suite(ds1302_oled_test_suite);
@@ -0,0 +1,96 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * ds1302_oled tracepoints (/sys/kernel/tracing/events/ds1302_oled/)
+ * 시간 재는 ktime_get은 해당 이벤트가 켜져 있을 때만 한다.
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM ds1302_oled
+
+#if !defined(_DS1302_OLED_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _DS1302_OLED_TRACE_H
+
+#include <linux/tracepoint.h>
+#include <linux/device.h>
+
+/*
+ * DS1302 burst 한 번 (CE 한 번): cmd는 0xBF clock read, 0xBE clock write,
+ * 0xFF RAM read, 0xFE RAM write. len은 데이터 바이트 수 (명령 바이트 제외)
+ */
+TRACE_EVENT(ds1302_burst,
+    TP_PROTO(struct device *dev, u8 cmd, unsigned int len, u64 ns),
+    TP_ARGS(dev, cmd, len, ns),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(u8, cmd)
+        __field(unsigned int, len)
+        __field(u64, ns)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->cmd = cmd;
+        __entry->len = len;
+        __entry->ns = ns;
+    ),
+    TP_printk("%s cmd=0x%02x len=%u %lluns", __get_str(dev),
+              __entry->cmd, __entry->len, __entry->ns)
+);
+
+/* 바뀐 시계 레지스터만 단일 쓰기 (mask = BIT(DS_REG_x), WP off/on 포함 시간) */
+TRACE_EVENT(ds1302_write_regs,
+    TP_PROTO(struct device *dev, unsigned int mask, u64 ns),
+    TP_ARGS(dev, mask, ns),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(unsigned int, mask)
+        __field(u64, ns)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->mask = mask;
+        __entry->ns = ns;
+    ),
+    TP_printk("%s mask=0x%02x %lluns", __get_str(dev), __entry->mask, __entry->ns)
+);
+
+/* flush worker가 프레임 하나를 보내기 시작 (full = shadow를 몰라서 전체 전송) */
+TRACE_EVENT(oled_flush_begin,
+    TP_PROTO(struct device *dev, bool full),
+    TP_ARGS(dev, full),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(bool, full)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->full = full;
+    ),
+    TP_printk("%s full=%d", __get_str(dev), __entry->full)
+);
+
+/* 프레임 하나 끝: 윈도우 수, 보낸 픽셀 데이터 바이트 (명령/헤더 제외) */
+TRACE_EVENT(oled_flush_end,
+    TP_PROTO(struct device *dev, unsigned int windows, unsigned int bytes, int ret),
+    TP_ARGS(dev, windows, bytes, ret),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(unsigned int, windows)
+        __field(unsigned int, bytes)
+        __field(int, ret)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->windows = windows;
+        __entry->bytes = bytes;
+        __entry->ret = ret;
+    ),
+    TP_printk("%s windows=%u bytes=%u ret=%d", __get_str(dev),
+              __entry->windows, __entry->bytes, __entry->ret)
+);
+
+#endif /* _DS1302_OLED_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE ds1302_oled_trace
+#include <trace/define_trace.h>
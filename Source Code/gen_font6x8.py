@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# gen_font6x8.py  (BDF -> SSD1306 page-format glyph table)
+#
+# usage: gen_font6x8.py font6x8.bdf > font6x8.h
+#
+# BDF 비트맵(행 단위, MSB가 왼쪽)을 SSD1306 페이지 형식(컬럼 단위, LSB가 위)으로
+# 돌려서 문자 코드로 바로 인덱싱하는 테이블을 만든다.
+# 글리프 BBX가 셀보다 작아도 FONT_ASCENT 기준으로 셀 안에 제자리에 놓는다.
+import sys
+
+FIRST, LAST = 0x20, 0x7E
+CELL_W, CELL_H = 6, 8
+
+
+def die(msg):
+    sys.stderr.write("gen_font6x8: %s\n" % msg)
+    sys.exit(1)
+
+
+def parse_bdf(path):
+    ascent = None
+    glyphs = {}
+    cur = None
+    in_bitmap = False
+
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            tok = line.split()
+            if not tok:
+                continue
+            key = tok[0]
+
+            if in_bitmap:
+                if key == "ENDCHAR":
+                    in_bitmap = False
+                    if cur["enc"] is not None:
+                        glyphs[cur["enc"]] = cur
+                    cur = None
+                else:
+                    cur["rows"].append(int(key, 16))
+                continue
+
+            if key == "FONT_ASCENT":
+                ascent = int(tok[1])
+            elif key == "STARTCHAR":
+                cur = {"name": " ".join(tok[1:]), "enc": None, "bbx": None, "rows": []}
+            elif key == "ENCODING":
+                cur["enc"] = int(tok[1])
+            elif key == "BBX":
+                cur["bbx"] = tuple(int(v) for v in tok[1:5])
+            elif key == "BITMAP":
+                if cur is None or cur["bbx"] is None:
+                    die("%s:%d: BITMAP without STARTCHAR/BBX" % (path, lineno))
+                in_bitmap = True
+
+    if ascent is None:
+        die("%s: missing FONT_ASCENT" % path)
+    return ascent, glyphs
+
+
+def to_columns(g, ascent):
+    w, h, xoff, yoff = g["bbx"]
+    row_bits = ((w + 7) // 8) * 8
+    top = ascent - (yoff + h)        # 셀 맨 위에서 글리프 첫 행까지
+    cols = [0] * CELL_W
+
+    if len(g["rows"]) != h:
+        die("glyph %r: %d rows, BBX says %d" % (g["name"], len(g["rows"]), h))
+
+    for j, bits in enumerate(g["rows"]):
+        y = top + j
+        for i in range(w):
+            if not (bits >> (row_bits - 1 - i)) & 1:
+                continue
+            x = xoff + i
+            if not (0 <= x < CELL_W and 0 <= y < CELL_H):
+                die("glyph %r: pixel (%d,%d) outside %dx%d cell"
+                    % (g["name"], x, y, CELL_W, CELL_H))
+            cols[x] |= 1 << y
+    return cols
+
+
+def main():
+    if len(sys.argv) != 2:
+        die("usage: gen_font6x8.py font.bdf > font6x8.h")
+
+    ascent, glyphs = parse_bdf(sys.argv[1])
+
+    missing = [c for c in range(FIRST, LAST + 1) if c not in glyphs]
+    if missing:
+        die("missing glyphs: %s" % " ".join("0x%02X" % c for c in missing))
+
+    out = sys.stdout
+    out.write("/* 자동 생성 파일: gen_font6x8.py %s -- 직접 고치지 말고 BDF를 고칠 것 */\n"
+              % sys.argv[1].split("/")[-1])
+    out.write("#define FONT6X8_FIRST 0x%02X\n" % FIRST)
+    out.write("#define FONT6X8_COUNT %d\n\n" % (LAST - FIRST + 1))
+    out.write("static const u8 font6x8[FONT6X8_COUNT][%d] = {\n" % CELL_W)
+    for c in range(FIRST, LAST + 1):
+        cols = to_columns(glyphs[c], ascent)
+        ch = chr(c) if chr(c) not in "\\'" else "\\" + chr(c)
+        out.write("    {%s}, // '%s'\n" % (",".join("0x%02X" % v for v in cols), ch))
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * dht11.c 그대로 (모듈 하나 = TU 하나). 하네스가 static 쪽을 부를 수 있게 여기서 include한다.
+ */
+#include "../dht11.c"
+#include "host.h"
+
+int host_dht11_load(int pin)
+{
+    gpio = pin;
+    return dht11_driver_init();
+}
+
+void host_dht11_unload(void)
+{
+    dht11_driver_exit();
+}
+
+int host_dht11_read(int *temp, int *humi)
+{
+    struct device *dev = dht11_find_device(NULL, "dht11.0");
+    int ret;
+
+    if (!dev)
+        return -ENODEV;
+    ret = dht11_read_values(dev, temp, humi);
+    put_device(dev);
+    return ret;
+}
+
+int host_dht11_latest(int *temp, int *humi, long long *age_ms)
+{
+    struct device *dev = dht11_find_device(NULL, "dht11.0");
+    ktime_t kt;
+    int ret;
+
+    if (!dev)
+        return -ENODEV;
+    ret = dht11_get_latest(dev, temp, humi, &kt);
+    if (!ret)
+        *age_ms = ktime_ms_delta(ktime_get(), kt);
+    put_device(dev);
+    return ret;
+}
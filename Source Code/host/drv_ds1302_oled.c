@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * ds1302_oled.c 그대로. DS1302는 비트뱅 GPIO로, SSD1306은 i2c_transfer로 시뮬레이터에 닿는다.
+ */
+#include "../ds1302_oled.c"
+#include "host.h"
+
+static struct ds_oled *host_ds(void)
+{
+    if (!ds_legacy || !ds_legacy->dev.driver)
+        return NULL;
+    return i2c_get_clientdata(ds_legacy);
+}
+
+int host_ds_load(const struct host_ds_params *p)
+{
+    i2c_bus = p->bus;
+    i2c_addr = p->addr;
+    ds_ce_gpio = p->ce;
+    ds_clk_gpio = p->clk;
+    ds_dat_gpio = p->dat;
+    oled_single_xfer = p->single_xfer;
+    clock_scale = p->clock_scale;
+    return ds1302_oled_init();
+}
+
+void host_ds_unload(void)
+{
+    ds1302_oled_exit();
+}
+
+bool host_ds_bound(void)
+{
+    return host_ds() != NULL;
+}
+
+void host_ds_expect(uint8_t *px, bool set_mode, const char *th, const char *dt, const char *tm)
+{
+    struct oled_fb *f = kzalloc(sizeof(*f), GFP_KERNEL);
+
+    ui_draw(f, set_mode, th, dt, tm);
+    memcpy(px, f->px, OLED_BUF);
+    kfree(f);
+}
+
+unsigned long host_ds_i2c_errors(void)
+{
+    struct ds_oled *d = host_ds();
+
+    return d ? d->i2c_errors : 0;
+}
+
+void host_ds_bench_draw(int n)
+{
+    struct oled_fb *f = kzalloc(sizeof(*f), GFP_KERNEL);
+    char tm[16];
+    int i;
+
+    for (i = 0; i < n; i++) {
+        snprintf(tm, sizeof(tm), "%02d:%02d:%02d", (i / 3600) % 24, (i / 60) % 60, i % 60);
+        ui_draw(f, false, "T23C H45%", "2026-01-01", tm);
+    }
+    kfree(f);
+}
+
+/* producer가 새 초를 올린 것처럼 캐시를 바꾸고 tick을 직접 돌린 뒤, 걸린 flush까지 실행 */
+void host_ds_bench_tick(int n)
+{
+    struct ds_oled *d = host_ds();
+    int i;
+
+    if (!d)
+        return;
+    for (i = 0; i < n; i++) {
+        spin_lock(&d->sense_lock);
+        d->t_cache.sec = (d->t_cache.sec + 1) % 60;
+        d->sense_changed = true;
+        spin_unlock(&d->sense_lock);
+        tick_fn(&d->tick_work.work);
+        kshim_run_until(kshim_now_ns());
+    }
+}
+
+void host_ds_bench_rtc(int n)
+{
+    struct ds_oled *d = host_ds();
+    struct ds_time t;
+    int i;
+
+    if (!d)
+        return;
+    for (i = 0; i < n; i++) {
+        mutex_lock(&d->ds_lock);
+        ds1302_read_time(d, &t);
+        mutex_unlock(&d->ds_lock);
+    }
+}
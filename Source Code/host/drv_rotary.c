@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * rotary.c 그대로. 엔코더 시뮬레이터가 선을 바꾸면 kshim이 A/B/SW IRQ 핸들러를 부른다.
+ */
+#include "../rotary.c"
+#include "host.h"
+#include "sim.h"
+
+int host_rotary_load(int s1, int s2, int sw)
+{
+    s1_gpio = s1;
+    s2_gpio = s2;
+    sw_gpio = sw;
+    return rotary_driver_init();
+}
+
+void host_rotary_unload(void)
+{
+    rotary_driver_exit();
+}
+
+/* NORMAL 모드에선 A/B IRQ가 꺼져 있으므로 잠깐 켠다. 글리치 컷(1 jiffy)을 넘기게 전이마다 시계를 민다 */
+void host_rotary_bench_decode(int n)
+{
+    struct device *dev = rotary_find_device(NULL, "rotary.0");
+    int i;
+
+    if (!dev)
+        return;
+    rotary_irq_enable(dev, true);
+    for (i = 0; i < n; i++) {
+        sim_enc_step((i / 64) & 1 ? -1 : +1);
+        kshim_advance_ns(5 * NSEC_PER_MSEC);
+        rotary_get_event(dev);
+    }
+    rotary_irq_enable(dev, false);
+    put_device(dev);
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * main.c(libc 쪽)와 드라이버 TU(kshim 쪽) 사이의 하네스 API.
+ *
+ * kshim.h는 커널 타입(struct tm, dev_t, loff_t ...)을 정의하므로 libc 헤더와 같이 못 쓴다.
+ * 그래서 main.c는 이 헤더와 sim.h만 보고, 여기 선언은 libc 타입으로만 적는다.
+ */
+#ifndef KKK_HOST_H
+#define KKK_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------- kshim.c (커널 shim) --------------------
+unsigned long long kshim_now_ns(void);
+void kshim_advance_ns(unsigned long long ns);
+void kshim_run_until(unsigned long long t);
+int kshim_events_pending(void);
+void kshim_set_loglevel(int level);
+long kshim_kmalloc_live(void);
+unsigned long long kshim_irq_off_max_ns(bool reset);
+long kshim_debugfs_read(const char *path, char *buf, size_t size);
+int kshim_nvmem_rw(const char *name, bool write, unsigned int off, void *buf, size_t len);
+int kshim_hwmon_rw(const char *parent, const char *attr, bool write, long *val);
+int kshim_kunit_run(const char *filter);   // 실패한 케이스 수
+
+// -------------------- host_dev.c --------------------
+/* 버스 nr에 실제 컨트롤러 흉내 어댑터를 만든다: "i2c-gpio", "bcm2835", "small", "tiny" */
+void *host_i2c_add_bus(int nr, const char *kind);
+void host_i2c_del_bus(void *bus);
+
+/* class device 이름("ds1302_oled", "dht11" ...)으로 연 파일. user space의 open/read/ioctl 흉내 */
+struct host_file;
+struct host_file *host_open(const char *name, bool nonblock);
+long host_read(struct host_file *f, char *buf, size_t n);
+long host_pread(struct host_file *f, char *buf, size_t n, long long off);   // 위치 없는 파일이면 -ESPIPE
+long host_write(struct host_file *f, const char *buf, size_t n);
+long host_ioctl(struct host_file *f, unsigned int cmd, void *arg);
+void host_close(struct host_file *f);
+long host_sysfs(const char *name, const char *attr, char *buf);   // buf는 4096바이트
+
+// -------------------- drv_dht11.c --------------------
+int host_dht11_load(int pin);
+void host_dht11_unload(void);
+int host_dht11_read(int *temp, int *humi);   // 내보낸 dht11_read_values()로 dht11.0 읽기
+int host_dht11_latest(int *temp, int *humi, long long *age_ms);   // dht11_get_latest()
+
+// -------------------- drv_rotary.c --------------------
+int host_rotary_load(int s1, int s2, int sw);
+void host_rotary_unload(void);
+void host_rotary_bench_decode(int n);        // A/B IRQ 경로(디코드 + detent)를 n 전이
+
+// -------------------- drv_ds1302_oled.c --------------------
+struct host_ds_params {
+    int bus, addr;
+    int ce, clk, dat;
+    bool single_xfer;
+    int clock_scale;
+};
+int host_ds_load(const struct host_ds_params *p);
+void host_ds_unload(void);
+bool host_ds_bound(void);                    // 예전 구성 client에 드라이버가 붙었는지
+/* ui_draw()로 그린 화면 (패널 GDDRAM과 같은 [page * 128 + col] 배치) */
+void host_ds_expect(uint8_t *px, bool set_mode, const char *th, const char *dt, const char *tm);
+unsigned long host_ds_i2c_errors(void);
+void host_ds_bench_draw(int n);              // 버스 없이 ui_draw만
+void host_ds_bench_tick(int n);              // 초 캐시 갱신 -> tick_fn -> flush (가상 I2C)
+void host_ds_bench_rtc(int n);               // DS1302 clock burst read
+
+#endif /* KKK_HOST_H */
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * 실제 시계 (libc <time.h>). kshim.h의 struct tm과 겹치므로 따로 둔다.
+ * kshim_clock_real(true)일 때만 쓰인다 (KUnit 벤치마크).
+ */
+#include <time.h>
+
+unsigned long long host_mono_ns(void);
+
+unsigned long long host_mono_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
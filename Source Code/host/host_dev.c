@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * 하네스 접착부: I2C 컨트롤러 흉내, /dev 파일 열기, sysfs 읽기.
+ * kshim 쪽 타입을 쓰므로 main.c와 따로 컴파일하고, main.c는 host.h로만 부른다.
+ */
+#include <linux/kernel.h>
+#include <linux/device.h>
+#include <linux/fs.h>
+#include <linux/cdev.h>
+#include <linux/i2c.h>
+#include <linux/slab.h>
+
+#include "host.h"
+
+/*
+ * 라즈베리파이에서 실제로 쓰는 버스들
+ *  - i2c-gpio (i2c-algo-bit): NOSTART 지원, 길이 제한 없음
+ *  - bcm2835: NOSTART 없음 -> 드라이버가 한 메시지로 모아서 보냄
+ *  - small: 한 메시지 32바이트, 한 번에 2개까지 (작은 FIFO 컨트롤러 흉내)
+ *  - tiny: 한 메시지 1바이트 (control byte만 들어감 -> 드라이버가 거절해야 함)
+ */
+static const struct i2c_adapter_quirks host_small_quirks = {
+    .max_num_msgs  = 2,
+    .max_write_len = 32,
+};
+
+static const struct i2c_adapter_quirks host_tiny_quirks = {
+    .max_write_len = 1,
+};
+
+void *host_i2c_add_bus(int nr, const char *kind)
+{
+    if (!strcmp(kind, "i2c-gpio"))
+        return kshim_i2c_add_adapter(nr, I2C_FUNC_I2C | I2C_FUNC_NOSTART |
+                                         I2C_FUNC_PROTOCOL_MANGLING, NULL);
+    if (!strcmp(kind, "bcm2835"))
+        return kshim_i2c_add_adapter(nr, I2C_FUNC_I2C, NULL);
+    if (!strcmp(kind, "small"))
+        return kshim_i2c_add_adapter(nr, I2C_FUNC_I2C, &host_small_quirks);
+    if (!strcmp(kind, "tiny"))
+        return kshim_i2c_add_adapter(nr, I2C_FUNC_I2C, &host_tiny_quirks);
+    return NULL;
+}
+
+void host_i2c_del_bus(void *bus)
+{
+    kshim_i2c_del_adapter(bus);
+}
+
+struct host_file {
+    struct inode inode;
+    struct file file;
+};
+
+struct host_file *host_open(const char *name, bool nonblock)
+{
+    struct device *dev = kshim_class_find(name);
+    struct host_file *f;
+    struct cdev *c;
+    int ret;
+
+    if (!dev || !dev->devt)
+        return NULL;
+    c = kshim_cdev_lookup(dev->devt);
+    if (!c)
+        return NULL;
+    f = kzalloc(sizeof(*f), GFP_KERNEL);
+    if (!f)
+        return NULL;
+    f->inode.i_cdev = c;
+    f->inode.i_rdev = dev->devt;
+    f->file.f_inode = &f->inode;
+    f->file.f_op = c->ops;
+    f->file.f_flags = nonblock ? O_NONBLOCK : 0;
+    f->file.f_mode = FMODE_READ | FMODE_WRITE | FMODE_LSEEK | FMODE_PREAD | FMODE_PWRITE;
+    if (f->file.f_op->open) {
+        ret = f->file.f_op->open(&f->inode, &f->file);
+        if (ret) {
+            kfree(f);
+            return NULL;
+        }
+    }
+    kobject_get(&c->kobj);      // chrdev_open처럼: 파일이 cdev를 잡는다
+    return f;
+}
+
+/* vfs처럼: stream 파일에는 위치 포인터 대신 NULL */
+static loff_t *host_ppos(struct host_file *f)
+{
+    return (f->file.f_mode & FMODE_STREAM) ? NULL : &f->file.f_pos;
+}
+
+long host_read(struct host_file *f, char *buf, size_t n)
+{
+    if (!f->file.f_op->read)
+        return -EINVAL;
+    return f->file.f_op->read(&f->file, buf, n, host_ppos(f));
+}
+
+long host_pread(struct host_file *f, char *buf, size_t n, long long off)
+{
+    loff_t pos = off;
+
+    if (!(f->file.f_mode & FMODE_PREAD))
+        return -ESPIPE;
+    if (!f->file.f_op->read)
+        return -EINVAL;
+    return f->file.f_op->read(&f->file, buf, n, &pos);
+}
+
+long host_write(struct host_file *f, const char *buf, size_t n)
+{
+    if (!f->file.f_op->write)
+        return -EINVAL;
+    return f->file.f_op->write(&f->file, buf, n, host_ppos(f));
+}
+
+long host_ioctl(struct host_file *f, unsigned int cmd, void *arg)
+{
+    if (!f->file.f_op->unlocked_ioctl)
+        return -ENOTTY;
+    return f->file.f_op->unlocked_ioctl(&f->file, cmd, (unsigned long)arg);
+}
+
+void host_close(struct host_file *f)
+{
+    if (f->file.f_op->release)
+        f->file.f_op->release(&f->inode, &f->file);
+    kobject_put(&f->inode.i_cdev->kobj);
+    kfree(f);
+}
+
+long host_sysfs(const char *name, const char *attr, char *buf)
+{
+    struct device *dev = kshim_class_find(name);
+
+    if (!dev)
+        return -ENODEV;
+    return kshim_sysfs_show(dev, attr, buf);
+}
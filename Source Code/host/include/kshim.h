@@ -0,0 +1,1106 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * 호스트 빌드용 커널 API shim.
+ *
+ * 드라이버 소스(../dht11.c, ../rotary.c, ../ds1302_oled.c)는 손대지 않고 그대로 컴파일한다.
+ * 드라이버가 하드웨어를 만지는 곳은 이미 gpiod_*, udelay/ndelay/msleep, i2c_transfer/
+ * i2c_master_send뿐이므로 그 API 자체가 HAL이 되고, 여기서 sim.c의 가상 장치로 보낸다.
+ *
+ *  - 스레드 하나. 락은 재진입 검사만 하는 카운터, atomic은 평범한 변수.
+ *  - 시간은 가상 시계(kshim_now_ns) 하나: udelay/msleep/usleep_range는 잠들지 않고 시계만
+ *    민다. 그래서 valgrind/sanitizer 아래에서도 비트뱅 타이밍이 그대로 맞는다.
+ *  - workqueue/hrtimer는 가상 시계 위의 이벤트 목록. kshim_run_until()이 시각 순서로 실행.
+ *  - 모듈 init/probe/remove/exit 경로는 진짜로 돈다 (devm, platform/i2c 매칭, cdev, class).
+ *
+ * libc의 <time.h>는 커널 struct tm과 겹치므로 여기서 include하지 않는다.
+ */
+#ifndef KSHIM_H
+#define KSHIM_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+
+// -------------------- 기본 타입 --------------------
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+typedef unsigned long long u64;
+typedef signed char s8;
+typedef short s16;
+typedef int s32;
+typedef long long s64;
+typedef u8 __u8;
+typedef u16 __u16;
+typedef u32 __u32;
+typedef u64 __u64;
+typedef s32 __s32;
+typedef s64 __s64;
+
+typedef long ssize_t;
+typedef long long loff_t;
+typedef unsigned int dev_t;
+typedef s64 ktime_t;
+typedef s64 time64_t;
+typedef unsigned int gfp_t;
+typedef unsigned short umode_t;
+typedef unsigned int __poll_t;
+
+#define __user
+#define __iomem
+#define __init
+#define __exit
+#define __packed        __attribute__((packed))
+#define __maybe_unused  __attribute__((unused))
+#ifndef __always_inline
+#define __always_inline inline __attribute__((always_inline))
+#endif
+#define likely(x)       __builtin_expect(!!(x), 1)
+#define unlikely(x)     __builtin_expect(!!(x), 0)
+#define READ_ONCE(x)    (*(volatile __typeof__(x) *)&(x))
+#define WRITE_ONCE(x, v) (*(volatile __typeof__(x) *)&(x) = (v))
+#define static_assert   _Static_assert
+#define BUILD_BUG_ON(c) _Static_assert(!(c), #c)
+
+// -------------------- errno (리눅스 값) --------------------
+#define EPERM        1
+#define EINTR        4
+#define EIO          5
+#define ENXIO        6
+#define E2BIG        7
+#define EAGAIN      11
+#define ENOMEM      12
+#define EACCES      13
+#define EFAULT      14
+#define EBUSY       16
+#define ENODEV      19
+#define EINVAL      22
+#define ENOTTY      25
+#define ENOIOCTLCMD 515
+#define EFBIG       27
+#define ENOSPC      28
+#define ESPIPE      29
+#define ERANGE      34
+#define ENODATA     61
+#define ENOENT       2
+#define EOPNOTSUPP  95
+#define ETIMEDOUT  110
+#define ERESTARTSYS 512
+#define EPROBE_DEFER 517
+
+#define MAX_ERRNO 4095
+#define IS_ERR_VALUE(x) ((unsigned long)(void *)(x) >= (unsigned long)-MAX_ERRNO)
+static inline void *ERR_PTR(long error) { return (void *)error; }
+static inline long PTR_ERR(const void *ptr) { return (long)ptr; }
+static inline bool IS_ERR(const void *ptr) { return IS_ERR_VALUE((unsigned long)ptr); }
+static inline bool IS_ERR_OR_NULL(const void *ptr) { return !ptr || IS_ERR(ptr); }
+static inline int PTR_ERR_OR_ZERO(const void *ptr) { return IS_ERR(ptr) ? (int)PTR_ERR(ptr) : 0; }
+
+// -------------------- 자주 쓰는 매크로 --------------------
+#define ARRAY_SIZE(a)   (sizeof(a) / sizeof((a)[0]))
+#define container_of(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#define min(a, b)       ({ __typeof__(a) _a = (a); __typeof__(b) _b = (b); _a < _b ? _a : _b; })
+#define max(a, b)       ({ __typeof__(a) _a = (a); __typeof__(b) _b = (b); _a > _b ? _a : _b; })
+#define min_t(t, a, b)  ({ t _a = (a); t _b = (b); _a < _b ? _a : _b; })
+#define max_t(t, a, b)  ({ t _a = (a); t _b = (b); _a > _b ? _a : _b; })
+#define clamp(v, lo, hi) min(max(v, lo), hi)
+#define clamp_t(t, v, lo, hi) min_t(t, max_t(t, v, lo), hi)
+#define swap(a, b)      do { __typeof__(a) _t = (a); (a) = (b); (b) = _t; } while (0)
+#define DIV_ROUND_UP(n, d) (((n) + (d) - 1) / (d))
+#define BIT(n)          (1UL << (n))
+#define GENMASK(h, l)   (((~0UL) << (l)) & (~0UL >> (63 - (h))))
+#define ULONG_MAX       (~0UL)
+#define U32_MAX         0xffffffffU
+#define S64_MAX         0x7fffffffffffffffLL
+#define U64_MAX         0xffffffffffffffffULL
+
+#define NSEC_PER_USEC   1000L
+#define NSEC_PER_MSEC   1000000L
+#define NSEC_PER_SEC    1000000000L
+#define USEC_PER_MSEC   1000L
+#define USEC_PER_SEC    1000000L
+#define MSEC_PER_SEC    1000L
+
+// -------------------- module --------------------
+struct module;
+#define THIS_MODULE ((struct module *)0)
+#define MODULE_LICENSE(x)
+#define MODULE_AUTHOR(x)
+#define MODULE_DESCRIPTION(x)
+#define MODULE_DEVICE_TABLE(type, name)
+#define MODULE_PARM_DESC(name, desc)
+#define EXPORT_SYMBOL(x)
+#define EXPORT_SYMBOL_GPL(x)
+// init/exit는 호스트 하네스(drv_*.c)가 같은 TU 안에서 직접 부른다
+#define module_init(fn)
+#define module_exit(fn)
+#define module_param(name, type, perm)
+#define module_param_named(name, var, type, perm)
+#define module_param_array(name, type, nump, perm)
+
+struct kernel_param {
+    const char *name;
+    void *arg;
+};
+struct kernel_param_ops {
+    int (*set)(const char *val, const struct kernel_param *kp);
+    int (*get)(char *buf, const struct kernel_param *kp);
+};
+int param_get_uint(char *buf, const struct kernel_param *kp);
+int param_set_uint(const char *val, const struct kernel_param *kp);
+#define module_param_cb(name, ops, arg, perm) \
+    static const struct kernel_param_ops *__kshim_param_##name __maybe_unused = (ops)
+
+// -------------------- printk --------------------
+#define KERN_SOH     "\001"
+#define KERN_ERR     KERN_SOH "3"
+#define KERN_WARNING KERN_SOH "4"
+#define KERN_NOTICE  KERN_SOH "5"
+#define KERN_INFO    KERN_SOH "6"
+#define KERN_DEBUG   KERN_SOH "7"
+
+struct device;
+__attribute__((format(printf, 1, 2))) int printk(const char *fmt, ...);
+__attribute__((format(printf, 3, 4))) void kshim_dev_printk(const char *level, const struct device *dev,
+                                                             const char *fmt, ...);
+#define kshim_no_printk(fmt, ...) ({ if (0) printk(fmt, ##__VA_ARGS__); 0; })
+
+#define pr_err(fmt, ...)    printk(KERN_ERR fmt, ##__VA_ARGS__)
+#define pr_warn(fmt, ...)   printk(KERN_WARNING fmt, ##__VA_ARGS__)
+#define pr_info(fmt, ...)   printk(KERN_INFO fmt, ##__VA_ARGS__)
+#define pr_debug(fmt, ...)  kshim_no_printk(fmt, ##__VA_ARGS__)
+#define pr_err_ratelimited(fmt, ...)  pr_err(fmt, ##__VA_ARGS__)
+#define pr_warn_ratelimited(fmt, ...) pr_warn(fmt, ##__VA_ARGS__)
+#define pr_info_ratelimited(fmt, ...) pr_info(fmt, ##__VA_ARGS__)
+#define dev_err(dev, fmt, ...)  kshim_dev_printk(KERN_ERR, dev, fmt, ##__VA_ARGS__)
+#define dev_warn(dev, fmt, ...) kshim_dev_printk(KERN_WARNING, dev, fmt, ##__VA_ARGS__)
+#define dev_info(dev, fmt, ...) kshim_dev_printk(KERN_INFO, dev, fmt, ##__VA_ARGS__)
+#define dev_dbg(dev, fmt, ...)  ({ if (0) kshim_dev_printk(KERN_DEBUG, dev, fmt, ##__VA_ARGS__); })
+#define dev_err_ratelimited(dev, fmt, ...) dev_err(dev, fmt, ##__VA_ARGS__)
+#define dev_err_probe(dev, err, fmt, ...) ({ dev_err(dev, fmt, ##__VA_ARGS__); (int)(err); })
+
+/* 이 레벨보다 작은(중요한) 메시지만 stderr로. 기본 5 = 에러/경고만 */
+void kshim_set_loglevel(int level);
+
+/* 드라이버 버그(커널이었으면 BUG/lockdep 경고)는 바로 abort */
+__attribute__((noreturn, format(printf, 1, 2))) void kshim_bug(const char *fmt, ...);
+
+// -------------------- 문자열 --------------------
+__attribute__((format(printf, 3, 4))) int scnprintf(char *buf, size_t size, const char *fmt, ...);
+__attribute__((format(printf, 2, 3))) int sysfs_emit(char *buf, const char *fmt, ...);
+ssize_t strscpy(char *dst, const char *src, size_t size);
+char *strim(char *s);
+void *memchr_inv(const void *p, int c, size_t n);
+int kstrtoint(const char *s, unsigned int base, int *res);
+int kstrtouint(const char *s, unsigned int base, unsigned int *res);
+int kstrtol(const char *s, unsigned int base, long *res);
+int kstrtoll(const char *s, unsigned int base, long long *res);
+int kstrtobool(const char *s, bool *res);
+
+// -------------------- bitops / math64 --------------------
+static inline unsigned int hweight32(unsigned int w) { return __builtin_popcount(w); }
+static inline int fls(unsigned int x) { return x ? 32 - __builtin_clz(x) : 0; }
+static inline int fls64(u64 x) { return x ? 64 - __builtin_clzll(x) : 0; }
+static inline u64 div_u64(u64 a, u32 b) { return a / b; }
+static inline s64 div_s64(s64 a, s32 b) { return a / b; }
+static inline u64 div64_u64(u64 a, u64 b) { return a / b; }
+static inline s64 div64_s64(s64 a, s64 b) { return a / b; }
+static inline u64 div_u64_rem(u64 a, u32 b, u32 *rem) { *rem = a % b; return a / b; }
+static inline s64 div_s64_rem(s64 a, s32 b, s32 *rem) { *rem = a % b; return a / b; }
+
+// -------------------- atomic --------------------
+typedef struct { int counter; } atomic_t;
+typedef struct { s64 counter; } atomic64_t;
+#define ATOMIC_INIT(i) { (i) }
+static inline int atomic_read(const atomic_t *v) { return v->counter; }
+static inline void atomic_set(atomic_t *v, int i) { v->counter = i; }
+static inline void atomic_inc(atomic_t *v) { v->counter++; }
+static inline void atomic_dec(atomic_t *v) { v->counter--; }
+static inline int atomic_inc_return(atomic_t *v) { return ++v->counter; }
+static inline int atomic_dec_return(atomic_t *v) { return --v->counter; }
+static inline bool atomic_dec_and_test(atomic_t *v) { return --v->counter == 0; }
+static inline int atomic_xchg(atomic_t *v, int n) { int o = v->counter; v->counter = n; return o; }
+static inline s64 atomic64_read(const atomic64_t *v) { return v->counter; }
+static inline void atomic64_set(atomic64_t *v, s64 i) { v->counter = i; }
+static inline s64 atomic64_xchg(atomic64_t *v, s64 n) { s64 o = v->counter; v->counter = n; return o; }
+static inline s64 atomic64_cmpxchg(atomic64_t *v, s64 old, s64 n)
+{
+    s64 cur = v->counter;
+
+    if (cur == old)
+        v->counter = n;
+    return cur;
+}
+
+// -------------------- list --------------------
+struct list_head {
+    struct list_head *next, *prev;
+};
+#define LIST_HEAD_INIT(name) { &(name), &(name) }
+#define LIST_HEAD(name) struct list_head name = LIST_HEAD_INIT(name)
+static inline void INIT_LIST_HEAD(struct list_head *l) { l->next = l->prev = l; }
+static inline void __list_add(struct list_head *n, struct list_head *prev, struct list_head *next)
+{
+    next->prev = n;
+    n->next = next;
+    n->prev = prev;
+    prev->next = n;
+}
+static inline void list_add(struct list_head *n, struct list_head *head) { __list_add(n, head, head->next); }
+static inline void list_add_tail(struct list_head *n, struct list_head *head) { __list_add(n, head->prev, head); }
+static inline void list_del(struct list_head *e)
+{
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    e->next = e->prev = NULL;
+}
+static inline int list_empty(const struct list_head *head) { return head->next == head; }
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+#define list_first_entry(head, type, member) list_entry((head)->next, type, member)
+#define list_for_each_entry(pos, head, member) \
+    for (pos = list_entry((head)->next, __typeof__(*pos), member); \
+         &pos->member != (head); \
+         pos = list_entry(pos->member.next, __typeof__(*pos), member))
+
+// -------------------- 시간 --------------------
+#define HZ 250
+u64 kshim_now_ns(void);             // 가상 시계 (CLOCK_MONOTONIC == CLOCK_BOOTTIME)
+void kshim_advance_ns(u64 ns);      // 가상 시계만 민다 (이벤트는 실행 안 함)
+/* true면 가상 시계에 실제 경과 시간도 더한다 (KUnit 벤치마크가 ktime_get_ns로 재므로) */
+void kshim_clock_real(bool on);
+#define jiffies ((unsigned long)(kshim_now_ns() / (NSEC_PER_SEC / HZ)))
+#define time_after(a, b)     ((long)((b) - (a)) < 0)
+#define time_before(a, b)    time_after(b, a)
+#define time_after_eq(a, b)  ((long)((a) - (b)) >= 0)
+#define time_before_eq(a, b) time_after_eq(b, a)
+static inline unsigned long msecs_to_jiffies(unsigned int ms) { return DIV_ROUND_UP((unsigned long)ms * HZ, 1000); }
+static inline unsigned int jiffies_to_msecs(unsigned long j) { return j * (1000 / HZ); }
+
+static inline ktime_t ktime_get(void) { return kshim_now_ns(); }
+static inline ktime_t ktime_get_boottime(void) { return kshim_now_ns(); }
+static inline u64 ktime_get_ns(void) { return kshim_now_ns(); }
+ktime_t ktime_get_real(void);
+time64_t ktime_get_real_seconds(void);
+static inline s64 ktime_to_ns(ktime_t kt) { return kt; }
+static inline s64 ktime_to_us(ktime_t kt) { return kt / NSEC_PER_USEC; }
+static inline s64 ktime_to_ms(ktime_t kt) { return kt / NSEC_PER_MSEC; }
+static inline ktime_t ns_to_ktime(u64 ns) { return ns; }
+static inline ktime_t ms_to_ktime(u64 ms) { return ms * NSEC_PER_MSEC; }
+static inline ktime_t ktime_set(s64 secs, unsigned long ns) { return secs * NSEC_PER_SEC + ns; }
+static inline ktime_t ktime_add(ktime_t a, ktime_t b) { return a + b; }
+static inline ktime_t ktime_sub(ktime_t a, ktime_t b) { return a - b; }
+static inline ktime_t ktime_add_ns(ktime_t a, u64 ns) { return a + ns; }
+static inline ktime_t ktime_sub_ns(ktime_t a, u64 ns) { return a - ns; }
+static inline s64 ktime_us_delta(ktime_t a, ktime_t b) { return (a - b) / NSEC_PER_USEC; }
+static inline s64 ktime_ms_delta(ktime_t a, ktime_t b) { return (a - b) / NSEC_PER_MSEC; }
+static inline int ktime_compare(ktime_t a, ktime_t b) { return a < b ? -1 : a > b; }
+static inline bool ktime_after(ktime_t a, ktime_t b) { return a > b; }
+static inline bool ktime_before(ktime_t a, ktime_t b) { return a < b; }
+
+/* 지연: 잠들지 않고 가상 시계만 민다 */
+static inline void ndelay(unsigned long ns) { kshim_advance_ns(ns); }
+static inline void udelay(unsigned long us) { kshim_advance_ns((u64)us * NSEC_PER_USEC); }
+static inline void msleep(unsigned int ms) { kshim_advance_ns((u64)ms * NSEC_PER_MSEC); }
+static inline void usleep_range(unsigned long lo, unsigned long hi) { (void)hi; kshim_advance_ns((u64)lo * NSEC_PER_USEC); }
+
+struct tm {
+    int tm_sec, tm_min, tm_hour, tm_mday, tm_mon;
+    long tm_year;
+    int tm_wday, tm_yday;
+};
+time64_t mktime64(unsigned int year, unsigned int mon, unsigned int day,
+                  unsigned int hour, unsigned int min, unsigned int sec);
+void time64_to_tm(time64_t totalsecs, int offset, struct tm *result);
+
+// -------------------- 락 (단일 스레드: 재진입/짝 안 맞음만 검사) --------------------
+struct mutex {
+    int held;
+};
+typedef struct {
+    int held;
+} spinlock_t;
+#define DEFINE_MUTEX(name)    struct mutex name = { 0 }
+#define DEFINE_SPINLOCK(name) spinlock_t name = { 0 }
+static inline void mutex_init(struct mutex *m) { m->held = 0; }
+static inline void mutex_lock(struct mutex *m)
+{
+    if (m->held)
+        kshim_bug("mutex %p: recursive lock", (void *)m);
+    m->held = 1;
+}
+static inline void mutex_unlock(struct mutex *m)
+{
+    if (!m->held)
+        kshim_bug("mutex %p: unlock without lock", (void *)m);
+    m->held = 0;
+}
+static inline int mutex_trylock(struct mutex *m) { if (m->held) return 0; m->held = 1; return 1; }
+static inline int mutex_lock_interruptible(struct mutex *m) { mutex_lock(m); return 0; }
+static inline void spin_lock_init(spinlock_t *l) { l->held = 0; }
+static inline void spin_lock(spinlock_t *l)
+{
+    if (l->held)
+        kshim_bug("spinlock %p: recursive lock", (void *)l);
+    l->held = 1;
+}
+static inline void spin_unlock(spinlock_t *l)
+{
+    if (!l->held)
+        kshim_bug("spinlock %p: unlock without lock", (void *)l);
+    l->held = 0;
+}
+/*
+ * 로컬 IRQ 끄기: 꺼져 있는 동안 들어온 GPIO 에지는 미뤄 두었다가 다시 켤 때 핸들러를 부른다
+ * (IRQ 핸들러가 끼어들 수 있는 곳은 가상 시계가 움직이는 지연 함수 안뿐)
+ */
+unsigned long kshim_irq_save(void);
+void kshim_irq_restore(unsigned long flags);
+u64 kshim_irq_off_max_ns(bool reset);   // 하네스: IRQ를 끈 가장 긴 구간 (가상 ns)
+#define local_irq_save(f)      do { (f) = kshim_irq_save(); } while (0)
+#define local_irq_restore(f)   kshim_irq_restore(f)
+#define local_irq_disable()    ((void)kshim_irq_save())
+#define local_irq_enable()     kshim_irq_restore(0)
+#define spin_lock_irq(l)       do { local_irq_disable(); spin_lock(l); } while (0)
+#define spin_unlock_irq(l)     do { spin_unlock(l); local_irq_enable(); } while (0)
+#define spin_lock_bh(l)        spin_lock(l)
+#define spin_unlock_bh(l)      spin_unlock(l)
+#define spin_lock_irqsave(l, f)      do { local_irq_save(f); spin_lock(l); } while (0)
+#define spin_unlock_irqrestore(l, f) do { spin_unlock(l); local_irq_restore(f); } while (0)
+static inline void preempt_disable(void) { }
+static inline void preempt_enable(void) { }
+
+// -------------------- wait queue / poll --------------------
+typedef struct {
+    unsigned long wakeups;
+} wait_queue_head_t;
+#define DECLARE_WAIT_QUEUE_HEAD(name) wait_queue_head_t name = { 0 }
+static inline void init_waitqueue_head(wait_queue_head_t *q) { q->wakeups = 0; }
+static inline void wake_up_interruptible(wait_queue_head_t *q) { q->wakeups++; }
+static inline void wake_up(wait_queue_head_t *q) { q->wakeups++; }
+static inline void wake_up_all(wait_queue_head_t *q) { q->wakeups++; }
+static inline void wake_up_interruptible_all(wait_queue_head_t *q) { q->wakeups++; }
+/* 잘 수 없으므로 조건이 거짓이면 시그널을 받은 것처럼 돌아간다 */
+#define wait_event_interruptible(wq, cond) ({ (void)(wq); (cond) ? 0 : -ERESTARTSYS; })
+#define wait_event_interruptible_timeout(wq, cond, t) ({ (void)(wq); (void)(t); (cond) ? 1L : 0L; })
+#define wait_event_timeout(wq, cond, t) ({ (void)(wq); (void)(t); (cond) ? 1L : 0L; })
+
+/*
+ * completion: 기다리는 동안 장치(IRQ)와 다른 work/hrtimer는 계속 돌아야 하므로
+ * 가상 시계를 sim 에지 단위로 밀면서 done을 본다. 남은 jiffies(최소 1) 또는 0(시간 초과)
+ */
+struct completion {
+    unsigned int done;
+};
+static inline void init_completion(struct completion *c) { c->done = 0; }
+static inline void reinit_completion(struct completion *c) { c->done = 0; }
+static inline void complete(struct completion *c) { c->done++; }
+static inline bool completion_done(struct completion *c) { return c->done; }
+unsigned long wait_for_completion_timeout(struct completion *c, unsigned long timeout);
+
+struct file;
+typedef struct poll_table_struct {
+    int unused;
+} poll_table;
+static inline void poll_wait(struct file *f, wait_queue_head_t *q, poll_table *p) { (void)f; (void)q; (void)p; }
+#define EPOLLIN     0x00000001
+#define EPOLLPRI    0x00000002
+#define EPOLLOUT    0x00000004
+#define EPOLLERR    0x00000008
+#define EPOLLHUP    0x00000010
+#define EPOLLRDNORM 0x00000040
+#define EPOLLWRNORM 0x00000100
+
+// -------------------- workqueue / hrtimer (가상 시계 이벤트) --------------------
+struct work_struct;
+typedef void (*work_func_t)(struct work_struct *work);
+struct workqueue_struct;
+
+struct work_struct {
+    work_func_t func;
+    struct workqueue_struct *kshim_wq;
+    struct work_struct *kshim_next;   // 대기 목록
+    u64 kshim_due;
+    bool kshim_pending;
+};
+struct delayed_work {
+    struct work_struct work;
+};
+#define __WORK_INITIALIZER(n, f) { .func = (f) }
+#define DECLARE_WORK(n, f) struct work_struct n = __WORK_INITIALIZER(n, f)
+#define DECLARE_DELAYED_WORK(n, f) struct delayed_work n = { .work = __WORK_INITIALIZER(n.work, f) }
+#define INIT_WORK(w, f) do { memset((w), 0, sizeof(*(w))); (w)->func = (f); } while (0)
+#define INIT_DELAYED_WORK(dw, f) INIT_WORK(&(dw)->work, f)
+#define to_delayed_work(w) container_of(w, struct delayed_work, work)
+
+#define WQ_UNBOUND      (1 << 1)
+#define WQ_FREEZABLE    (1 << 2)
+#define WQ_MEM_RECLAIM  (1 << 3)
+#define WQ_HIGHPRI      (1 << 4)
+extern struct workqueue_struct *system_wq, *system_long_wq, *system_highpri_wq;
+__attribute__((format(printf, 1, 4)))
+struct workqueue_struct *alloc_workqueue(const char *fmt, unsigned int flags, int max_active, ...);
+#define alloc_ordered_workqueue(fmt, flags, ...) alloc_workqueue(fmt, flags, 1, ##__VA_ARGS__)
+void destroy_workqueue(struct workqueue_struct *wq);
+bool queue_work(struct workqueue_struct *wq, struct work_struct *work);
+bool queue_delayed_work(struct workqueue_struct *wq, struct delayed_work *dw, unsigned long delay);
+bool mod_delayed_work(struct workqueue_struct *wq, struct delayed_work *dw, unsigned long delay);
+static inline bool schedule_work(struct work_struct *w) { return queue_work(system_wq, w); }
+static inline bool schedule_delayed_work(struct delayed_work *dw, unsigned long delay)
+{
+    return queue_delayed_work(system_wq, dw, delay);
+}
+bool cancel_work_sync(struct work_struct *work);
+bool cancel_delayed_work(struct delayed_work *dw);
+static inline bool cancel_delayed_work_sync(struct delayed_work *dw) { return cancel_delayed_work(dw); }
+bool flush_work(struct work_struct *work);
+static inline bool flush_delayed_work(struct delayed_work *dw) { return flush_work(&dw->work); }
+
+enum hrtimer_restart { HRTIMER_NORESTART, HRTIMER_RESTART };
+enum hrtimer_mode { HRTIMER_MODE_ABS = 0, HRTIMER_MODE_REL = 1 };
+#define CLOCK_MONOTONIC 1
+#define CLOCK_BOOTTIME  7
+struct hrtimer {
+    enum hrtimer_restart (*function)(struct hrtimer *timer);
+    ktime_t kshim_expires;
+    struct hrtimer *kshim_next;
+    bool kshim_armed;
+};
+void hrtimer_init(struct hrtimer *t, int clock_id, enum hrtimer_mode mode);
+void hrtimer_start(struct hrtimer *t, ktime_t at, enum hrtimer_mode mode);
+int hrtimer_cancel(struct hrtimer *t);
+static inline int hrtimer_try_to_cancel(struct hrtimer *t) { return hrtimer_cancel(t); }
+u64 hrtimer_forward(struct hrtimer *t, ktime_t now, ktime_t interval);
+static inline u64 hrtimer_forward_now(struct hrtimer *t, ktime_t interval)
+{
+    return hrtimer_forward(t, kshim_now_ns(), interval);
+}
+static inline ktime_t hrtimer_get_expires(const struct hrtimer *t) { return t->kshim_expires; }
+
+/* 하네스용: 가상 시계를 t까지 돌리면서 그 사이 만기된 work/hrtimer를 시각 순서로 실행 */
+void kshim_run_until(u64 t);
+static inline void kshim_run_pending(void) { kshim_run_until(kshim_now_ns()); }
+int kshim_events_pending(void);
+
+// -------------------- 메모리 --------------------
+#define GFP_KERNEL 0u
+#define GFP_ATOMIC 1u
+#define __GFP_ZERO 0x100u
+#define PAGE_SHIFT 12
+#define PAGE_SIZE  (1UL << PAGE_SHIFT)
+void *kmalloc(size_t size, gfp_t gfp);
+void *kzalloc(size_t size, gfp_t gfp);
+void *kcalloc(size_t n, size_t size, gfp_t gfp);
+void kfree(const void *p);
+long kshim_kmalloc_live(void);   // 하네스: 아직 안 풀린 kmalloc/devm/페이지 수
+static inline void *vzalloc(unsigned long size) { return kzalloc(size, GFP_KERNEL); }
+static inline void vfree(const void *p) { kfree(p); }
+unsigned long __get_free_pages(gfp_t gfp, unsigned int order);
+void free_pages(unsigned long addr, unsigned int order);
+static inline int get_order(unsigned long size)
+{
+    return size <= PAGE_SIZE ? 0 : fls((unsigned int)((size - 1) >> PAGE_SHIFT));
+}
+static inline unsigned long __pa(const volatile void *p) { return (unsigned long)p; }
+
+/* user 포인터도 그냥 호스트 메모리 */
+static inline unsigned long copy_to_user(void *to, const void *from, unsigned long n) { memcpy(to, from, n); return 0; }
+static inline unsigned long copy_from_user(void *to, const void *from, unsigned long n) { memcpy(to, from, n); return 0; }
+#define put_user(x, p) ({ *(p) = (x); 0; })
+#define get_user(x, p) ({ (x) = *(p); 0; })
+
+// -------------------- device model --------------------
+struct device_node;
+struct device_driver;
+struct kshim_devres;
+struct class;
+
+struct device {
+    struct device *parent;
+    struct device_driver *driver;
+    struct device_node *of_node;
+    void *platform_data;
+    void *driver_data;
+    dev_t devt;
+    char kshim_name[48];
+    struct kshim_devres *kshim_devres;   // devm 자원 (등록 역순으로 해제)
+    int kshim_refs;                      // get_device/put_device
+    struct class *kshim_class;           // device_create로 만든 것
+    int kshim_bus;                       // KSHIM_BUS_*
+    bool kshim_deferred;                 // 마지막 probe가 -EPROBE_DEFER
+};
+enum { KSHIM_BUS_NONE, KSHIM_BUS_PLATFORM, KSHIM_BUS_I2C };
+struct device_driver {
+    const char *name;
+    const struct of_device_id *of_match_table;
+};
+struct of_device_id {
+    char compatible[128];
+    const void *data;
+};
+struct attribute {
+    const char *name;
+    umode_t mode;
+};
+struct device_attribute {
+    struct attribute attr;
+    ssize_t (*show)(struct device *dev, struct device_attribute *attr, char *buf);
+    ssize_t (*store)(struct device *dev, struct device_attribute *attr, const char *buf, size_t count);
+};
+struct attribute_group {
+    const char *name;
+    struct attribute **attrs;
+};
+#define __ATTR(n, m, s, st) { .attr = { .name = #n, .mode = (m) }, .show = (s), .store = (st) }
+#define DEVICE_ATTR_RO(n) struct device_attribute dev_attr_##n = __ATTR(n, 0444, n##_show, NULL)
+#define DEVICE_ATTR_RW(n) struct device_attribute dev_attr_##n = __ATTR(n, 0644, n##_show, n##_store)
+#define DEVICE_ATTR_WO(n) struct device_attribute dev_attr_##n = __ATTR(n, 0200, NULL, n##_store)
+#define ATTRIBUTE_GROUPS(n) \
+    static const struct attribute_group n##_group = { .attrs = n##_attrs }; \
+    static const struct attribute_group *n##_groups[] = { &n##_group, NULL }
+
+static inline const char *dev_name(const struct device *dev) { return dev ? dev->kshim_name : "(null)"; }
+static inline void *dev_get_drvdata(const struct device *dev) { return dev->driver_data; }
+static inline void dev_set_drvdata(struct device *dev, void *data) { dev->driver_data = data; }
+static inline void *dev_get_platdata(const struct device *dev) { return dev->platform_data; }
+struct device *get_device(struct device *dev);
+void put_device(struct device *dev);
+
+void *devm_kzalloc(struct device *dev, size_t size, gfp_t gfp);
+int devm_add_action_or_reset(struct device *dev, void (*action)(void *), void *data);
+void *devres_open_group(struct device *dev, void *id, gfp_t gfp);
+void devres_close_group(struct device *dev, void *id);
+int devres_release_group(struct device *dev, void *id);
+
+struct device_link;
+#define DL_FLAG_AUTOREMOVE_CONSUMER (1 << 2)
+struct device_link *device_link_add(struct device *consumer, struct device *supplier, u32 flags);
+
+struct device *driver_find_device_by_name(struct device_driver *drv, const char *name);
+struct device *driver_find_device_by_of_node(struct device_driver *drv, const struct device_node *np);
+static inline struct device_node *of_parse_phandle(const struct device_node *np, const char *name, int i)
+{
+    (void)np; (void)name; (void)i;
+    return NULL;
+}
+static inline void of_node_put(struct device_node *np) { (void)np; }
+static inline int device_property_read_u32(const struct device *dev, const char *prop, u32 *val)
+{
+    (void)dev; (void)prop; (void)val;
+    return -EINVAL;
+}
+
+struct ida {
+    unsigned long long used;
+};
+#define DEFINE_IDA(name) struct ida name = { 0 }
+int ida_alloc_max(struct ida *ida, unsigned int max, gfp_t gfp);
+void ida_free(struct ida *ida, unsigned int id);
+
+// -------------------- chrdev / class / fs --------------------
+#define MINORBITS 20
+#define MKDEV(ma, mi) (((ma) << MINORBITS) | (mi))
+#define MAJOR(dev) ((unsigned int)((dev) >> MINORBITS))
+#define MINOR(dev) ((unsigned int)((dev) & ((1U << MINORBITS) - 1)))
+
+/* kobject: 참조 수만. 0이 되면 release (cdev_alloc한 cdev의 메모리) */
+struct kobject {
+    int refs;
+    void (*release)(struct kobject *kobj);
+};
+static inline struct kobject *kobject_get(struct kobject *kobj) { kobj->refs++; return kobj; }
+void kobject_put(struct kobject *kobj);
+
+struct kref {
+    int refcount;
+};
+static inline void kref_init(struct kref *kref) { kref->refcount = 1; }
+static inline void kref_get(struct kref *kref) { kref->refcount++; }
+static inline int kref_put(struct kref *kref, void (*release)(struct kref *kref))
+{
+    if (--kref->refcount)
+        return 0;
+    release(kref);
+    return 1;
+}
+
+struct inode;
+struct file_operations;
+struct cdev {
+    struct kobject kobj;      // 열린 파일이 잡고 있는 동안 cdev는 살아 있다
+    struct module *owner;
+    const struct file_operations *ops;
+    dev_t dev;
+    unsigned int count;
+    struct cdev *kshim_next;
+};
+struct inode {
+    struct cdev *i_cdev;
+    dev_t i_rdev;
+    void *i_private;      // debugfs 파일의 data
+};
+static inline unsigned int iminor(const struct inode *inode) { return MINOR(inode->i_rdev); }
+struct file {
+    const struct file_operations *f_op;
+    unsigned int f_flags;
+    unsigned int f_mode;
+    loff_t f_pos;
+    void *private_data;
+    struct inode *f_inode;
+};
+#define O_NONBLOCK 04000
+#define FMODE_READ   0x1
+#define FMODE_WRITE  0x2
+#define FMODE_LSEEK  0x4
+#define FMODE_PREAD  0x8
+#define FMODE_PWRITE 0x10
+#define FMODE_STREAM 0x200000
+static inline int stream_open(struct inode *inode, struct file *filp)
+{
+    (void)inode;
+    filp->f_mode &= ~(FMODE_LSEEK | FMODE_PREAD | FMODE_PWRITE);
+    filp->f_mode |= FMODE_STREAM;
+    return 0;
+}
+struct file_operations {
+    struct module *owner;
+    loff_t (*llseek)(struct file *, loff_t, int);
+    ssize_t (*read)(struct file *, char __user *, size_t, loff_t *);
+    ssize_t (*write)(struct file *, const char __user *, size_t, loff_t *);
+    __poll_t (*poll)(struct file *, poll_table *);
+    long (*unlocked_ioctl)(struct file *, unsigned int, unsigned long);
+    long (*compat_ioctl)(struct file *, unsigned int, unsigned long);
+    int (*open)(struct inode *, struct file *);
+    int (*release)(struct inode *, struct file *);
+};
+int alloc_chrdev_region(dev_t *dev, unsigned int baseminor, unsigned int count, const char *name);
+void unregister_chrdev_region(dev_t from, unsigned int count);
+void cdev_init(struct cdev *cdev, const struct file_operations *fops);
+struct cdev *cdev_alloc(void);
+int cdev_add(struct cdev *cdev, dev_t dev, unsigned int count);
+void cdev_del(struct cdev *cdev);
+struct cdev *kshim_cdev_lookup(dev_t dev);   // 하네스: 장치 번호로 fops 찾기
+
+struct class *class_create(struct module *owner, const char *name);
+void class_destroy(struct class *cls);
+__attribute__((format(printf, 5, 6)))
+struct device *device_create(struct class *cls, struct device *parent, dev_t devt, void *drvdata,
+                             const char *fmt, ...);
+__attribute__((format(printf, 6, 7)))
+struct device *device_create_with_groups(struct class *cls, struct device *parent, dev_t devt,
+                                         void *drvdata, const struct attribute_group **groups,
+                                         const char *fmt, ...);
+void device_destroy(struct class *cls, dev_t devt);
+struct device *kshim_class_find(const char *name);          // 하네스: class device 찾기
+ssize_t kshim_sysfs_show(struct device *dev, const char *attr, char *buf);   // 하네스: sysfs 읽기
+
+long compat_ptr_ioctl(struct file *file, unsigned int cmd, unsigned long arg);
+static inline loff_t noop_llseek(struct file *f, loff_t off, int whence) { (void)whence; return f->f_pos; }
+static inline int simple_open(struct inode *inode, struct file *file)
+{
+    file->private_data = inode->i_private;
+    return 0;
+}
+
+#define _IOC_NRBITS   8
+#define _IOC_TYPEBITS 8
+#define _IOC_SIZEBITS 14
+#define _IOC_NRSHIFT   0
+#define _IOC_TYPESHIFT (_IOC_NRSHIFT + _IOC_NRBITS)
+#define _IOC_SIZESHIFT (_IOC_TYPESHIFT + _IOC_TYPEBITS)
+#define _IOC_DIRSHIFT  (_IOC_SIZESHIFT + _IOC_SIZEBITS)
+#define _IOC_NONE  0U
+#define _IOC_WRITE 1U
+#define _IOC_READ  2U
+#define _IOC(dir, type, nr, size) \
+    (((dir) << _IOC_DIRSHIFT) | ((type) << _IOC_TYPESHIFT) | ((nr) << _IOC_NRSHIFT) | ((size) << _IOC_SIZESHIFT))
+#define _IO(type, nr)          _IOC(_IOC_NONE, (type), (nr), 0)
+#define _IOR(type, nr, t)      _IOC(_IOC_READ, (type), (nr), sizeof(t))
+#define _IOW(type, nr, t)      _IOC(_IOC_WRITE, (type), (nr), sizeof(t))
+#define _IOWR(type, nr, t)     _IOC(_IOC_READ | _IOC_WRITE, (type), (nr), sizeof(t))
+
+// -------------------- seq_file / debugfs --------------------
+struct seq_file {
+    char *buf;
+    size_t size, count;
+    void *private;
+};
+__attribute__((format(printf, 2, 3))) void seq_printf(struct seq_file *m, const char *fmt, ...);
+int single_open(struct file *file, int (*show)(struct seq_file *, void *), void *data);
+int single_release(struct inode *inode, struct file *file);
+ssize_t seq_read(struct file *file, char __user *buf, size_t size, loff_t *ppos);
+loff_t seq_lseek(struct file *file, loff_t off, int whence);
+#define DEFINE_SHOW_ATTRIBUTE(__name) \
+static int __name##_open(struct inode *inode, struct file *file) \
+{ \
+    return single_open(file, __name##_show, inode->i_private); \
+} \
+static const struct file_operations __name##_fops = { \
+    .owner   = THIS_MODULE, \
+    .open    = __name##_open, \
+    .read    = seq_read, \
+    .llseek  = seq_lseek, \
+    .release = single_release, \
+}
+struct dentry;
+struct dentry *debugfs_create_dir(const char *name, struct dentry *parent);
+struct dentry *debugfs_create_file(const char *name, umode_t mode, struct dentry *parent, void *data,
+                                   const struct file_operations *fops);
+void debugfs_remove_recursive(struct dentry *d);
+/* 하네스: debugfs 파일 내용을 buf로 (show 한 번) */
+ssize_t kshim_debugfs_read(const char *path, char *buf, size_t size);
+
+// -------------------- platform bus --------------------
+struct platform_device {
+    const char *name;
+    int id;
+    struct device dev;
+    struct platform_device *kshim_next;
+};
+struct platform_driver {
+    int (*probe)(struct platform_device *pdev);
+    int (*remove)(struct platform_device *pdev);
+    struct device_driver driver;
+    struct platform_driver *kshim_next;
+};
+int platform_driver_register(struct platform_driver *drv);
+void platform_driver_unregister(struct platform_driver *drv);
+struct platform_device *platform_device_register_data(struct device *parent, const char *name, int id,
+                                                      const void *data, size_t size);
+void platform_device_unregister(struct platform_device *pdev);
+static inline void *platform_get_drvdata(const struct platform_device *pdev) { return dev_get_drvdata(&pdev->dev); }
+static inline void platform_set_drvdata(struct platform_device *pdev, void *data) { dev_set_drvdata(&pdev->dev, data); }
+
+// -------------------- GPIO (→ sim) --------------------
+struct gpio_desc {
+    int pin;
+};
+struct gpio_array;
+enum gpiod_flags {
+    GPIOD_ASIS = 0,
+    GPIOD_IN = 1,
+    GPIOD_OUT_LOW = 3,
+    GPIOD_OUT_HIGH = 7,
+};
+#define GPIOF_OUT_INIT_LOW  0
+#define GPIOF_IN            1
+#define GPIOF_OUT_INIT_HIGH 2
+struct gpio_desc *gpio_to_desc(unsigned int gpio);
+int devm_gpio_request_one(struct device *dev, unsigned int gpio, unsigned long flags, const char *label);
+struct gpio_desc *devm_gpiod_get(struct device *dev, const char *con_id, enum gpiod_flags flags);
+int gpiod_direction_input(struct gpio_desc *desc);
+int gpiod_direction_output(struct gpio_desc *desc, int value);
+int gpiod_get_value(const struct gpio_desc *desc);
+void gpiod_set_value(struct gpio_desc *desc, int value);
+int gpiod_set_array_value(unsigned int n, struct gpio_desc **descs, struct gpio_array *info,
+                          unsigned long *values);
+int gpiod_to_irq(const struct gpio_desc *desc);
+
+// -------------------- IRQ (→ sim 에지) --------------------
+typedef int irqreturn_t;
+#define IRQ_NONE        0
+#define IRQ_HANDLED     1
+#define IRQ_WAKE_THREAD 2
+typedef irqreturn_t (*irq_handler_t)(int irq, void *dev_id);
+#define IRQF_TRIGGER_RISING  0x00000001
+#define IRQF_TRIGGER_FALLING 0x00000002
+#define IRQF_ONESHOT         0x00002000
+int devm_request_irq(struct device *dev, unsigned int irq, irq_handler_t handler,
+                     unsigned long flags, const char *name, void *dev_id);
+int request_irq(unsigned int irq, irq_handler_t handler, unsigned long flags, const char *name,
+                void *dev_id);
+void free_irq(unsigned int irq, void *dev_id);
+void enable_irq(unsigned int irq);
+void disable_irq(unsigned int irq);
+static inline void disable_irq_nosync(unsigned int irq) { disable_irq(irq); }
+
+// -------------------- I2C (→ sim SSD1306) --------------------
+#define I2C_M_RD      0x0001
+#define I2C_M_NOSTART 0x4000
+#define I2C_FUNC_I2C               0x00000001
+#define I2C_FUNC_PROTOCOL_MANGLING 0x00000004
+#define I2C_FUNC_NOSTART           0x00000010
+struct i2c_msg {
+    u16 addr;
+    u16 flags;
+    u16 len;
+    u8 *buf;
+};
+struct i2c_adapter_quirks {
+    u64 flags;
+    int max_num_msgs;
+    u16 max_write_len;
+    u16 max_read_len;
+    u16 max_comb_1st_msg_len;
+    u16 max_comb_2nd_msg_len;
+};
+struct i2c_adapter {
+    int nr;
+    u32 functionality;
+    const struct i2c_adapter_quirks *quirks;
+    struct device dev;
+};
+struct i2c_client {
+    unsigned short flags;
+    unsigned short addr;
+    char name[20];
+    struct i2c_adapter *adapter;
+    struct device dev;
+    struct i2c_client *kshim_next;
+};
+struct i2c_board_info {
+    char type[20];
+    unsigned short flags;
+    unsigned short addr;
+    const void *platform_data;
+};
+#define I2C_BOARD_INFO(dev_type, dev_addr) .type = dev_type, .addr = (dev_addr)
+struct i2c_device_id {
+    char name[20];
+    unsigned long driver_data;
+};
+struct i2c_driver {
+    struct device_driver driver;
+    int (*probe_new)(struct i2c_client *client);
+    void (*remove)(struct i2c_client *client);
+    const struct i2c_device_id *id_table;
+    struct i2c_driver *kshim_next;
+};
+struct i2c_adapter *i2c_get_adapter(int nr);
+void i2c_put_adapter(struct i2c_adapter *adap);
+static inline u32 i2c_get_functionality(struct i2c_adapter *adap) { return adap->functionality; }
+static inline int i2c_check_functionality(struct i2c_adapter *adap, u32 func)
+{
+    return (adap->functionality & func) == func;
+}
+int i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num);
+int i2c_master_send(const struct i2c_client *client, const char *buf, int count);
+struct i2c_client *i2c_new_client_device(struct i2c_adapter *adap, struct i2c_board_info const *info);
+void i2c_unregister_device(struct i2c_client *client);
+int i2c_add_driver(struct i2c_driver *drv);
+/* 하네스: 버스 nr에 어댑터를 만든다 (functionality/quirks는 실제 컨트롤러 흉내) */
+struct i2c_adapter *kshim_i2c_add_adapter(int nr, u32 functionality,
+                                          const struct i2c_adapter_quirks *quirks);
+void kshim_i2c_del_adapter(struct i2c_adapter *adap);
+void i2c_del_driver(struct i2c_driver *drv);
+static inline void i2c_set_clientdata(struct i2c_client *c, void *data) { dev_set_drvdata(&c->dev, data); }
+static inline void *i2c_get_clientdata(const struct i2c_client *c) { return dev_get_drvdata(&c->dev); }
+
+// -------------------- RTC class --------------------
+struct rtc_time {
+    int tm_sec, tm_min, tm_hour, tm_mday, tm_mon, tm_year, tm_wday, tm_yday, tm_isdst;
+};
+struct rtc_wkalrm {
+    unsigned char enabled;
+    unsigned char pending;
+    struct rtc_time time;
+};
+struct rtc_class_ops {
+    int (*ioctl)(struct device *, unsigned int, unsigned long);
+    int (*read_time)(struct device *, struct rtc_time *);
+    int (*set_time)(struct device *, struct rtc_time *);
+    int (*read_alarm)(struct device *, struct rtc_wkalrm *);
+    int (*set_alarm)(struct device *, struct rtc_wkalrm *);
+    int (*alarm_irq_enable)(struct device *, unsigned int enabled);
+};
+struct rtc_device {
+    struct device dev;
+    const struct rtc_class_ops *ops;
+    time64_t range_min;
+    u64 range_max;
+    unsigned long kshim_irq_events;   // rtc_update_irq 횟수
+};
+#define RTC_IRQF 0x80
+#define RTC_PF   0x40
+#define RTC_AF   0x20
+#define RTC_UF   0x10
+#define RTC_TIMESTAMP_BEGIN_2000 946684800LL
+#define RTC_TIMESTAMP_END_2099   4102444799LL
+struct rtc_device *devm_rtc_allocate_device(struct device *dev);
+int devm_rtc_register_device(struct rtc_device *rtc);
+void rtc_update_irq(struct rtc_device *rtc, unsigned long num, unsigned long events);
+void rtc_time64_to_tm(time64_t time, struct rtc_time *tm);
+time64_t rtc_tm_to_time64(struct rtc_time *tm);
+struct rtc_device *kshim_rtc_find(struct device *parent);   // 하네스
+
+// -------------------- nvmem --------------------
+enum nvmem_type {
+    NVMEM_TYPE_UNKNOWN = 0,
+    NVMEM_TYPE_EEPROM,
+    NVMEM_TYPE_OTP,
+    NVMEM_TYPE_BATTERY_BACKED,
+    NVMEM_TYPE_FRAM,
+};
+#define NVMEM_DEVID_NONE (-1)
+#define NVMEM_DEVID_AUTO (-2)
+typedef int (*nvmem_reg_read_t)(void *priv, unsigned int offset, void *val, size_t bytes);
+typedef int (*nvmem_reg_write_t)(void *priv, unsigned int offset, void *val, size_t bytes);
+struct nvmem_config {
+    struct device *dev;
+    const char *name;
+    int id;
+    struct module *owner;
+    enum nvmem_type type;
+    bool read_only;
+    bool root_only;
+    nvmem_reg_read_t reg_read;
+    nvmem_reg_write_t reg_write;
+    int size;
+    int word_size;
+    int stride;
+    void *priv;
+};
+struct nvmem_device;
+struct nvmem_device *devm_nvmem_register(struct device *dev, const struct nvmem_config *cfg);
+/* 하네스: /sys/bus/nvmem/devices/<name>/nvmem 읽기/쓰기 흉내 */
+int kshim_nvmem_rw(const char *name, bool write, unsigned int off, void *buf, size_t len);
+
+// -------------------- hwmon --------------------
+enum hwmon_sensor_types {
+    hwmon_chip,
+    hwmon_temp,
+    hwmon_in,
+    hwmon_curr,
+    hwmon_power,
+    hwmon_energy,
+    hwmon_humidity,
+    hwmon_fan,
+    hwmon_pwm,
+    hwmon_intrusion,
+    hwmon_max,
+};
+enum hwmon_chip_attributes {
+    hwmon_chip_temp_reset_history,
+    hwmon_chip_in_reset_history,
+    hwmon_chip_curr_reset_history,
+    hwmon_chip_power_reset_history,
+    hwmon_chip_register_tz,
+    hwmon_chip_update_interval,
+    hwmon_chip_alarms,
+};
+enum hwmon_temp_attributes {
+    hwmon_temp_enable,
+    hwmon_temp_input,
+    hwmon_temp_type,
+    hwmon_temp_lcrit,
+    hwmon_temp_min,
+    hwmon_temp_max,
+    hwmon_temp_crit,
+};
+enum hwmon_humidity_attributes {
+    hwmon_humidity_enable,
+    hwmon_humidity_input,
+    hwmon_humidity_label,
+    hwmon_humidity_min,
+    hwmon_humidity_max,
+};
+#define HWMON_C_UPDATE_INTERVAL BIT(hwmon_chip_update_interval)
+#define HWMON_T_INPUT           BIT(hwmon_temp_input)
+#define HWMON_H_INPUT           BIT(hwmon_humidity_input)
+
+struct hwmon_ops {
+    umode_t (*is_visible)(const void *drvdata, enum hwmon_sensor_types type, u32 attr, int channel);
+    int (*read)(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel, long *val);
+    int (*read_string)(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel,
+                       const char **str);
+    int (*write)(struct device *dev, enum hwmon_sensor_types type, u32 attr, int channel, long val);
+};
+struct hwmon_channel_info {
+    enum hwmon_sensor_types type;
+    const u32 *config;
+};
+#define HWMON_CHANNEL_INFO(stype, ...) \
+    (&(struct hwmon_channel_info) { .type = hwmon_##stype, .config = (u32 []) { __VA_ARGS__, 0 } })
+struct hwmon_chip_info {
+    const struct hwmon_ops *ops;
+    const struct hwmon_channel_info **info;
+};
+struct device *devm_hwmon_device_register_with_info(struct device *dev, const char *name, void *drvdata,
+                                                    const struct hwmon_chip_info *info,
+                                                    const struct attribute_group **extra_groups);
+/* 하네스: /sys/class/hwmon/hwmonN/<attr> 읽기/쓰기 흉내. hwmon은 부모 장치 이름으로 찾는다 */
+int kshim_hwmon_rw(const char *parent, const char *attr, bool write, long *val);
+
+// -------------------- fbdev --------------------
+struct fb_bitfield {
+    u32 offset, length, msb_right;
+};
+struct fb_fix_screeninfo {
+    char id[16];
+    unsigned long smem_start;
+    u32 smem_len;
+    u32 type, visual;
+    u16 xpanstep, ypanstep, ywrapstep;
+    u32 line_length;
+    u32 accel;
+};
+struct fb_var_screeninfo {
+    u32 xres, yres, xres_virtual, yres_virtual, bits_per_pixel;
+    struct fb_bitfield red, green, blue, transp;
+};
+struct fb_fillrect { u32 dx, dy, width, height, color, rop; };
+struct fb_copyarea { u32 dx, dy, width, height, sx, sy; };
+struct fb_image { u32 dx, dy, width, height, fg_color, bg_color; u8 depth; const char *data; };
+struct fb_info;
+struct vm_area_struct;
+struct fb_deferred_io_pageref {
+    unsigned long offset;
+    struct list_head list;
+};
+struct fb_deferred_io {
+    unsigned long delay;
+    void (*deferred_io)(struct fb_info *info, struct list_head *pagereflist);
+};
+struct fb_ops {
+    struct module *owner;
+    int (*fb_open)(struct fb_info *info, int user);
+    int (*fb_release)(struct fb_info *info, int user);
+    ssize_t (*fb_read)(struct fb_info *info, char __user *buf, size_t count, loff_t *ppos);
+    ssize_t (*fb_write)(struct fb_info *info, const char __user *buf, size_t count, loff_t *ppos);
+    void (*fb_fillrect)(struct fb_info *info, const struct fb_fillrect *rect);
+    void (*fb_copyarea)(struct fb_info *info, const struct fb_copyarea *region);
+    void (*fb_imageblit)(struct fb_info *info, const struct fb_image *image);
+    int (*fb_mmap)(struct fb_info *info, struct vm_area_struct *vma);
+};
+struct fb_info {
+    int node;
+    int flags;
+    struct fb_var_screeninfo var;
+    struct fb_fix_screeninfo fix;
+    const struct fb_ops *fbops;
+    struct device *device;
+    struct fb_deferred_io *fbdefio;
+    union {
+        char __iomem *screen_base;
+        char *screen_buffer;
+    };
+    unsigned long screen_size;
+    void *par;
+};
+#define FBINFO_VIRTFB          0x0004
+#define FB_TYPE_PACKED_PIXELS  0
+#define FB_VISUAL_MONO10       1
+#define FB_ACCEL_NONE          0
+struct fb_info *framebuffer_alloc(size_t size, struct device *dev);
+void framebuffer_release(struct fb_info *info);
+int register_framebuffer(struct fb_info *info);
+void unregister_framebuffer(struct fb_info *info);
+int fb_deferred_io_init(struct fb_info *info);
+void fb_deferred_io_cleanup(struct fb_info *info);
+int fb_deferred_io_mmap(struct fb_info *info, struct vm_area_struct *vma);
+ssize_t fb_sys_read(struct fb_info *info, char __user *buf, size_t count, loff_t *ppos);
+ssize_t fb_sys_write(struct fb_info *info, const char __user *buf, size_t count, loff_t *ppos);
+void sys_fillrect(struct fb_info *info, const struct fb_fillrect *rect);
+void sys_copyarea(struct fb_info *info, const struct fb_copyarea *area);
+void sys_imageblit(struct fb_info *info, const struct fb_image *image);
+struct fb_info *kshim_fb_get(int node);   // 하네스: /dev/fbN
+
+// -------------------- tracepoint: 호스트에서는 항상 꺼짐 --------------------
+#define TP_PROTO(...) __VA_ARGS__
+#define TP_ARGS(...)  __VA_ARGS__
+#define TRACE_EVENT(name, proto, args, tstruct, assign, print) \
+    static inline void trace_##name(proto) { } \
+    static inline bool trace_##name##_enabled(void) { return false; }
+
+#endif /* KSHIM_H */
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * 호스트 빌드용 KUnit 최소 구현: 드라이버 끝에서 include되는 *_test.c를 그대로 돌린다.
+ * suite는 constructor로 등록되고 kshim_kunit_run()이 TAP 비슷하게 결과를 찍는다.
+ */
+#ifndef KSHIM_KUNIT_TEST_H
+#define KSHIM_KUNIT_TEST_H
+
+#include "../kshim.h"
+
+#define KSHIM_KUNIT_MAX_ALLOCS 32
+
+struct kunit {
+    const char *name;
+    int failures;
+    void *allocs[KSHIM_KUNIT_MAX_ALLOCS];   // kunit_kzalloc: 케이스 끝나면 해제
+    int nallocs;
+};
+
+struct kunit_case {
+    void (*run_case)(struct kunit *test);
+    const char *name;
+};
+
+struct kunit_suite {
+    const char *name;
+    struct kunit_case *test_cases;
+};
+
+#define KUNIT_CASE(test_name) { .run_case = test_name, .name = #test_name }
+
+void kshim_kunit_register(struct kunit_suite *suite);
+int kshim_kunit_run(const char *filter);   // 실패한 케이스 수
+#define kunit_test_suite(suite) \
+    static void __attribute__((constructor)) kshim_kunit_reg_##suite(void) \
+    { \
+        kshim_kunit_register(&suite); \
+    }
+
+void *kunit_kzalloc(struct kunit *test, size_t size, gfp_t gfp);
+__attribute__((format(printf, 2, 3))) void kunit_info(struct kunit *test, const char *fmt, ...);
+__attribute__((format(printf, 4, 5)))
+void kshim_kunit_fail(struct kunit *test, const char *file, int line, const char *fmt, ...);
+
+#define KSHIM_KUNIT_BINARY(test, a, op, b, on_fail, ...) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if (!(_a op _b)) { \
+        kshim_kunit_fail(test, __FILE__, __LINE__, "%s %s %s (%lld vs %lld)", #a, #op, #b, _a, _b); \
+        on_fail; \
+    } \
+} while (0)
+
+#define KUNIT_EXPECT_EQ(test, a, b) KSHIM_KUNIT_BINARY(test, a, ==, b, (void)0)
+#define KUNIT_EXPECT_NE(test, a, b) KSHIM_KUNIT_BINARY(test, a, !=, b, (void)0)
+#define KUNIT_EXPECT_LE(test, a, b) KSHIM_KUNIT_BINARY(test, a, <=, b, (void)0)
+#define KUNIT_EXPECT_LT(test, a, b) KSHIM_KUNIT_BINARY(test, a, <, b, (void)0)
+#define KUNIT_EXPECT_GE(test, a, b) KSHIM_KUNIT_BINARY(test, a, >=, b, (void)0)
+#define KUNIT_EXPECT_GT(test, a, b) KSHIM_KUNIT_BINARY(test, a, >, b, (void)0)
+#define KUNIT_ASSERT_EQ(test, a, b) KSHIM_KUNIT_BINARY(test, a, ==, b, return)
+#define KUNIT_EXPECT_TRUE(test, c)  KSHIM_KUNIT_BINARY(test, !!(c), ==, 1, (void)0)
+#define KUNIT_EXPECT_FALSE(test, c) KSHIM_KUNIT_BINARY(test, !!(c), ==, 0, (void)0)
+#define KUNIT_EXPECT_EQ_MSG(test, a, b, fmt, ...) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if (_a != _b) \
+        kshim_kunit_fail(test, __FILE__, __LINE__, "%s == %s (%lld vs %lld): " fmt, \
+                         #a, #b, _a, _b, ##__VA_ARGS__); \
+} while (0)
+#define KUNIT_EXPECT_STREQ(test, a, b) do { \
+    const char *_a = (a), *_b = (b); \
+    if (strcmp(_a, _b)) \
+        kshim_kunit_fail(test, __FILE__, __LINE__, "%s == %s (\"%s\" vs \"%s\")", #a, #b, _a, _b); \
+} while (0)
+#define KUNIT_ASSERT_NOT_ERR_OR_NULL(test, p) do { \
+    if (IS_ERR_OR_NULL(p)) { \
+        kshim_kunit_fail(test, __FILE__, __LINE__, "%s is NULL or error", #p); \
+        return; \
+    } \
+} while (0)
+
+#endif /* KSHIM_KUNIT_TEST_H */
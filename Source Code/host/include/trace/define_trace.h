@@ -0,0 +1 @@
+/* 호스트 빌드: tracepoint는 kshim.h에서 빈 함수로 만들어지므로 여기서 할 일 없음 */
@@ -0,0 +1,2530 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * 호스트 빌드용 커널 API 구현 (kshim.h 참고).
+ *
+ * 드라이버가 부르는 커널 함수를 user space에서 흉내 낸다. 하드웨어 쪽(gpiod/i2c/지연)은
+ * sim.c의 가상 장치로 보내고, 나머지(devm, 버스 매칭, workqueue, cdev, sysfs, debugfs,
+ * RTC/nvmem/fbdev 등록)는 드라이버가 기대하는 순서와 의미만 맞춘다.
+ * 드라이버 쪽 실수(락 짝, IRQ enable 짝, 요청 안 한 GPIO)는 kshim_bug로 바로 멈춘다.
+ */
+#include <ctype.h>
+
+#include "kshim.h"
+#include "kunit/test.h"
+#include "sim.h"
+
+// <stdlib.h>는 sys/types.h를 끌고 와서 커널 dev_t/loff_t와 겹치므로 필요한 것만
+void *malloc(size_t size);
+void *calloc(size_t n, size_t size);
+void *aligned_alloc(size_t align, size_t size);
+void free(void *p);
+__attribute__((noreturn)) void abort(void);
+
+unsigned long long host_mono_ns(void);   // host_clock.c
+
+static void klog(int level, const char *msg);
+
+// -------------------- printk --------------------
+#define KSHIM_DEFAULT_LEVEL 4   // 레벨 없는 printk = KERN_WARNING (커널 기본값)
+
+static int console_level = 5;
+
+void kshim_set_loglevel(int level)
+{
+    console_level = level;
+}
+
+static int split_level(const char **fmt)
+{
+    const char *f = *fmt;
+
+    if (f[0] == KERN_SOH[0] && f[1] >= '0' && f[1] <= '7') {
+        *fmt = f + 2;
+        return f[1] - '0';
+    }
+    return KSHIM_DEFAULT_LEVEL;
+}
+
+static void klog(int level, const char *msg)
+{
+    u64 now = kshim_now_ns();
+    size_t n = strlen(msg);
+
+    if (level >= console_level)
+        return;
+    fprintf(stderr, "[%5llu.%06llu] %s%s", now / NSEC_PER_SEC, (now % NSEC_PER_SEC) / NSEC_PER_USEC,
+            msg, (n && msg[n - 1] == '\n') ? "" : "\n");
+}
+
+int printk(const char *fmt, ...)
+{
+    char buf[512];
+    va_list ap;
+    int level = split_level(&fmt);
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    klog(level, buf);
+    return n;
+}
+
+static const char *dev_driver_string(const struct device *dev)
+{
+    if (!dev)
+        return "";
+    if (dev->driver)
+        return dev->driver->name;
+    if (dev->kshim_bus == KSHIM_BUS_PLATFORM)
+        return "platform";
+    if (dev->kshim_bus == KSHIM_BUS_I2C)
+        return "i2c";
+    return "";
+}
+
+void kshim_dev_printk(const char *level, const struct device *dev, const char *fmt, ...)
+{
+    char msg[512], line[600];
+    va_list ap;
+    int lv = split_level(&level);
+
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    snprintf(line, sizeof(line), "%s %s: %s", dev_driver_string(dev), dev_name(dev), msg);
+    klog(lv, line);
+}
+
+void kshim_bug(const char *fmt, ...)
+{
+    va_list ap;
+
+    fprintf(stderr, "kshim BUG: ");
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fprintf(stderr, "\n");
+    abort();
+}
+
+// -------------------- 문자열 --------------------
+int scnprintf(char *buf, size_t size, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (!size)
+        return 0;
+    va_start(ap, fmt);
+    n = vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return 0;
+    return (size_t)n >= size ? (int)size - 1 : n;
+}
+
+int sysfs_emit(char *buf, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(buf, PAGE_SIZE, fmt, ap);
+    va_end(ap);
+    return n >= (int)PAGE_SIZE ? (int)PAGE_SIZE - 1 : n;
+}
+
+ssize_t strscpy(char *dst, const char *src, size_t size)
+{
+    size_t len;
+
+    if (!size)
+        return -E2BIG;
+    len = strnlen(src, size);
+    if (len == size) {
+        memcpy(dst, src, size - 1);
+        dst[size - 1] = '\0';
+        return -E2BIG;
+    }
+    memcpy(dst, src, len + 1);
+    return len;
+}
+
+char *strim(char *s)
+{
+    size_t n;
+
+    while (isspace((unsigned char)*s))
+        s++;
+    n = strlen(s);
+    while (n && isspace((unsigned char)s[n - 1]))
+        s[--n] = '\0';
+    return s;
+}
+
+void *memchr_inv(const void *p, int c, size_t n)
+{
+    const u8 *b = p;
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        if (b[i] != (u8)c)
+            return (void *)(b + i);
+    return NULL;
+}
+
+/* 커널 _parse_integer와 같은 규칙: 끝에 '\n' 하나는 허용, 나머지 찌꺼기는 -EINVAL */
+static int parse_ull(const char *s, unsigned int base, unsigned long long *res)
+{
+    unsigned long long v = 0;
+    bool any = false;
+
+    if (base == 0) {
+        if (s[0] == '0' && (s[1] | 0x20) == 'x' && isxdigit((unsigned char)s[2])) {
+            base = 16;
+            s += 2;
+        } else {
+            base = s[0] == '0' ? 8 : 10;
+        }
+    } else if (base == 16 && s[0] == '0' && (s[1] | 0x20) == 'x') {
+        s += 2;
+    }
+    for (; *s; s++) {
+        unsigned int d;
+
+        if (*s >= '0' && *s <= '9')
+            d = *s - '0';
+        else if (isalpha((unsigned char)*s))
+            d = (*s | 0x20) - 'a' + 10;
+        else
+            break;
+        if (d >= base)
+            break;
+        if (v > (~0ULL - d) / base)
+            return -ERANGE;
+        v = v * base + d;
+        any = true;
+    }
+    if (!any)
+        return -EINVAL;
+    if (*s == '\n')
+        s++;
+    if (*s)
+        return -EINVAL;
+    *res = v;
+    return 0;
+}
+
+static int kstrtoull_(const char *s, unsigned int base, unsigned long long *res)
+{
+    if (*s == '+')
+        s++;
+    return parse_ull(s, base, res);
+}
+
+int kstrtoll(const char *s, unsigned int base, long long *res)
+{
+    unsigned long long v;
+    int ret;
+
+    if (*s == '-') {
+        ret = parse_ull(s + 1, base, &v);
+        if (ret)
+            return ret;
+        if (v > (unsigned long long)S64_MAX + 1)
+            return -ERANGE;
+        *res = -(long long)v;
+        return 0;
+    }
+    ret = kstrtoull_(s, base, &v);
+    if (ret)
+        return ret;
+    if (v > (unsigned long long)S64_MAX)
+        return -ERANGE;
+    *res = (long long)v;
+    return 0;
+}
+
+int kstrtol(const char *s, unsigned int base, long *res)
+{
+    long long v;
+    int ret = kstrtoll(s, base, &v);
+
+    if (!ret)
+        *res = (long)v;
+    return ret;
+}
+
+int kstrtoint(const char *s, unsigned int base, int *res)
+{
+    long long v;
+    int ret = kstrtoll(s, base, &v);
+
+    if (ret)
+        return ret;
+    if (v < -2147483648LL || v > 2147483647LL)
+        return -ERANGE;
+    *res = (int)v;
+    return 0;
+}
+
+int kstrtouint(const char *s, unsigned int base, unsigned int *res)
+{
+    unsigned long long v;
+    int ret = kstrtoull_(s, base, &v);
+
+    if (ret)
+        return ret;
+    if (v > U32_MAX)
+        return -ERANGE;
+    *res = (unsigned int)v;
+    return 0;
+}
+
+int kstrtobool(const char *s, bool *res)
+{
+    if (!s)
+        return -EINVAL;
+    switch (s[0]) {
+    case 'y': case 'Y': case '1':
+        *res = true;
+        return 0;
+    case 'n': case 'N': case '0':
+        *res = false;
+        return 0;
+    case 'o': case 'O':
+        if ((s[1] | 0x20) == 'n') {
+            *res = true;
+            return 0;
+        }
+        if ((s[1] | 0x20) == 'f') {
+            *res = false;
+            return 0;
+        }
+        break;
+    }
+    return -EINVAL;
+}
+
+int param_get_uint(char *buf, const struct kernel_param *kp)
+{
+    return sprintf(buf, "%u\n", *(unsigned int *)kp->arg);
+}
+
+int param_set_uint(const char *val, const struct kernel_param *kp)
+{
+    return kstrtouint(val, 0, kp->arg);
+}
+
+// -------------------- 시간 --------------------
+#define KSHIM_JIFFY_NS   (NSEC_PER_SEC / HZ)
+#define KSHIM_WALL_BASE  1735689600LL   // 2025-01-01 00:00:00 UTC: 가상 시계 0일 때의 벽시계
+
+static u64 vclock = 10ULL * NSEC_PER_SEC;   // 부팅 직후처럼 보이게 10초에서 시작
+static bool real_on;
+static u64 real_mark;
+
+u64 kshim_now_ns(void)
+{
+    if (real_on) {
+        u64 r = host_mono_ns();
+
+        vclock += r - real_mark;
+        real_mark = r;
+    }
+    return vclock;
+}
+
+void kshim_clock_real(bool on)
+{
+    kshim_now_ns();
+    real_on = on;
+    real_mark = host_mono_ns();
+}
+
+/* 가는 길에 장치가 스스로 선을 바꾸는 시각(DHT11 응답)마다 멈춰서 에지를 낸다 */
+void kshim_advance_ns(u64 ns)
+{
+    u64 end = kshim_now_ns() + ns;
+
+    for (;;) {
+        u64 e = sim_next_edge_ns(vclock);
+
+        if (e > end)
+            break;
+        if (e > vclock)
+            vclock = e;
+        sim_settle();
+    }
+    if (end > vclock)
+        vclock = end;
+    sim_settle();
+}
+
+ktime_t ktime_get_real(void)
+{
+    return KSHIM_WALL_BASE * NSEC_PER_SEC + (s64)kshim_now_ns();
+}
+
+time64_t ktime_get_real_seconds(void)
+{
+    return ktime_get_real() / NSEC_PER_SEC;
+}
+
+time64_t mktime64(unsigned int year0, unsigned int mon0, unsigned int day,
+                  unsigned int hour, unsigned int min, unsigned int sec)
+{
+    unsigned int mon = mon0, year = year0;
+
+    // 1..12 -> 11,12,1..10 (윤일을 해 끝으로)
+    if (0 >= (int)(mon -= 2)) {
+        mon += 12;
+        year -= 1;
+    }
+    return ((((time64_t)(year / 4 - year / 100 + year / 400 + 367 * mon / 12 + day) +
+              year * 365 - 719499) * 24 + hour) * 60 + min) * 60 + sec;
+}
+
+/* 1970-01-01부터의 일수 -> 연/월(1..12)/일 */
+static void civil_from_days(s64 z, long *y, int *m, int *d)
+{
+    s64 era, yy;
+    unsigned int doe, yoe, doy, mp;
+
+    z += 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = (unsigned int)(z - era * 146097);
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    yy = (s64)yoe + era * 400;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *m = mp < 10 ? (int)mp + 3 : (int)mp - 9;
+    *y = (long)(yy + (*m <= 2));
+}
+
+static s64 floor_div(s64 a, s64 b)
+{
+    s64 q = a / b;
+
+    return (a % b && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+void time64_to_tm(time64_t totalsecs, int offset, struct tm *result)
+{
+    s64 t = totalsecs + offset;
+    s64 days = floor_div(t, 86400);
+    s64 rem = t - days * 86400;
+    long y;
+    int m, d;
+
+    civil_from_days(days, &y, &m, &d);
+    result->tm_hour = (int)(rem / 3600);
+    result->tm_min = (int)(rem % 3600 / 60);
+    result->tm_sec = (int)(rem % 60);
+    result->tm_mday = d;
+    result->tm_mon = m - 1;
+    result->tm_year = y - 1900;
+    result->tm_wday = (int)(((days + 4) % 7 + 7) % 7);
+    result->tm_yday = (int)(days - floor_div(mktime64((unsigned int)y, 1, 1, 0, 0, 0), 86400));
+}
+
+void rtc_time64_to_tm(time64_t time, struct rtc_time *tm)
+{
+    struct tm t;
+
+    time64_to_tm(time, 0, &t);
+    tm->tm_sec = t.tm_sec;
+    tm->tm_min = t.tm_min;
+    tm->tm_hour = t.tm_hour;
+    tm->tm_mday = t.tm_mday;
+    tm->tm_mon = t.tm_mon;
+    tm->tm_year = (int)t.tm_year;
+    tm->tm_wday = t.tm_wday;
+    tm->tm_yday = t.tm_yday;
+    tm->tm_isdst = 0;
+}
+
+time64_t rtc_tm_to_time64(struct rtc_time *tm)
+{
+    return mktime64(tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+                    tm->tm_hour, tm->tm_min, tm->tm_sec);
+}
+
+// -------------------- 메모리 --------------------
+static long live_allocs;
+
+long kshim_kmalloc_live(void)
+{
+    return live_allocs;
+}
+
+void *kmalloc(size_t size, gfp_t gfp)
+{
+    void *p = (gfp & __GFP_ZERO) ? calloc(1, size ? size : 1) : malloc(size ? size : 1);
+
+    if (p)
+        live_allocs++;
+    return p;
+}
+
+void *kzalloc(size_t size, gfp_t gfp)
+{
+    return kmalloc(size, gfp | __GFP_ZERO);
+}
+
+void *kcalloc(size_t n, size_t size, gfp_t gfp)
+{
+    if (size && n > (size_t)-1 / size)
+        return NULL;
+    return kzalloc(n * size, gfp);
+}
+
+void kfree(const void *p)
+{
+    if (!p)
+        return;
+    live_allocs--;
+    free((void *)p);
+}
+
+unsigned long __get_free_pages(gfp_t gfp, unsigned int order)
+{
+    size_t size = PAGE_SIZE << order;
+    void *p = aligned_alloc(PAGE_SIZE, size);
+
+    (void)gfp;
+    if (!p)
+        return 0;
+    memset(p, 0, size);
+    live_allocs++;
+    return (unsigned long)p;
+}
+
+void free_pages(unsigned long addr, unsigned int order)
+{
+    (void)order;
+    if (!addr)
+        return;
+    live_allocs--;
+    free((void *)addr);
+}
+
+// -------------------- workqueue / hrtimer --------------------
+struct workqueue_struct {
+    char name[48];
+    unsigned int flags;
+    int max_active;
+};
+
+static struct workqueue_struct wq_events = { .name = "events" };
+static struct workqueue_struct wq_long = { .name = "events_long" };
+static struct workqueue_struct wq_highpri = { .name = "events_highpri", .flags = WQ_HIGHPRI };
+struct workqueue_struct *system_wq = &wq_events;
+struct workqueue_struct *system_long_wq = &wq_long;
+struct workqueue_struct *system_highpri_wq = &wq_highpri;
+
+static struct work_struct *works;    // 실행 시각 순서 (같으면 넣은 순서)
+static struct hrtimer *timers;       // 만기 순서
+static struct work_struct *running_work;
+
+struct workqueue_struct *alloc_workqueue(const char *fmt, unsigned int flags, int max_active, ...)
+{
+    struct workqueue_struct *wq = kzalloc(sizeof(*wq), GFP_KERNEL);
+    va_list ap;
+
+    if (!wq)
+        return NULL;
+    va_start(ap, max_active);
+    vsnprintf(wq->name, sizeof(wq->name), fmt, ap);
+    va_end(ap);
+    wq->flags = flags;
+    wq->max_active = max_active;
+    return wq;
+}
+
+static void work_insert(struct work_struct *w)
+{
+    struct work_struct **pp = &works;
+
+    while (*pp && (*pp)->kshim_due <= w->kshim_due)
+        pp = &(*pp)->kshim_next;
+    w->kshim_next = *pp;
+    *pp = w;
+    w->kshim_pending = true;
+}
+
+static bool work_remove(struct work_struct *w)
+{
+    struct work_struct **pp;
+
+    if (!w->kshim_pending)
+        return false;
+    for (pp = &works; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == w) {
+            *pp = w->kshim_next;
+            break;
+        }
+    }
+    w->kshim_next = NULL;
+    w->kshim_pending = false;
+    return true;
+}
+
+static void work_run(struct work_struct *w)
+{
+    struct work_struct *prev = running_work;
+
+    work_remove(w);
+    running_work = w;
+    w->func(w);
+    running_work = prev;
+}
+
+/* 지연 work는 타이머 tick(jiffy) 경계에서 나간다 */
+static u64 work_due(unsigned long delay)
+{
+    u64 now = kshim_now_ns();
+
+    if (!delay)
+        return now;
+    return (now / KSHIM_JIFFY_NS + delay) * KSHIM_JIFFY_NS;
+}
+
+bool queue_delayed_work(struct workqueue_struct *wq, struct delayed_work *dw, unsigned long delay)
+{
+    struct work_struct *w = &dw->work;
+
+    if (w->kshim_pending)
+        return false;
+    w->kshim_wq = wq;
+    w->kshim_due = work_due(delay);
+    work_insert(w);
+    return true;
+}
+
+bool queue_work(struct workqueue_struct *wq, struct work_struct *w)
+{
+    if (w->kshim_pending)
+        return false;
+    w->kshim_wq = wq;
+    w->kshim_due = kshim_now_ns();
+    work_insert(w);
+    return true;
+}
+
+bool mod_delayed_work(struct workqueue_struct *wq, struct delayed_work *dw, unsigned long delay)
+{
+    bool was = work_remove(&dw->work);
+
+    queue_delayed_work(wq, dw, delay);
+    return was;
+}
+
+bool cancel_work_sync(struct work_struct *w)
+{
+    return work_remove(w);
+}
+
+bool cancel_delayed_work(struct delayed_work *dw)
+{
+    return work_remove(&dw->work);
+}
+
+/* 대기 중이면 지금 바로 실행 (실행 중인 자기 자신을 flush하는 건 커널에서도 deadlock) */
+bool flush_work(struct work_struct *w)
+{
+    if (!w->kshim_pending)
+        return false;
+    work_run(w);
+    return true;
+}
+
+/* 커널처럼 큐에 들어간 것은 다 돌리고(drain), 타이머가 아직 안 나간 지연 work는 경고 후 버림 */
+void destroy_workqueue(struct workqueue_struct *wq)
+{
+    struct work_struct *w;
+
+again:
+    for (w = works; w; w = w->kshim_next) {
+        if (w->kshim_wq == wq && w->kshim_due <= kshim_now_ns()) {
+            work_run(w);
+            goto again;
+        }
+    }
+    for (w = works; w; w = w->kshim_next) {
+        if (w->kshim_wq == wq) {
+            pr_warn("destroy_workqueue(%s): work %p still pending, dropped\n", wq->name, (void *)w->func);
+            work_remove(w);
+            goto again;
+        }
+    }
+    if (wq == system_wq || wq == system_long_wq || wq == system_highpri_wq)
+        kshim_bug("destroy_workqueue on system workqueue");
+    kfree(wq);
+}
+
+void hrtimer_init(struct hrtimer *t, int clock_id, enum hrtimer_mode mode)
+{
+    (void)clock_id;
+    (void)mode;
+    memset(t, 0, sizeof(*t));
+}
+
+static void timer_insert(struct hrtimer *t)
+{
+    struct hrtimer **pp = &timers;
+
+    while (*pp && (*pp)->kshim_expires <= t->kshim_expires)
+        pp = &(*pp)->kshim_next;
+    t->kshim_next = *pp;
+    *pp = t;
+    t->kshim_armed = true;
+}
+
+int hrtimer_cancel(struct hrtimer *t)
+{
+    struct hrtimer **pp;
+
+    if (!t->kshim_armed)
+        return 0;
+    for (pp = &timers; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == t) {
+            *pp = t->kshim_next;
+            break;
+        }
+    }
+    t->kshim_next = NULL;
+    t->kshim_armed = false;
+    return 1;
+}
+
+void hrtimer_start(struct hrtimer *t, ktime_t at, enum hrtimer_mode mode)
+{
+    hrtimer_cancel(t);
+    t->kshim_expires = mode == HRTIMER_MODE_REL ? (ktime_t)kshim_now_ns() + at : at;
+    timer_insert(t);
+}
+
+u64 hrtimer_forward(struct hrtimer *t, ktime_t now, ktime_t interval)
+{
+    s64 delta = now - t->kshim_expires;
+    u64 orun;
+
+    if (delta < 0)
+        return 0;
+    if (t->kshim_armed)
+        kshim_bug("hrtimer_forward on an enqueued timer");
+    orun = (u64)(delta / interval) + 1;
+    t->kshim_expires += (s64)orun * interval;
+    return orun;
+}
+
+static void timer_run(struct hrtimer *t)
+{
+    unsigned long flags;
+    enum hrtimer_restart r;
+
+    hrtimer_cancel(t);
+    flags = kshim_irq_save();      // hardirq 문맥
+    r = t->function(t);
+    if (r == HRTIMER_RESTART && !t->kshim_armed)
+        timer_insert(t);
+    kshim_irq_restore(flags);
+}
+
+/*
+ * t까지 만기된 work/hrtimer를 시각 순서로 실행. c가 있으면 (completion 대기 중)
+ * 에지마다 c가 끝났는지 보고 끝났으면 바로 돌아간다.
+ */
+static void run_events(u64 t, struct completion *c)
+{
+    for (;;) {
+        struct work_struct *w = works;
+        struct hrtimer *h = timers;
+        bool is_timer = h && (!w || (u64)h->kshim_expires <= w->kshim_due);
+        u64 now = kshim_now_ns(), due = U64_MAX, stop;
+
+        if (c && c->done)
+            return;
+        if (w || h)
+            due = is_timer ? (h->kshim_expires < 0 ? 0 : (u64)h->kshim_expires) : w->kshim_due;
+        if (due <= now) {
+            if (is_timer)
+                timer_run(h);
+            else
+                work_run(w);
+            continue;
+        }
+        if (now >= t)
+            return;
+        // 장치 에지마다 멈춘다: 그 에지의 IRQ가 바로 나갈 work를 넣었을 수 있음
+        stop = min(min(due, t), sim_next_edge_ns(now));
+        kshim_advance_ns(stop - now);
+    }
+}
+
+void kshim_run_until(u64 t)
+{
+    run_events(t, NULL);
+}
+
+/* 기다리는 동안 다른 work/hrtimer는 다른 CPU에서 도는 것처럼 여기서 실행된다 */
+unsigned long wait_for_completion_timeout(struct completion *c, unsigned long timeout)
+{
+    u64 end = kshim_now_ns() + (u64)timeout * (NSEC_PER_SEC / HZ);
+
+    run_events(end, c);
+    if (!c->done)
+        return 0;
+    c->done--;
+    return max_t(unsigned long, 1, (end - kshim_now_ns()) / (NSEC_PER_SEC / HZ));
+}
+
+int kshim_events_pending(void)
+{
+    struct work_struct *w;
+    struct hrtimer *h;
+    int n = 0;
+
+    for (w = works; w; w = w->kshim_next)
+        n++;
+    for (h = timers; h; h = h->kshim_next)
+        n++;
+    return n;
+}
+
+// -------------------- devres --------------------
+enum devres_kind { DR_MEM, DR_ACTION, DR_GROUP };
+
+struct kshim_devres {
+    struct kshim_devres *next;   // 바로 앞에 등록된 것
+    enum devres_kind kind;
+    void (*action)(void *);
+    void *data;                  // DR_MEM: 메모리, DR_GROUP: 그룹 id
+};
+
+static struct kshim_devres *devres_push(struct device *dev, enum devres_kind kind)
+{
+    struct kshim_devres *r = kzalloc(sizeof(*r), GFP_KERNEL);
+
+    if (!r)
+        return NULL;
+    r->kind = kind;
+    r->next = dev->kshim_devres;
+    dev->kshim_devres = r;
+    return r;
+}
+
+static void devres_pop_run(struct device *dev)
+{
+    struct kshim_devres *r = dev->kshim_devres;
+
+    dev->kshim_devres = r->next;
+    if (r->kind == DR_MEM)
+        kfree(r->data);
+    else if (r->kind == DR_ACTION)
+        r->action(r->data);
+    kfree(r);
+}
+
+static void devres_release_all(struct device *dev)
+{
+    while (dev->kshim_devres)
+        devres_pop_run(dev);
+}
+
+void *devm_kzalloc(struct device *dev, size_t size, gfp_t gfp)
+{
+    void *p = kzalloc(size, gfp);
+    struct kshim_devres *r;
+
+    if (!p)
+        return NULL;
+    r = devres_push(dev, DR_MEM);
+    if (!r) {
+        kfree(p);
+        return NULL;
+    }
+    r->data = p;
+    return p;
+}
+
+int devm_add_action_or_reset(struct device *dev, void (*action)(void *), void *data)
+{
+    struct kshim_devres *r = devres_push(dev, DR_ACTION);
+
+    if (!r) {
+        action(data);
+        return -ENOMEM;
+    }
+    r->action = action;
+    r->data = data;
+    return 0;
+}
+
+void *devres_open_group(struct device *dev, void *id, gfp_t gfp)
+{
+    struct kshim_devres *r = devres_push(dev, DR_GROUP);
+
+    (void)gfp;
+    if (!r)
+        return NULL;
+    r->data = id ? id : (void *)r;
+    return r->data;
+}
+
+void devres_close_group(struct device *dev, void *id)
+{
+    (void)dev;
+    (void)id;
+}
+
+int devres_release_group(struct device *dev, void *id)
+{
+    struct kshim_devres *r;
+    int n = 0;
+
+    for (r = dev->kshim_devres; r; r = r->next)
+        if (r->kind == DR_GROUP && r->data == id)
+            break;
+    if (!r)
+        return 0;
+    for (;;) {
+        bool last = dev->kshim_devres == r;
+
+        devres_pop_run(dev);
+        n++;
+        if (last)
+            break;
+    }
+    return n;
+}
+
+// -------------------- device model --------------------
+struct device *get_device(struct device *dev)
+{
+    if (dev)
+        dev->kshim_refs++;
+    return dev;
+}
+
+void put_device(struct device *dev)
+{
+    if (!dev)
+        return;
+    if (--dev->kshim_refs < 0)
+        kshim_bug("put_device(%s): refcount underflow", dev_name(dev));
+}
+
+static struct platform_device *pdevs;
+static struct platform_driver *pdrvs;
+static struct i2c_client *clients;
+static struct i2c_driver *idrvs;
+
+struct kshim_link {
+    struct device *consumer, *supplier;
+    u32 flags;
+    struct kshim_link *next;
+};
+static struct kshim_link *links;
+
+static void links_drop(struct device *dev, bool any_flags)
+{
+    struct kshim_link **pp = &links;
+
+    while (*pp) {
+        struct kshim_link *l = *pp;
+
+        if ((l->consumer == dev && (any_flags || (l->flags & DL_FLAG_AUTOREMOVE_CONSUMER))) ||
+            (any_flags && l->supplier == dev)) {
+            *pp = l->next;
+            kfree(l);
+        } else {
+            pp = &l->next;
+        }
+    }
+}
+
+struct device_link *device_link_add(struct device *consumer, struct device *supplier, u32 flags)
+{
+    struct kshim_link *l;
+
+    if (!consumer || !supplier || consumer == supplier)
+        return NULL;
+    for (l = links; l; l = l->next)
+        if (l->consumer == consumer && l->supplier == supplier)
+            return (struct device_link *)l;
+    l = kzalloc(sizeof(*l), GFP_KERNEL);
+    if (!l)
+        return NULL;
+    l->consumer = consumer;
+    l->supplier = supplier;
+    l->flags = flags;
+    l->next = links;
+    links = l;
+    return (struct device_link *)l;
+}
+
+static bool bus_match(struct device *dev, struct device_driver *drv)
+{
+    if (dev->kshim_bus == KSHIM_BUS_PLATFORM) {
+        struct platform_device *pdev = container_of(dev, struct platform_device, dev);
+
+        return !strcmp(pdev->name, drv->name);
+    }
+    if (dev->kshim_bus == KSHIM_BUS_I2C) {
+        struct i2c_client *c = container_of(dev, struct i2c_client, dev);
+        struct i2c_driver *idrv = container_of(drv, struct i2c_driver, driver);
+        const struct i2c_device_id *id;
+
+        for (id = idrv->id_table; id && id->name[0]; id++)
+            if (!strcmp(id->name, c->name))
+                return true;
+    }
+    return false;
+}
+
+static void retry_deferred(void);
+
+static int bus_probe(struct device *dev, struct device_driver *drv)
+{
+    int ret;
+
+    dev->driver = drv;
+    if (dev->kshim_bus == KSHIM_BUS_PLATFORM) {
+        struct platform_driver *pdrv = container_of(drv, struct platform_driver, driver);
+
+        ret = pdrv->probe ? pdrv->probe(container_of(dev, struct platform_device, dev)) : 0;
+    } else {
+        struct i2c_driver *idrv = container_of(drv, struct i2c_driver, driver);
+
+        ret = idrv->probe_new ? idrv->probe_new(container_of(dev, struct i2c_client, dev)) : 0;
+    }
+    if (ret) {
+        devres_release_all(dev);
+        links_drop(dev, false);
+        dev->driver = NULL;
+        dev->driver_data = NULL;
+        dev->kshim_deferred = ret == -EPROBE_DEFER;
+        if (ret != -EPROBE_DEFER)
+            pr_warn("%s: probe of %s failed with error %d\n", drv->name, dev_name(dev), ret);
+        return ret;
+    }
+    dev->kshim_deferred = false;
+    retry_deferred();
+    return 0;
+}
+
+static void try_bind(struct device *dev)
+{
+    if (dev->driver)
+        return;
+    if (dev->kshim_bus == KSHIM_BUS_PLATFORM) {
+        struct platform_driver *d;
+
+        for (d = pdrvs; d; d = d->kshim_next)
+            if (bus_match(dev, &d->driver)) {
+                bus_probe(dev, &d->driver);
+                return;
+            }
+    } else if (dev->kshim_bus == KSHIM_BUS_I2C) {
+        struct i2c_driver *d;
+
+        for (d = idrvs; d; d = d->kshim_next)
+            if (bus_match(dev, &d->driver)) {
+                bus_probe(dev, &d->driver);
+                return;
+            }
+    }
+}
+
+/* 무언가 probe에 성공하면 미뤄 둔 장치를 다시 시도 (커널 deferred probe와 같은 때) */
+static void retry_deferred(void)
+{
+    static bool busy, again;
+    struct platform_device *p;
+    struct i2c_client *c;
+
+    if (busy) {
+        again = true;
+        return;
+    }
+    busy = true;
+    do {
+        again = false;
+        for (p = pdevs; p; p = p->kshim_next)
+            if (p->dev.kshim_deferred)
+                try_bind(&p->dev);
+        for (c = clients; c; c = c->kshim_next)
+            if (c->dev.kshim_deferred)
+                try_bind(&c->dev);
+    } while (again);
+    busy = false;
+}
+
+static void bus_unbind(struct device *dev)
+{
+    struct kshim_link *l;
+
+    if (!dev->driver)
+        return;
+    // 이 장치를 공급자로 쓰는 consumer부터 내린다 (공급자가 돌아오면 다시 probe)
+again:
+    for (l = links; l; l = l->next) {
+        if (l->supplier == dev && l->consumer->driver) {
+            struct device *c = l->consumer;
+
+            bus_unbind(c);
+            c->kshim_deferred = true;
+            goto again;
+        }
+    }
+
+    if (dev->kshim_bus == KSHIM_BUS_PLATFORM) {
+        struct platform_driver *pdrv = container_of(dev->driver, struct platform_driver, driver);
+
+        if (pdrv->remove)
+            pdrv->remove(container_of(dev, struct platform_device, dev));
+    } else {
+        struct i2c_driver *idrv = container_of(dev->driver, struct i2c_driver, driver);
+
+        if (idrv->remove)
+            idrv->remove(container_of(dev, struct i2c_client, dev));
+    }
+    devres_release_all(dev);
+    links_drop(dev, false);
+    dev->driver = NULL;
+    dev->driver_data = NULL;
+}
+
+static void dev_final_check(struct device *dev)
+{
+    if (dev->kshim_refs)
+        pr_warn("%s: unregistered with %d references held\n", dev_name(dev), dev->kshim_refs);
+    links_drop(dev, true);
+}
+
+static struct device *find_bound(struct device_driver *drv, const char *name)
+{
+    struct platform_device *p;
+    struct i2c_client *c;
+
+    for (p = pdevs; p; p = p->kshim_next)
+        if (p->dev.driver == drv && !strcmp(dev_name(&p->dev), name))
+            return &p->dev;
+    for (c = clients; c; c = c->kshim_next)
+        if (c->dev.driver == drv && !strcmp(dev_name(&c->dev), name))
+            return &c->dev;
+    return NULL;
+}
+
+struct device *driver_find_device_by_name(struct device_driver *drv, const char *name)
+{
+    return get_device(find_bound(drv, name));
+}
+
+struct device *driver_find_device_by_of_node(struct device_driver *drv, const struct device_node *np)
+{
+    (void)drv;
+    (void)np;
+    return NULL;   // 호스트에는 DT가 없다
+}
+
+int ida_alloc_max(struct ida *ida, unsigned int max, gfp_t gfp)
+{
+    unsigned int i;
+
+    (void)gfp;
+    for (i = 0; i <= max && i < 64; i++) {
+        if (!(ida->used & (1ULL << i))) {
+            ida->used |= 1ULL << i;
+            return (int)i;
+        }
+    }
+    return -ENOSPC;
+}
+
+void ida_free(struct ida *ida, unsigned int id)
+{
+    if (id >= 64 || !(ida->used & (1ULL << id)))
+        kshim_bug("ida_free(%u): not allocated", id);
+    ida->used &= ~(1ULL << id);
+}
+
+// -------------------- platform bus --------------------
+static void list_append_pdev(struct platform_device *p)
+{
+    struct platform_device **pp = &pdevs;
+
+    while (*pp)
+        pp = &(*pp)->kshim_next;
+    *pp = p;
+}
+
+int platform_driver_register(struct platform_driver *drv)
+{
+    struct platform_driver **pp = &pdrvs;
+    struct platform_device *p;
+
+    while (*pp)
+        pp = &(*pp)->kshim_next;
+    drv->kshim_next = NULL;
+    *pp = drv;
+    for (p = pdevs; p; p = p->kshim_next)
+        if (!p->dev.driver && bus_match(&p->dev, &drv->driver))
+            bus_probe(&p->dev, &drv->driver);
+    return 0;
+}
+
+void platform_driver_unregister(struct platform_driver *drv)
+{
+    struct platform_driver **pp;
+    struct platform_device *p;
+
+    for (p = pdevs; p; p = p->kshim_next)
+        if (p->dev.driver == &drv->driver)
+            bus_unbind(&p->dev);
+    for (pp = &pdrvs; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == drv) {
+            *pp = drv->kshim_next;
+            break;
+        }
+    }
+}
+
+struct platform_device *platform_device_register_data(struct device *parent, const char *name, int id,
+                                                      const void *data, size_t size)
+{
+    struct platform_device *p = kzalloc(sizeof(*p), GFP_KERNEL);
+
+    if (!p)
+        return ERR_PTR(-ENOMEM);
+    if (size) {
+        p->dev.platform_data = kmalloc(size, GFP_KERNEL);
+        if (!p->dev.platform_data) {
+            kfree(p);
+            return ERR_PTR(-ENOMEM);
+        }
+        memcpy(p->dev.platform_data, data, size);
+    }
+    p->name = name;
+    p->id = id;
+    p->dev.parent = parent;
+    p->dev.kshim_bus = KSHIM_BUS_PLATFORM;
+    if (id == -1)
+        snprintf(p->dev.kshim_name, sizeof(p->dev.kshim_name), "%s", name);
+    else
+        snprintf(p->dev.kshim_name, sizeof(p->dev.kshim_name), "%s.%d", name, id);
+    list_append_pdev(p);
+    try_bind(&p->dev);
+    return p;
+}
+
+void platform_device_unregister(struct platform_device *pdev)
+{
+    struct platform_device **pp;
+
+    if (IS_ERR_OR_NULL(pdev))
+        return;
+    bus_unbind(&pdev->dev);
+    for (pp = &pdevs; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == pdev) {
+            *pp = pdev->kshim_next;
+            break;
+        }
+    }
+    dev_final_check(&pdev->dev);
+    kfree(pdev->dev.platform_data);
+    kfree(pdev);
+}
+
+// -------------------- GPIO --------------------
+static struct gpio_desc gpio_descs[SIM_MAX_PINS];
+static bool gpio_requested[SIM_MAX_PINS];
+
+struct gpio_desc *gpio_to_desc(unsigned int gpio)
+{
+    if (gpio >= SIM_MAX_PINS)
+        return NULL;
+    gpio_descs[gpio].pin = (int)gpio;
+    return &gpio_descs[gpio];
+}
+
+static void gpio_free_action(void *data)
+{
+    gpio_requested[(long)data] = false;
+}
+
+int devm_gpio_request_one(struct device *dev, unsigned int gpio, unsigned long flags, const char *label)
+{
+    (void)label;
+    if (gpio >= SIM_MAX_PINS)
+        return -EINVAL;
+    if (gpio_requested[gpio])
+        return -EBUSY;
+    gpio_requested[gpio] = true;
+    if (flags & GPIOF_IN)
+        sim_gpio_dir((int)gpio, false, 0);
+    else
+        sim_gpio_dir((int)gpio, true, !!(flags & GPIOF_OUT_INIT_HIGH));
+    return devm_add_action_or_reset(dev, gpio_free_action, (void *)(long)gpio);
+}
+
+struct gpio_desc *devm_gpiod_get(struct device *dev, const char *con_id, enum gpiod_flags flags)
+{
+    (void)dev;
+    (void)con_id;
+    (void)flags;
+    return ERR_PTR(-ENOENT);   // DT/board lookup 없음: 드라이버는 번호 방식만 쓴다
+}
+
+static int desc_pin(const struct gpio_desc *desc, const char *what)
+{
+    if (IS_ERR_OR_NULL(desc))
+        kshim_bug("%s: invalid gpio_desc", what);
+    if (!gpio_requested[desc->pin])
+        kshim_bug("%s: gpio %d not requested", what, desc->pin);
+    return desc->pin;
+}
+
+int gpiod_direction_input(struct gpio_desc *desc)
+{
+    sim_gpio_dir(desc_pin(desc, __func__), false, 0);
+    return 0;
+}
+
+int gpiod_direction_output(struct gpio_desc *desc, int value)
+{
+    sim_gpio_dir(desc_pin(desc, __func__), true, value);
+    return 0;
+}
+
+int gpiod_get_value(const struct gpio_desc *desc)
+{
+    return sim_gpio_get(desc_pin(desc, __func__));
+}
+
+void gpiod_set_value(struct gpio_desc *desc, int value)
+{
+    int pin = desc_pin(desc, __func__);
+
+    sim_gpio_set(1, &pin, &value);
+}
+
+int gpiod_set_array_value(unsigned int n, struct gpio_desc **descs, struct gpio_array *info,
+                          unsigned long *values)
+{
+    int pv[SIM_MAX_PINS], vals[SIM_MAX_PINS];
+    unsigned int i;
+
+    (void)info;
+    if (n > SIM_MAX_PINS)
+        return -EINVAL;
+    for (i = 0; i < n; i++) {
+        pv[i] = desc_pin(descs[i], __func__);
+        vals[i] = !!(values[i / (8 * sizeof(long))] & (1UL << (i % (8 * sizeof(long)))));
+    }
+    sim_gpio_set((int)n, pv, vals);
+    return 0;
+}
+
+// -------------------- IRQ --------------------
+#define KSHIM_IRQ_BASE 100
+
+struct kshim_irq {
+    irq_handler_t handler;
+    void *dev_id;
+    unsigned long flags;
+    int depth;          // disable_irq 중첩
+    bool pending;       // 꺼져 있는 동안 에지가 옴 -> 켤 때 한 번 (edge IRQ resend)
+};
+static struct kshim_irq irqs[SIM_MAX_PINS];
+static bool irqs_off;
+
+int gpiod_to_irq(const struct gpio_desc *desc)
+{
+    return KSHIM_IRQ_BASE + desc_pin(desc, __func__);
+}
+
+static struct kshim_irq *irq_slot(unsigned int irq)
+{
+    if (irq < KSHIM_IRQ_BASE || irq >= KSHIM_IRQ_BASE + SIM_MAX_PINS)
+        kshim_bug("bad irq %u", irq);
+    return &irqs[irq - KSHIM_IRQ_BASE];
+}
+
+static void irq_deliver(int pin)
+{
+    struct kshim_irq *q = &irqs[pin];
+    unsigned long flags = kshim_irq_save();
+
+    q->pending = false;
+    q->handler(KSHIM_IRQ_BASE + pin, q->dev_id);
+    kshim_irq_restore(flags);
+}
+
+static void irq_replay(void)
+{
+    int i;
+
+    for (i = 0; i < SIM_MAX_PINS && !irqs_off; i++)
+        if (irqs[i].pending && irqs[i].handler && !irqs[i].depth)
+            irq_deliver(i);
+}
+
+/* IRQ를 끈 구간의 최대 길이 (가상 시계). 하드 IRQ 문맥(핸들러, hrtimer)도 포함 */
+static u64 irqs_off_since, irqs_off_max;
+
+unsigned long kshim_irq_save(void)
+{
+    unsigned long flags = irqs_off;
+
+    if (!irqs_off)
+        irqs_off_since = kshim_now_ns();
+    irqs_off = true;
+    return flags;
+}
+
+void kshim_irq_restore(unsigned long flags)
+{
+    irqs_off = flags;
+    if (!irqs_off) {
+        irqs_off_max = max(irqs_off_max, kshim_now_ns() - irqs_off_since);
+        irq_replay();
+    }
+}
+
+u64 kshim_irq_off_max_ns(bool reset)
+{
+    u64 v = irqs_off_max;
+
+    if (reset)
+        irqs_off_max = 0;
+    return v;
+}
+
+void kshim_gpio_edge(int pin, int level)
+{
+    struct kshim_irq *q;
+
+    if (pin < 0 || pin >= SIM_MAX_PINS)
+        return;
+    q = &irqs[pin];
+    if (!q->handler)
+        return;
+    if (!(q->flags & (level ? IRQF_TRIGGER_RISING : IRQF_TRIGGER_FALLING)))
+        return;
+    if (q->depth || irqs_off) {
+        q->pending = true;
+        return;
+    }
+    irq_deliver(pin);
+}
+
+int request_irq(unsigned int irq, irq_handler_t handler, unsigned long flags, const char *name,
+                void *dev_id)
+{
+    struct kshim_irq *q = irq_slot(irq);
+
+    (void)name;
+    if (q->handler)
+        return -EBUSY;
+    q->handler = handler;
+    q->dev_id = dev_id;
+    q->flags = flags;
+    q->depth = 0;
+    q->pending = false;
+    return 0;
+}
+
+void free_irq(unsigned int irq, void *dev_id)
+{
+    struct kshim_irq *q = irq_slot(irq);
+
+    if (!q->handler || q->dev_id != dev_id)
+        kshim_bug("free_irq(%u): not requested by %p", irq, dev_id);
+    memset(q, 0, sizeof(*q));
+}
+
+struct irq_devres {
+    unsigned int irq;
+    void *dev_id;
+};
+
+static void devm_irq_release(void *data)
+{
+    struct irq_devres *r = data;
+
+    free_irq(r->irq, r->dev_id);
+    kfree(r);
+}
+
+int devm_request_irq(struct device *dev, unsigned int irq, irq_handler_t handler,
+                     unsigned long flags, const char *name, void *dev_id)
+{
+    struct irq_devres *r = kzalloc(sizeof(*r), GFP_KERNEL);
+    int ret;
+
+    if (!r)
+        return -ENOMEM;
+    ret = request_irq(irq, handler, flags, name, dev_id);
+    if (ret) {
+        kfree(r);
+        return ret;
+    }
+    r->irq = irq;
+    r->dev_id = dev_id;
+    return devm_add_action_or_reset(dev, devm_irq_release, r);
+}
+
+void disable_irq(unsigned int irq)
+{
+    irq_slot(irq)->depth++;
+}
+
+void enable_irq(unsigned int irq)
+{
+    struct kshim_irq *q = irq_slot(irq);
+
+    if (!q->depth)
+        kshim_bug("Unbalanced enable for IRQ %u", irq);
+    if (--q->depth == 0 && q->pending && !irqs_off)
+        irq_deliver((int)(irq - KSHIM_IRQ_BASE));
+}
+
+// -------------------- I2C --------------------
+#define KSHIM_I2C_BUSES 8
+#define KSHIM_I2C_BITNS 2500   // 400 kHz
+
+static struct i2c_adapter *adapters[KSHIM_I2C_BUSES];
+
+struct i2c_adapter *kshim_i2c_add_adapter(int nr, u32 functionality,
+                                          const struct i2c_adapter_quirks *quirks)
+{
+    struct i2c_adapter *a;
+
+    if (nr < 0 || nr >= KSHIM_I2C_BUSES || adapters[nr])
+        return NULL;
+    a = kzalloc(sizeof(*a), GFP_KERNEL);
+    if (!a)
+        return NULL;
+    a->nr = nr;
+    a->functionality = functionality;
+    a->quirks = quirks;
+    snprintf(a->dev.kshim_name, sizeof(a->dev.kshim_name), "i2c-%d", nr);
+    adapters[nr] = a;
+    return a;
+}
+
+void kshim_i2c_del_adapter(struct i2c_adapter *adap)
+{
+    if (!adap)
+        return;
+    dev_final_check(&adap->dev);
+    adapters[adap->nr] = NULL;
+    kfree(adap);
+}
+
+struct i2c_adapter *i2c_get_adapter(int nr)
+{
+    if (nr < 0 || nr >= KSHIM_I2C_BUSES || !adapters[nr])
+        return NULL;
+    get_device(&adapters[nr]->dev);
+    return adapters[nr];
+}
+
+void i2c_put_adapter(struct i2c_adapter *adap)
+{
+    if (adap)
+        put_device(&adap->dev);
+}
+
+/* 커널 i2c_check_for_quirks와 같은 검사만 */
+static int i2c_quirks_ok(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
+{
+    const struct i2c_adapter_quirks *q = adap->quirks;
+    int i;
+
+    if (q && q->max_num_msgs && num > q->max_num_msgs)
+        return 0;
+    for (i = 0; i < num; i++) {
+        if (q && q->max_write_len && !(msgs[i].flags & I2C_M_RD) && msgs[i].len > q->max_write_len)
+            return 0;
+    }
+    return 1;
+}
+
+int i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
+{
+    struct sim_i2c_msg sm[64];
+    unsigned long bits = 0;
+    int i, ret;
+
+    if (num <= 0 || num > (int)ARRAY_SIZE(sm))
+        return -EINVAL;
+    if (!i2c_quirks_ok(adap, msgs, num)) {
+        dev_err(&adap->dev, "adapter quirk: transfer not supported (num %d)\n", num);
+        return -EOPNOTSUPP;
+    }
+    for (i = 0; i < num; i++) {
+        if (msgs[i].flags & I2C_M_RD)
+            return -EOPNOTSUPP;   // SSD1306은 쓰기만
+        if ((msgs[i].flags & I2C_M_NOSTART) && !(adap->functionality & I2C_FUNC_NOSTART))
+            return -EOPNOTSUPP;
+        sm[i].addr = msgs[i].addr;
+        sm[i].nostart = msgs[i].flags & I2C_M_NOSTART;
+        sm[i].buf = msgs[i].buf;
+        sm[i].len = msgs[i].len;
+    }
+    ret = sim_i2c_xfer(adap->nr, sm, num, &bits);
+    kshim_advance_ns((u64)bits * KSHIM_I2C_BITNS);
+    return ret ? ret : num;
+}
+
+int i2c_master_send(const struct i2c_client *client, const char *buf, int count)
+{
+    struct i2c_msg msg = {
+        .addr  = client->addr,
+        .flags = 0,
+        .len   = (u16)count,
+        .buf   = (u8 *)buf,
+    };
+    int ret = i2c_transfer(client->adapter, &msg, 1);
+
+    return ret == 1 ? count : ret;
+}
+
+struct i2c_client *i2c_new_client_device(struct i2c_adapter *adap, struct i2c_board_info const *info)
+{
+    struct i2c_client *c, **pp;
+
+    if (info->addr > 0x7f)
+        return ERR_PTR(-EINVAL);
+    for (c = clients; c; c = c->kshim_next)
+        if (c->adapter == adap && c->addr == info->addr)
+            return ERR_PTR(-EBUSY);
+    c = kzalloc(sizeof(*c), GFP_KERNEL);
+    if (!c)
+        return ERR_PTR(-ENOMEM);
+    c->addr = info->addr;
+    c->flags = info->flags;
+    c->adapter = adap;
+    strscpy(c->name, info->type, sizeof(c->name));
+    c->dev.platform_data = (void *)info->platform_data;
+    c->dev.parent = &adap->dev;
+    c->dev.kshim_bus = KSHIM_BUS_I2C;
+    snprintf(c->dev.kshim_name, sizeof(c->dev.kshim_name), "%d-%04x", adap->nr, c->addr);
+    for (pp = &clients; *pp; pp = &(*pp)->kshim_next)
+        ;
+    *pp = c;
+    try_bind(&c->dev);
+    return c;   // probe가 실패해도 장치는 남는다 (커널과 같음)
+}
+
+void i2c_unregister_device(struct i2c_client *client)
+{
+    struct i2c_client **pp;
+
+    if (IS_ERR_OR_NULL(client))
+        return;
+    bus_unbind(&client->dev);
+    for (pp = &clients; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == client) {
+            *pp = client->kshim_next;
+            break;
+        }
+    }
+    dev_final_check(&client->dev);
+    kfree(client);
+}
+
+int i2c_add_driver(struct i2c_driver *drv)
+{
+    struct i2c_driver **pp = &idrvs;
+    struct i2c_client *c;
+
+    while (*pp)
+        pp = &(*pp)->kshim_next;
+    drv->kshim_next = NULL;
+    *pp = drv;
+    for (c = clients; c; c = c->kshim_next)
+        if (!c->dev.driver && bus_match(&c->dev, &drv->driver))
+            bus_probe(&c->dev, &drv->driver);
+    return 0;
+}
+
+void i2c_del_driver(struct i2c_driver *drv)
+{
+    struct i2c_driver **pp;
+    struct i2c_client *c;
+
+    for (c = clients; c; c = c->kshim_next)
+        if (c->dev.driver == &drv->driver)
+            bus_unbind(&c->dev);
+    for (pp = &idrvs; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == drv) {
+            *pp = drv->kshim_next;
+            break;
+        }
+    }
+}
+
+// -------------------- chrdev / cdev / class --------------------
+static unsigned int next_major = 240;   // 커널의 동적 major도 이 근처부터
+static struct cdev *cdevs;
+
+int alloc_chrdev_region(dev_t *dev, unsigned int baseminor, unsigned int count, const char *name)
+{
+    (void)count;
+    (void)name;
+    *dev = MKDEV(next_major, baseminor);
+    next_major++;
+    return 0;
+}
+
+void unregister_chrdev_region(dev_t from, unsigned int count)
+{
+    struct cdev *c;
+
+    for (c = cdevs; c; c = c->kshim_next)
+        if (MAJOR(c->dev) == MAJOR(from) && MINOR(c->dev) - MINOR(from) < count)
+            pr_warn("unregister_chrdev_region: cdev %u:%u still added\n", MAJOR(c->dev), MINOR(c->dev));
+}
+
+void kobject_put(struct kobject *kobj)
+{
+    if (--kobj->refs == 0 && kobj->release)
+        kobj->release(kobj);
+}
+
+void cdev_init(struct cdev *cdev, const struct file_operations *fops)
+{
+    memset(cdev, 0, sizeof(*cdev));
+    cdev->kobj.refs = 1;
+    cdev->ops = fops;
+}
+
+static void cdev_dynamic_release(struct kobject *kobj)
+{
+    kfree(container_of(kobj, struct cdev, kobj));
+}
+
+/* cdev_del 뒤에도 열린 파일이 있으면 마지막 close까지 남는다 */
+struct cdev *cdev_alloc(void)
+{
+    struct cdev *cdev = kzalloc(sizeof(*cdev), GFP_KERNEL);
+
+    if (cdev) {
+        cdev->kobj.refs = 1;
+        cdev->kobj.release = cdev_dynamic_release;
+    }
+    return cdev;
+}
+
+int cdev_add(struct cdev *cdev, dev_t dev, unsigned int count)
+{
+    cdev->dev = dev;
+    cdev->count = count;
+    cdev->kshim_next = cdevs;
+    cdevs = cdev;
+    return 0;
+}
+
+void cdev_del(struct cdev *cdev)
+{
+    struct cdev **pp;
+
+    for (pp = &cdevs; *pp; pp = &(*pp)->kshim_next) {
+        if (*pp == cdev) {
+            *pp = cdev->kshim_next;
+            break;
+        }
+    }
+    kobject_put(&cdev->kobj);
+}
+
+struct cdev *kshim_cdev_lookup(dev_t dev)
+{
+    struct cdev *c;
+
+    for (c = cdevs; c; c = c->kshim_next)
+        if (MAJOR(c->dev) == MAJOR(dev) && MINOR(dev) - MINOR(c->dev) < c->count)
+            return c;
+    return NULL;
+}
+
+struct class {
+    char name[48];
+    int ndevs;
+};
+
+struct kshim_classdev {
+    struct device dev;
+    const struct attribute_group **groups;
+    struct kshim_classdev *next;
+};
+static struct kshim_classdev *classdevs;
+
+struct class *class_create(struct module *owner, const char *name)
+{
+    struct class *cls = kzalloc(sizeof(*cls), GFP_KERNEL);
+
+    (void)owner;
+    if (!cls)
+        return ERR_PTR(-ENOMEM);
+    strscpy(cls->name, name, sizeof(cls->name));
+    return cls;
+}
+
+void class_destroy(struct class *cls)
+{
+    if (IS_ERR_OR_NULL(cls))
+        return;
+    if (cls->ndevs)
+        pr_warn("class_destroy(%s): %d devices left\n", cls->name, cls->ndevs);
+    kfree(cls);
+}
+
+static struct device *classdev_vcreate(struct class *cls, struct device *parent, dev_t devt,
+                                       void *drvdata, const struct attribute_group **groups,
+                                       const char *fmt, va_list ap)
+{
+    struct kshim_classdev *cd;
+
+    if (IS_ERR_OR_NULL(cls))
+        return ERR_PTR(-ENODEV);
+    cd = kzalloc(sizeof(*cd), GFP_KERNEL);
+    if (!cd)
+        return ERR_PTR(-ENOMEM);
+    vsnprintf(cd->dev.kshim_name, sizeof(cd->dev.kshim_name), fmt, ap);
+    cd->dev.parent = parent;
+    cd->dev.devt = devt;
+    cd->dev.driver_data = drvdata;
+    cd->dev.kshim_class = cls;
+    cd->groups = groups;
+    cd->next = classdevs;
+    classdevs = cd;
+    cls->ndevs++;
+    return &cd->dev;
+}
+
+struct device *device_create(struct class *cls, struct device *parent, dev_t devt, void *drvdata,
+                             const char *fmt, ...)
+{
+    struct device *dev;
+    va_list ap;
+
+    va_start(ap, fmt);
+    dev = classdev_vcreate(cls, parent, devt, drvdata, NULL, fmt, ap);
+    va_end(ap);
+    return dev;
+}
+
+struct device *device_create_with_groups(struct class *cls, struct device *parent, dev_t devt,
+                                         void *drvdata, const struct attribute_group **groups,
+                                         const char *fmt, ...)
+{
+    struct device *dev;
+    va_list ap;
+
+    va_start(ap, fmt);
+    dev = classdev_vcreate(cls, parent, devt, drvdata, groups, fmt, ap);
+    va_end(ap);
+    return dev;
+}
+
+void device_destroy(struct class *cls, dev_t devt)
+{
+    struct kshim_classdev **pp;
+
+    for (pp = &classdevs; *pp; pp = &(*pp)->next) {
+        struct kshim_classdev *cd = *pp;
+
+        if (cd->dev.kshim_class == cls && cd->dev.devt == devt) {
+            *pp = cd->next;
+            cls->ndevs--;
+            dev_final_check(&cd->dev);
+            kfree(cd);
+            return;
+        }
+    }
+}
+
+struct device *kshim_class_find(const char *name)
+{
+    struct kshim_classdev *cd;
+
+    for (cd = classdevs; cd; cd = cd->next)
+        if (!strcmp(cd->dev.kshim_name, name))
+            return &cd->dev;
+    return NULL;
+}
+
+ssize_t kshim_sysfs_show(struct device *dev, const char *attr, char *buf)
+{
+    struct kshim_classdev *cd;
+    const struct attribute_group **g;
+
+    for (cd = classdevs; cd && &cd->dev != dev; cd = cd->next)
+        ;
+    if (!cd || !cd->groups)
+        return -ENOENT;
+    for (g = cd->groups; *g; g++) {
+        struct attribute **a;
+
+        for (a = (*g)->attrs; *a; a++) {
+            struct device_attribute *da = container_of(*a, struct device_attribute, attr);
+
+            if (strcmp((*a)->name, attr))
+                continue;
+            if (!da->show)
+                return -EPERM;
+            return da->show(dev, da, buf);
+        }
+    }
+    return -ENOENT;
+}
+
+long compat_ptr_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
+{
+    if (!file->f_op->unlocked_ioctl)
+        return -ENOIOCTLCMD;
+    return file->f_op->unlocked_ioctl(file, cmd, arg);
+}
+
+// -------------------- seq_file / debugfs --------------------
+struct kshim_single {
+    struct seq_file m;
+    int (*show)(struct seq_file *, void *);
+};
+
+void seq_printf(struct seq_file *m, const char *fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    if (m->count >= m->size)
+        return;
+    va_start(ap, fmt);
+    n = vsnprintf(m->buf + m->count, m->size - m->count, fmt, ap);
+    va_end(ap);
+    if (n < 0 || m->count + n >= m->size)
+        m->count = m->size;   // 넘침: 더 큰 버퍼로 다시
+    else
+        m->count += n;
+}
+
+int single_open(struct file *file, int (*show)(struct seq_file *, void *), void *data)
+{
+    struct kshim_single *s = kzalloc(sizeof(*s), GFP_KERNEL);
+
+    if (!s)
+        return -ENOMEM;
+    s->show = show;
+    s->m.private = data;
+    file->private_data = &s->m;
+    return 0;
+}
+
+static int seq_fill(struct kshim_single *s)
+{
+    size_t size = PAGE_SIZE;
+
+    for (;;) {
+        int ret;
+
+        s->m.buf = kmalloc(size, GFP_KERNEL);
+        if (!s->m.buf)
+            return -ENOMEM;
+        s->m.size = size;
+        s->m.count = 0;
+        ret = s->show(&s->m, s->m.private);
+        if (ret)
+            return ret;
+        if (s->m.count < size)
+            return 0;
+        kfree(s->m.buf);
+        size *= 2;
+    }
+}
+
+ssize_t seq_read(struct file *file, char __user *buf, size_t size, loff_t *ppos)
+{
+    struct seq_file *m = file->private_data;
+    struct kshim_single *s = container_of(m, struct kshim_single, m);
+    size_t n;
+
+    if (!m->buf) {
+        int ret = seq_fill(s);
+
+        if (ret) {
+            kfree(m->buf);
+            m->buf = NULL;
+            return ret;
+        }
+    }
+    if ((size_t)*ppos >= m->count)
+        return 0;
+    n = min(size, m->count - (size_t)*ppos);
+    memcpy(buf, m->buf + *ppos, n);
+    *ppos += n;
+    return n;
+}
+
+loff_t seq_lseek(struct file *file, loff_t off, int whence)
+{
+    if (whence != 0 || off < 0)
+        return -EINVAL;
+    file->f_pos = off;
+    return off;
+}
+
+int single_release(struct inode *inode, struct file *file)
+{
+    struct seq_file *m = file->private_data;
+
+    (void)inode;
+    kfree(m->buf);
+    kfree(container_of(m, struct kshim_single, m));
+    return 0;
+}
+
+struct dentry {
+    char name[48];
+    struct dentry *parent, *child, *sibling;
+    void *data;
+    const struct file_operations *fops;   // NULL이면 디렉터리
+};
+static struct dentry debugfs_root;
+
+static struct dentry *debugfs_add(const char *name, struct dentry *parent, void *data,
+                                  const struct file_operations *fops)
+{
+    struct dentry *d;
+
+    if (IS_ERR(parent))
+        return parent;
+    if (!parent)
+        parent = &debugfs_root;
+    d = kzalloc(sizeof(*d), GFP_KERNEL);
+    if (!d)
+        return ERR_PTR(-ENOMEM);
+    strscpy(d->name, name, sizeof(d->name));
+    d->parent = parent;
+    d->data = data;
+    d->fops = fops;
+    d->sibling = parent->child;
+    parent->child = d;
+    return d;
+}
+
+struct dentry *debugfs_create_dir(const char *name, struct dentry *parent)
+{
+    return debugfs_add(name, parent, NULL, NULL);
+}
+
+struct dentry *debugfs_create_file(const char *name, umode_t mode, struct dentry *parent, void *data,
+                                   const struct file_operations *fops)
+{
+    (void)mode;
+    return debugfs_add(name, parent, data, fops);
+}
+
+static void debugfs_free(struct dentry *d)
+{
+    while (d->child) {
+        struct dentry *c = d->child;
+
+        d->child = c->sibling;
+        debugfs_free(c);
+    }
+    kfree(d);
+}
+
+void debugfs_remove_recursive(struct dentry *d)
+{
+    struct dentry **pp;
+
+    if (IS_ERR_OR_NULL(d) || d == &debugfs_root)
+        return;
+    for (pp = &d->parent->child; *pp; pp = &(*pp)->sibling) {
+        if (*pp == d) {
+            *pp = d->sibling;
+            break;
+        }
+    }
+    debugfs_free(d);
+}
+
+static struct dentry *debugfs_lookup_path(const char *path)
+{
+    struct dentry *d = &debugfs_root;
+    char part[48];
+
+    while (*path) {
+        const char *slash = strchr(path, '/');
+        size_t n = slash ? (size_t)(slash - path) : strlen(path);
+        struct dentry *c;
+
+        if (n >= sizeof(part))
+            return NULL;
+        memcpy(part, path, n);
+        part[n] = '\0';
+        for (c = d->child; c && strcmp(c->name, part); c = c->sibling)
+            ;
+        if (!c)
+            return NULL;
+        d = c;
+        path += n;
+        if (*path == '/')
+            path++;
+    }
+    return d;
+}
+
+ssize_t kshim_debugfs_read(const char *path, char *buf, size_t size)
+{
+    struct dentry *d = debugfs_lookup_path(path);
+    struct inode inode = { 0 };
+    struct file file = { 0 };
+    size_t total = 0;
+    ssize_t ret = 0;
+
+    if (!d || !d->fops || !d->fops->read || !size)
+        return -ENOENT;
+    inode.i_private = d->data;
+    file.f_op = d->fops;
+    file.f_inode = &inode;
+    if (d->fops->open) {
+        ret = d->fops->open(&inode, &file);
+        if (ret)
+            return ret;
+    }
+    while (total < size - 1) {
+        ret = d->fops->read(&file, buf + total, size - 1 - total, &file.f_pos);
+        if (ret <= 0)
+            break;
+        total += ret;
+    }
+    buf[total] = '\0';
+    if (d->fops->release)
+        d->fops->release(&inode, &file);
+    return ret < 0 ? ret : (ssize_t)total;
+}
+
+// -------------------- RTC class --------------------
+#define KSHIM_MAX_RTC 4
+static struct rtc_device *rtcs[KSHIM_MAX_RTC];
+
+static void rtc_free_action(void *data)
+{
+    kfree(data);
+}
+
+struct rtc_device *devm_rtc_allocate_device(struct device *dev)
+{
+    struct rtc_device *rtc = kzalloc(sizeof(*rtc), GFP_KERNEL);
+    int ret;
+
+    if (!rtc)
+        return ERR_PTR(-ENOMEM);
+    rtc->dev.parent = dev;
+    ret = devm_add_action_or_reset(dev, rtc_free_action, rtc);
+    return ret ? ERR_PTR(ret) : rtc;
+}
+
+static void rtc_unregister_action(void *data)
+{
+    struct rtc_device *rtc = data;
+    int i;
+
+    for (i = 0; i < KSHIM_MAX_RTC; i++)
+        if (rtcs[i] == rtc)
+            rtcs[i] = NULL;
+    rtc->ops = NULL;
+}
+
+int devm_rtc_register_device(struct rtc_device *rtc)
+{
+    struct rtc_wkalrm alrm;
+    int i;
+
+    if (!rtc->ops)
+        return -EINVAL;
+    for (i = 0; i < KSHIM_MAX_RTC && rtcs[i]; i++)
+        ;
+    if (i == KSHIM_MAX_RTC)
+        return -ENOSPC;
+    rtcs[i] = rtc;
+    snprintf(rtc->dev.kshim_name, sizeof(rtc->dev.kshim_name), "rtc%d", i);
+    // 커널도 등록하면서 알람을 한 번 읽어 본다 (__rtc_read_alarm)
+    if (rtc->ops->read_alarm) {
+        memset(&alrm, 0, sizeof(alrm));
+        rtc->ops->read_alarm(rtc->dev.parent, &alrm);
+    }
+    return devm_add_action_or_reset(rtc->dev.parent, rtc_unregister_action, rtc);
+}
+
+void rtc_update_irq(struct rtc_device *rtc, unsigned long num, unsigned long events)
+{
+    (void)events;
+    rtc->kshim_irq_events += num;
+}
+
+struct rtc_device *kshim_rtc_find(struct device *parent)
+{
+    int i;
+
+    for (i = 0; i < KSHIM_MAX_RTC; i++)
+        if (rtcs[i] && (!parent || rtcs[i]->dev.parent == parent))
+            return rtcs[i];
+    return NULL;
+}
+
+// -------------------- nvmem --------------------
+struct nvmem_device {
+    struct nvmem_config cfg;
+    char name[32];
+    struct nvmem_device *next;
+};
+static struct nvmem_device *nvmems;
+
+static void nvmem_unregister_action(void *data)
+{
+    struct nvmem_device **pp;
+
+    for (pp = &nvmems; *pp; pp = &(*pp)->next) {
+        if (*pp == data) {
+            *pp = (*pp)->next;
+            break;
+        }
+    }
+    kfree(data);
+}
+
+struct nvmem_device *devm_nvmem_register(struct device *dev, const struct nvmem_config *cfg)
+{
+    struct nvmem_device *nv;
+    int ret;
+
+    if (!cfg->reg_read || cfg->size <= 0)
+        return ERR_PTR(-EINVAL);
+    nv = kzalloc(sizeof(*nv), GFP_KERNEL);
+    if (!nv)
+        return ERR_PTR(-ENOMEM);
+    nv->cfg = *cfg;
+    if (cfg->id == NVMEM_DEVID_NONE)
+        snprintf(nv->name, sizeof(nv->name), "%s", cfg->name);
+    else
+        snprintf(nv->name, sizeof(nv->name), "%s%d", cfg->name, cfg->id);
+    nv->next = nvmems;
+    nvmems = nv;
+    ret = devm_add_action_or_reset(dev, nvmem_unregister_action, nv);
+    return ret ? ERR_PTR(ret) : nv;
+}
+
+/* sysfs bin 파일처럼: 범위를 넘는 부분은 잘라내고 처리한 바이트 수를 돌려준다 */
+int kshim_nvmem_rw(const char *name, bool write, unsigned int off, void *buf, size_t len)
+{
+    struct nvmem_device *nv;
+    int ret;
+
+    for (nv = nvmems; nv && strcmp(nv->name, name); nv = nv->next)
+        ;
+    if (!nv)
+        return -ENOENT;
+    if (off >= (unsigned int)nv->cfg.size)
+        return write ? -EFBIG : 0;
+    len = min(len, (size_t)nv->cfg.size - off);
+    if (write) {
+        if (nv->cfg.read_only || !nv->cfg.reg_write)
+            return -EPERM;
+        ret = nv->cfg.reg_write(nv->cfg.priv, off, buf, len);
+    } else {
+        ret = nv->cfg.reg_read(nv->cfg.priv, off, buf, len);
+    }
+    return ret ? ret : (int)len;
+}
+
+// -------------------- hwmon --------------------
+struct kshim_hwmon {
+    struct device dev;
+    const struct hwmon_chip_info *chip;
+    struct kshim_hwmon *next;
+};
+static struct kshim_hwmon *hwmons;
+static int hwmon_next_id;
+
+static void hwmon_unregister_action(void *data)
+{
+    struct kshim_hwmon **pp;
+
+    for (pp = &hwmons; *pp; pp = &(*pp)->next) {
+        if (*pp == data) {
+            *pp = (*pp)->next;
+            break;
+        }
+    }
+    kfree(data);
+}
+
+struct device *devm_hwmon_device_register_with_info(struct device *dev, const char *name, void *drvdata,
+                                                    const struct hwmon_chip_info *info,
+                                                    const struct attribute_group **extra_groups)
+{
+    struct kshim_hwmon *hw;
+    int ret;
+
+    (void)extra_groups;
+    if (!dev || !name || !info || !info->ops || !info->info)
+        return ERR_PTR(-EINVAL);
+    hw = kzalloc(sizeof(*hw), GFP_KERNEL);
+    if (!hw)
+        return ERR_PTR(-ENOMEM);
+    hw->dev.parent = dev;
+    hw->dev.driver_data = drvdata;
+    hw->chip = info;
+    snprintf(hw->dev.kshim_name, sizeof(hw->dev.kshim_name), "hwmon%d", hwmon_next_id++);
+    hw->next = hwmons;
+    hwmons = hw;
+    ret = devm_add_action_or_reset(dev, hwmon_unregister_action, hw);
+    return ret ? ERR_PTR(ret) : &hw->dev;
+}
+
+/* hwmon core의 이름 규칙: chip 속성은 채널 번호 없이, 나머지는 <type><channel+1>_<attr> */
+static const struct {
+    const char *name;
+    enum hwmon_sensor_types type;
+    u32 attr;
+} hwmon_attr_names[] = {
+    { "update_interval", hwmon_chip, hwmon_chip_update_interval },
+    { "temp1_input", hwmon_temp, hwmon_temp_input },
+    { "humidity1_input", hwmon_humidity, hwmon_humidity_input },
+};
+
+int kshim_hwmon_rw(const char *parent, const char *attr, bool write, long *val)
+{
+    const struct hwmon_channel_info **ci;
+    struct kshim_hwmon *hw;
+    umode_t mode;
+    size_t i;
+
+    for (hw = hwmons; hw && strcmp(hw->dev.parent->kshim_name, parent); hw = hw->next)
+        ;
+    if (!hw)
+        return -ENODEV;
+    for (i = 0; i < ARRAY_SIZE(hwmon_attr_names) && strcmp(hwmon_attr_names[i].name, attr); i++)
+        ;
+    if (i == ARRAY_SIZE(hwmon_attr_names))
+        return -ENOENT;
+    // info에 없거나 is_visible이 0이면 파일이 없는 것
+    for (ci = hw->chip->info; *ci; ci++)
+        if ((*ci)->type == hwmon_attr_names[i].type &&
+            ((*ci)->config[0] & BIT(hwmon_attr_names[i].attr)))
+            break;
+    if (!*ci)
+        return -ENOENT;
+    mode = hw->chip->ops->is_visible(hw->dev.driver_data, hwmon_attr_names[i].type,
+                                     hwmon_attr_names[i].attr, 0);
+    if (!mode)
+        return -ENOENT;
+    if (write) {
+        if (!(mode & 0200) || !hw->chip->ops->write)
+            return -EACCES;
+        return hw->chip->ops->write(&hw->dev, hwmon_attr_names[i].type, hwmon_attr_names[i].attr, 0, *val);
+    }
+    if (!(mode & 0444) || !hw->chip->ops->read)
+        return -EACCES;
+    return hw->chip->ops->read(&hw->dev, hwmon_attr_names[i].type, hwmon_attr_names[i].attr, 0, val);
+}
+
+// -------------------- fbdev --------------------
+#define KSHIM_MAX_FB 8
+static struct fb_info *fbs[KSHIM_MAX_FB];
+
+struct fb_info *framebuffer_alloc(size_t size, struct device *dev)
+{
+    struct fb_info *info = kzalloc(sizeof(*info) + size, GFP_KERNEL);
+
+    if (!info)
+        return NULL;
+    if (size)
+        info->par = info + 1;
+    info->device = dev;
+    return info;
+}
+
+void framebuffer_release(struct fb_info *info)
+{
+    kfree(info);
+}
+
+int register_framebuffer(struct fb_info *info)
+{
+    int i;
+
+    for (i = 0; i < KSHIM_MAX_FB; i++) {
+        if (!fbs[i]) {
+            fbs[i] = info;
+            info->node = i;
+            return 0;
+        }
+    }
+    return -ENXIO;
+}
+
+void unregister_framebuffer(struct fb_info *info)
+{
+    if (info->node >= 0 && info->node < KSHIM_MAX_FB && fbs[info->node] == info)
+        fbs[info->node] = NULL;
+}
+
+struct fb_info *kshim_fb_get(int node)
+{
+    return node >= 0 && node < KSHIM_MAX_FB ? fbs[node] : NULL;
+}
+
+int fb_deferred_io_init(struct fb_info *info)
+{
+    return info->fbdefio && info->fbdefio->deferred_io ? 0 : -EINVAL;
+}
+
+void fb_deferred_io_cleanup(struct fb_info *info)
+{
+    (void)info;
+}
+
+int fb_deferred_io_mmap(struct fb_info *info, struct vm_area_struct *vma)
+{
+    (void)info;
+    (void)vma;
+    return -ENODEV;   // 호스트에서는 mmap 대신 write()로
+}
+
+ssize_t fb_sys_read(struct fb_info *info, char __user *buf, size_t count, loff_t *ppos)
+{
+    unsigned long p = *ppos, total = info->screen_size;
+
+    if (p >= total)
+        return 0;
+    if (count > total - p)
+        count = total - p;
+    memcpy(buf, info->screen_buffer + p, count);
+    *ppos += count;
+    return count;
+}
+
+ssize_t fb_sys_write(struct fb_info *info, const char __user *buf, size_t count, loff_t *ppos)
+{
+    unsigned long p = *ppos, total = info->screen_size;
+    int err = 0;
+
+    if (p > total)
+        return -EFBIG;
+    if (count > total) {
+        err = -EFBIG;
+        count = total;
+    }
+    if (count + p > total) {
+        if (!err)
+            err = -ENOSPC;
+        count = total - p;
+    }
+    memcpy(info->screen_buffer + p, buf, count);
+    *ppos += count;
+    return count ? (ssize_t)count : err;
+}
+
+// 그리기 가속은 user space가 안 쓰는 경로 (write/mmap만)
+void sys_fillrect(struct fb_info *info, const struct fb_fillrect *rect) { (void)info; (void)rect; }
+void sys_copyarea(struct fb_info *info, const struct fb_copyarea *area) { (void)info; (void)area; }
+void sys_imageblit(struct fb_info *info, const struct fb_image *image) { (void)info; (void)image; }
+
+// -------------------- KUnit --------------------
+#define KSHIM_MAX_SUITES 16
+static struct kunit_suite *suites[KSHIM_MAX_SUITES];
+static int nsuites;
+
+void kshim_kunit_register(struct kunit_suite *suite)
+{
+    if (nsuites < KSHIM_MAX_SUITES)
+        suites[nsuites++] = suite;
+}
+
+void *kunit_kzalloc(struct kunit *test, size_t size, gfp_t gfp)
+{
+    void *p;
+
+    if (test->nallocs == KSHIM_KUNIT_MAX_ALLOCS)
+        return NULL;
+    p = kzalloc(size, gfp);
+    if (p)
+        test->allocs[test->nallocs++] = p;
+    return p;
+}
+
+void kunit_info(struct kunit *test, const char *fmt, ...)
+{
+    char msg[256];
+    size_t n;
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    n = strlen(msg);
+    printf("        # %s: %s%s", test->name, msg, (n && msg[n - 1] == '\n') ? "" : "\n");
+}
+
+void kshim_kunit_fail(struct kunit *test, const char *file, int line, const char *fmt, ...)
+{
+    char msg[256];
+    va_list ap;
+
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    printf("        # %s: EXPECTATION FAILED at %s:%d\n        Expected %s\n", test->name, file, line, msg);
+    test->failures++;
+}
+
+int kshim_kunit_run(const char *filter)
+{
+    int i, n = 0, idx = 0, failed = 0;
+
+    for (i = 0; i < nsuites; i++)
+        if (!filter || strstr(suites[i]->name, filter))
+            n++;
+    // 벤치마크 케이스가 ktime_get_ns로 재므로 실제 시간이 흐르게
+    kshim_clock_real(true);
+    printf("KTAP version 1\n1..%d\n", n);
+    for (i = 0; i < nsuites; i++) {
+        struct kunit_suite *s = suites[i];
+        struct kunit_case *c;
+        int k = 0, ncases = 0, suite_failed = 0;
+
+        if (filter && !strstr(s->name, filter))
+            continue;
+        for (c = s->test_cases; c->run_case; c++)
+            ncases++;
+        printf("    KTAP version 1\n    # Subtest: %s\n    1..%d\n", s->name, ncases);
+        for (c = s->test_cases; c->run_case; c++) {
+            struct kunit t = { .name = c->name };
+            int a;
+
+            c->run_case(&t);
+            for (a = 0; a < t.nallocs; a++)
+                kfree(t.allocs[a]);
+            printf("    %s %d %s\n", t.failures ? "not ok" : "ok", ++k, c->name);
+            if (t.failures) {
+                suite_failed++;
+                failed++;
+            }
+        }
+        printf("%s %d %s\n", suite_failed ? "not ok" : "ok", ++idx, s->name);
+    }
+    kshim_clock_real(false);
+    return failed;
+}
@@ -0,0 +1,566 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * 호스트 빌드 하네스 (user space).
+ *
+ *   kkk_host test [suite]     KUnit suite (pure 로직 + 마이크로 벤치마크) 실행
+ *   kkk_host run [-v]         세 모듈을 시뮬레이터 위에 올려 시나리오 검사 (버스 구성 3가지)
+ *   kkk_host bench [N]        tick/render/RTC/DHT11/로터리 경로를 N번씩 돌려 실제 ns/op
+ *
+ * 드라이버는 가상 시계 위에서 돈다 (msleep/udelay는 시계만 민다). 그래서 run은 몇 초 만에
+ * 몇십 초 분량을 돌고, bench의 ns/op는 순수 CPU 비용(+ 시뮬레이터 비용)이다.
+ * perf/valgrind/sanitizer는 이 바이너리에 그대로 붙이면 된다.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+#include "sim.h"
+#include "../ds1302_oled_ioctl.h"
+
+#define NSEC_PER_MSEC 1000000ULL
+#define NSEC_PER_SEC  1000000000ULL
+
+/* 보드 배선 (README 표와 같은 기본값) */
+#define PIN_DHT11   4
+#define PIN_ROT_S1  23
+#define PIN_ROT_S2  24
+#define PIN_ROT_SW  25
+#define PIN_DS_CE   12
+#define PIN_DS_CLK  5
+#define PIN_DS_DAT  6
+#define OLED_BUS    1
+#define OLED_ADDR   0x3C
+
+/* 2025-12-31 23:59:50 UTC: 연/월/일이 곧 넘어가는 시각. SET으로 시를 바꿔도 날짜는 그대로여야 한다 */
+#define SIM_EPOCH   1767225590LL
+
+unsigned long long host_mono_ns(void);
+
+static int failures;
+static bool verbose;
+
+#define CHECK(cond, fmt, ...) do { \
+    if (!(cond)) { \
+        failures++; \
+        printf("    FAIL %s:%d: " fmt "\n", __FILE__, __LINE__, ##__VA_ARGS__); \
+    } \
+} while (0)
+
+static void run_for_ms(unsigned long long ms)
+{
+    kshim_run_until(kshim_now_ns() + ms * NSEC_PER_MSEC);
+}
+
+static void press(void)
+{
+    sim_enc_button(true);
+    run_for_ms(60);
+    sim_enc_button(false);
+    run_for_ms(60);
+}
+
+/* 다음 초 경계 + 300ms로 가서 패널 GDDRAM을 같은 문자열로 그린 화면과 비교 */
+static int check_display(const char *th)
+{
+    unsigned long long t = sim_ds1302_next_edge(kshim_now_ns()) + 300 * NSEC_PER_MSEC;
+    uint8_t want[SIM_OLED_PAGES * SIM_OLED_W];
+    const uint8_t *got = sim_ssd1306_gddram();
+    char dt[40], tm_s[40];
+    time_t secs;
+    struct tm tm;
+    int i, diff = 0;
+
+    kshim_run_until(t);
+    secs = (time_t)sim_ds1302_time(t);
+    gmtime_r(&secs, &tm);
+    snprintf(dt, sizeof(dt), "%04d-%02d-%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    snprintf(tm_s, sizeof(tm_s), "%02d:%02d:%02d", tm.tm_hour, tm.tm_min, tm.tm_sec);
+    host_ds_expect(want, false, th, dt, tm_s);
+    for (i = 0; i < (int)sizeof(want); i++)
+        diff += want[i] != got[i];
+    if (verbose)
+        printf("    display %s %s %s: %d bytes differ\n", th, dt, tm_s, diff);
+    CHECK(diff == 0, "panel differs from \"%s %s %s\" in %d bytes", th, dt, tm_s, diff);
+    CHECK(sim_ssd1306_display_on(), "display is off");
+    return diff;
+}
+
+static struct tm sim_tm(void)
+{
+    time_t secs = (time_t)sim_ds1302_time(kshim_now_ns());
+    struct tm tm;
+
+    gmtime_r(&secs, &tm);
+    return tm;
+}
+
+/* 버튼으로 SET 진입 -> 시(hour)까지 이동 -> CW 두 칸 -> 초까지 가서 저장 */
+static void check_set_mode(void)
+{
+    struct tm before, after;
+    int i;
+
+    // 저장 뒤 초가 흘러 분/시가 넘어가면 +2 비교가 깨지므로 분 끝 무렵이면 다음 분까지 기다림
+    before = sim_tm();
+    if (before.tm_sec >= 50) {
+        run_for_ms((61 - before.tm_sec) * 1000);
+        before = sim_tm();
+    }
+    press();                            // SET 진입 (YEAR)
+    press();                            // MON
+    press();                            // MDAY
+    press();                            // HOUR
+    for (i = 0; i < 4; i++) {           // STEPS_PER_DETENT 2 -> 두 칸
+        sim_enc_step(+1);
+        run_for_ms(20);
+    }
+    press();                            // MIN
+    press();                            // SEC
+    press();                            // 저장
+    run_for_ms(200);
+    after = sim_tm();
+    CHECK(after.tm_hour == (before.tm_hour + 2) % 24 && after.tm_mday == before.tm_mday,
+          "SET: hour %02d -> %02d (mday %d -> %d), want +2",
+          before.tm_hour, after.tm_hour, before.tm_mday, after.tm_mday);
+    if (verbose)
+        printf("    SET: %02d:%02d -> %02d:%02d\n", before.tm_hour, before.tm_min,
+               after.tm_hour, after.tm_min);
+}
+
+static void step_cw(void)                // 한 칸 (STEPS_PER_DETENT 2)
+{
+    sim_enc_step(+1);
+    run_for_ms(20);
+    sim_enc_step(+1);
+    run_for_ms(20);
+}
+
+static int days_in_month_tm(const struct tm *tm)
+{
+    struct tm last = { .tm_year = tm->tm_year, .tm_mon = tm->tm_mon + 1, .tm_mday = 0 };
+    time_t secs = timegm(&last);
+
+    gmtime_r(&secs, &last);
+    return last.tm_mday;
+}
+
+/*
+ * 세 필드(일, 시, 분)를 한 칸씩 바꾸면 burst로 쓴다. 바꾼 필드는 SET 진입 때 값 + 1(자리올림 없음),
+ * 안 건드린 초는 편집하는 동안에도 흘러간 지금 값이어야 하고 요일은 새 날짜를 따라가야 한다.
+ */
+static void check_set_mode_burst(void)
+{
+    unsigned long long t0 = kshim_now_ns();
+    time_t before = (time_t)sim_ds1302_time(t0), now, got;
+    struct tm b, want;
+
+    press();                            // SET 진입 (YEAR)
+    press();                            // MON
+    press();                            // MDAY
+    step_cw();
+    press();                            // HOUR
+    step_cw();
+    press();                            // MIN
+    step_cw();
+    run_for_ms(5000);                   // 편집 중에도 RTC는 흐른다
+    press();                            // SEC
+    press();                            // 저장
+    run_for_ms(200);
+
+    gmtime_r(&before, &b);
+    now = before + (time_t)((kshim_now_ns() - t0) / 1000000000ULL);
+    gmtime_r(&now, &want);
+    want.tm_year = b.tm_year;
+    want.tm_mon  = b.tm_mon;
+    want.tm_mday = b.tm_mday % days_in_month_tm(&b) + 1;
+    want.tm_hour = (b.tm_hour + 1) % 24;
+    want.tm_min  = (b.tm_min + 1) % 60;
+    got = (time_t)sim_ds1302_time(kshim_now_ns());
+    CHECK(llabs((long long)(got - timegm(&want))) <= 1, "SET burst: chip %lld, want %lld (%+lld s)",
+          (long long)got, (long long)timegm(&want), (long long)(got - timegm(&want)));
+    gmtime_r(&got, &want);
+    CHECK(sim_ds1302_wday(kshim_now_ns()) == want.tm_wday + 1, "SET burst: wday %d, want %d",
+          sim_ds1302_wday(kshim_now_ns()), want.tm_wday + 1);
+}
+
+/* /dev/ds1302_oled는 스트림: 같은 fd로 계속 읽으면 초 경계마다 한 줄 (EOF 없음) */
+static void check_stream(void)
+{
+    struct host_file *f = host_open("ds1302_oled", true);
+    char a[32] = "", b[32] = "", small[8];
+    long n1, n2, n3, n4;
+
+    CHECK(f, "cannot open /dev/ds1302_oled");
+    if (!f)
+        return;
+    n1 = host_read(f, a, sizeof(a) - 1);          // 열고 처음은 바로
+    n2 = host_read(f, b, sizeof(b) - 1);          // 같은 초 -> 기다려야 함
+    CHECK(n1 == 15 && n2 == -EAGAIN, "stream: first %ld, again %ld", n1, n2);
+    CHECK(host_pread(f, b, sizeof(b) - 1, 0) == -ESPIPE, "stream: pread should be -ESPIPE");
+    kshim_run_until(sim_ds1302_next_edge(kshim_now_ns()) + 50 * 1000000ULL);
+    n4 = host_read(f, small, sizeof(small));      // 한 줄이 안 들어감 -> 이 초를 소비하면 안 됨
+    n3 = host_read(f, b, sizeof(b) - 1);
+    CHECK(n4 == -EINVAL, "stream: short read %ld, want -EINVAL", n4);
+    CHECK(n3 == 15 && strcmp(a, b) < 0, "stream after edge: %ld \"%.14s\" -> \"%.14s\"", n3, a, b);
+    host_close(f);
+}
+
+static void check_ioctl(void)
+{
+    struct host_file *f = host_open("ds1302_oled", false);
+    struct ds1302_time t;
+    long long epoch, want = 1798761600LL;   // 2027-01-01 00:00:00
+    long ret;
+
+    CHECK(f, "cannot open /dev/ds1302_oled");
+    if (!f)
+        return;
+    ret = host_ioctl(f, DS1302_IOC_GET_EPOCH, &epoch);
+    CHECK(ret == 0 && llabs(epoch - sim_ds1302_time(kshim_now_ns())) <= 1,
+          "GET_EPOCH %ld: %lld vs chip %lld", ret, epoch, (long long)sim_ds1302_time(kshim_now_ns()));
+
+    ret = host_ioctl(f, DS1302_IOC_SET_EPOCH, &want);
+    CHECK(ret == 0, "SET_EPOCH: %ld", ret);
+    run_for_ms(1500);
+    CHECK(llabs(sim_ds1302_time(kshim_now_ns()) - want) <= 2, "chip after SET_EPOCH: %lld",
+          (long long)sim_ds1302_time(kshim_now_ns()));
+
+    ret = host_ioctl(f, DS1302_IOC_GET_TIME, &t);
+    CHECK(ret == 0 && t.year == 2027 && t.mon == 1 && t.mday == 1,
+          "GET_TIME %ld: %u-%u-%u", ret, t.year, t.mon, t.mday);
+    host_close(f);
+}
+
+static void check_nvram(void)
+{
+    static const char msg[] = "kkk-nvram";
+    char back[sizeof(msg)];
+    int ret;
+
+    ret = kshim_nvmem_rw("ds1302_nvram", true, 3, (void *)msg, sizeof(msg));
+    CHECK(ret == (int)sizeof(msg), "nvmem write: %d", ret);
+    run_for_ms(1500);                   // nvram_writeback_ms 뒤 칩에 써짐
+    CHECK(!memcmp(sim_ds1302_ram() + 3, msg, sizeof(msg)), "DS1302 RAM not written back");
+    ret = kshim_nvmem_rw("ds1302_nvram", false, 3, back, sizeof(back));
+    CHECK(ret == (int)sizeof(back) && !memcmp(back, msg, sizeof(msg)), "nvmem read back: %d", ret);
+}
+
+static void check_dht11_faults(void)
+{
+    long long age;
+    int t, h, ret;
+
+    sim_dht11_set(23, 45, SIM_DHT11_BAD_CHECKSUM);
+    run_for_ms(1100);
+    ret = host_dht11_read(&t, &h);
+    CHECK(ret < 0, "bad checksum read returned %d", ret);
+    sim_dht11_set(23, 45, SIM_DHT11_ABSENT);
+    run_for_ms(1100);
+    ret = host_dht11_read(&t, &h);
+    CHECK(ret < 0, "absent sensor read returned %d", ret);
+    sim_dht11_set(23, 45, SIM_DHT11_TRUNCATED);
+    run_for_ms(1100);
+    ret = host_dht11_read(&t, &h);
+    CHECK(ret < 0, "truncated frame read returned %d", ret);
+    // 실패한 캡처는 마지막 성공 샘플을 덮지 않는다
+    ret = host_dht11_latest(&t, &h, &age);
+    CHECK(ret == 0 && t == 23 && h == 45 && age >= 3000, "latest after failures: %d (%d, %d) %lld ms",
+          ret, t, h, age);
+    sim_dht11_set(23, 45, SIM_DHT11_OK);
+    run_for_ms(1100);
+    ret = host_dht11_read(&t, &h);
+    CHECK(ret == 0 && t == 23 && h == 45, "read after recovery: %d (%d, %d)", ret, t, h);
+}
+
+/* 깨끗한 선에서는 전부 성공해야 한다 */
+static void check_dht11_rate(void)
+{
+    int i, t, h, ok = 0;
+
+    for (i = 0; i < 20; i++) {
+        sim_dht11_set(10 + i, 30 + i, SIM_DHT11_OK);
+        run_for_ms(1100);
+        ok += host_dht11_read(&t, &h) == 0 && t == 10 + i && h == 30 + i;
+    }
+    CHECK(ok == 20, "DHT11: %d/20 reads ok", ok);
+    sim_dht11_set(23, 45, SIM_DHT11_OK);
+}
+
+/* hwmon과 /dev/dht11은 캐시에서: 읽기가 아무리 몰려도 센서는 1Hz를 넘지 않는다 */
+static void check_dht11_hwmon(void)
+{
+    struct host_file *f;
+    unsigned long starts;
+    char buf[80];
+    int i, ret, bad = 0;
+    long v, n;
+
+    ret = kshim_hwmon_rw("dht11.0", "update_interval", false, &v);
+    CHECK(ret == 0 && v == 2000, "update_interval: %d (%ld)", ret, v);
+    v = 100;
+    ret = kshim_hwmon_rw("dht11.0", "update_interval", true, &v);
+    kshim_hwmon_rw("dht11.0", "update_interval", false, &v);
+    CHECK(ret == 0 && v == 1000, "update_interval=100: %d, now %ld", ret, v);
+    ret = kshim_hwmon_rw("dht11.0", "temp1_input", true, &v);
+    CHECK(ret < 0, "temp1_input writable: %d", ret);
+
+    run_for_ms(1100);
+    starts = sim_dht11_stats()->starts;
+    for (i = 0; i < 500; i++) {
+        ret = kshim_hwmon_rw("dht11.0", i & 1 ? "humidity1_input" : "temp1_input", false, &v);
+        bad += ret || v != (i & 1 ? 45000 : 23000);
+        if (i % 50 == 0) {
+            f = host_open("dht11", false);
+            n = f ? host_read(f, buf, sizeof(buf) - 1) : -1;
+            if (f)
+                host_close(f);
+            bad += n <= 0 || strncmp(buf, "temp: 23 c humi: 45 %", 21);
+        }
+        run_for_ms(10);
+    }
+    CHECK(bad == 0, "hwmon/dev reads: %d bad of 510", bad);
+    CHECK(sim_dht11_stats()->starts - starts <= 6, "%lu captures in 5 s of polling",
+          sim_dht11_stats()->starts - starts);
+
+    v = 2000;
+    kshim_hwmon_rw("dht11.0", "update_interval", true, &v);
+}
+
+struct scenario {
+    const char *name;
+    const char *bus;                    // host_i2c_add_bus() 종류
+    bool oled_first;                    // ds1302_oled를 먼저 올려 -EPROBE_DEFER 경로
+    unsigned int fail_every;            // SSD1306 전송 실패 주입
+    bool rejected;                      // 이 버스로는 못 씀 -> probe가 실패해야 함
+};
+
+static const struct scenario scenarios[] = {
+    { "i2c-gpio (NOSTART)",             "i2c-gpio", false, 0 },
+    { "bcm2835, deferred probe",        "bcm2835",  true,  0 },
+    { "small FIFO, injected I2C errors", "small",   false, 7 },
+    { "1-byte writes, rejected",        "tiny",     false, 0, true },
+};
+
+/*
+ * unbind 뒤까지 열려 있던 파일: 읽기는 -ENODEV, 다시 열 수는 없고,
+ * 구조체는 마지막 close에서 풀려야 한다 (뒤의 누수 검사와 asan이 확인)
+ */
+static void check_closed_after_unbind(struct host_file *ds, struct host_file *rot,
+                                      struct host_file *dht)
+{
+    char buf[64];
+    long n;
+
+    if (ds) {
+        n = host_read(ds, buf, sizeof(buf));
+        CHECK(n == -ENODEV, "ds1302_oled read after unbind: %ld", n);
+        host_close(ds);
+    }
+    if (rot) {
+        n = host_read(rot, buf, sizeof(buf));
+        CHECK(n == -ENODEV, "rotary read after unbind: %ld", n);
+        host_close(rot);
+    }
+    if (dht) {
+        n = host_read(dht, buf, sizeof(buf));
+        CHECK(n == -ENODEV, "dht11 read after unbind: %ld", n);
+        host_close(dht);
+    }
+    CHECK(!host_open("ds1302_oled", true), "ds1302_oled opened after unbind");
+}
+
+static void run_scenario(const struct scenario *s)
+{
+    const struct host_ds_params ds = {
+        .bus = OLED_BUS, .addr = OLED_ADDR,
+        .ce = PIN_DS_CE, .clk = PIN_DS_CLK, .dat = PIN_DS_DAT,
+        .single_xfer = true, .clock_scale = 1,
+    };
+    struct host_file *held_ds = NULL, *held_rot = NULL, *held_dht = NULL;
+    char buf[4096];
+    void *bus;
+    int ret;
+    long n;
+
+    printf("# scenario: %s\n", s->name);
+    sim_reset();
+    bus = host_i2c_add_bus(OLED_BUS, s->bus);
+    sim_ds1302_attach(PIN_DS_CE, PIN_DS_CLK, PIN_DS_DAT, SIM_EPOCH, kshim_now_ns());
+    sim_dht11_attach(PIN_DHT11);
+    sim_dht11_set(23, 45, SIM_DHT11_OK);
+    sim_enc_attach(PIN_ROT_S1, PIN_ROT_S2, PIN_ROT_SW);
+    sim_ssd1306_attach(OLED_BUS, OLED_ADDR);
+    sim_ssd1306_fail_every(s->fail_every);
+    kshim_irq_off_max_ns(true);
+
+    if (s->oled_first) {
+        ret = host_ds_load(&ds);
+        CHECK(ret == 0 && !host_ds_bound(), "ds1302_oled before suppliers: %d, bound %d",
+              ret, host_ds_bound());
+    }
+    ret = host_dht11_load(PIN_DHT11);
+    CHECK(ret == 0, "dht11 load: %d", ret);
+    ret = host_rotary_load(PIN_ROT_S1, PIN_ROT_S2, PIN_ROT_SW);
+    CHECK(ret == 0, "rotary load: %d", ret);
+    if (!s->oled_first) {
+        ret = host_ds_load(&ds);
+        CHECK(ret == 0, "ds1302_oled load: %d", ret);
+    }
+    if (s->rejected) {
+        CHECK(!host_ds_bound(), "ds1302_oled bound to an unusable adapter");
+        goto out;
+    }
+    CHECK(host_ds_bound(), "ds1302_oled not bound");
+    if (!host_ds_bound())
+        goto out;
+
+    run_for_ms(3000);
+    if (s->fail_every) {
+        CHECK(host_ds_i2c_errors() > 0, "no I2C errors seen with fail_every=%u", s->fail_every);
+        sim_ssd1306_fail_every(0);
+        run_for_ms(2000);               // 에러 뒤 첫 flush는 전체 전송으로 복구
+    }
+    check_display("T23C H45%");
+    check_set_mode();
+    check_set_mode_burst();
+    check_display("T23C H45%");
+    check_stream();
+    check_ioctl();
+    check_nvram();
+    check_dht11_faults();
+    check_dht11_rate();
+    check_dht11_hwmon();
+
+    if (verbose) {
+        n = kshim_debugfs_read("ds1302_oled/ds1302_oled/counters", buf, sizeof(buf));
+        if (n > 0)
+            printf("%.*s", (int)n, buf);
+        n = host_sysfs("ds1302_oled", "frames_sent", buf);
+        if (n > 0)
+            printf("    frames_sent: %.*s", (int)n, buf);
+    }
+    printf("    irq-off max: %llu ns, DS1302 xfers %lu, SSD1306 wire bytes %lu\n",
+           kshim_irq_off_max_ns(false), sim_ds1302_stats()->xfers,
+           sim_ssd1306_stats()->wire_bytes);
+
+    // 내릴 때까지 열어 둔다 (ds1302_oled는 바로 돌려주는 첫 줄을 미리 읽어 둠)
+    held_ds = host_open("ds1302_oled", true);
+    held_rot = host_open("rotary_device_driver", false);
+    held_dht = host_open("dht11", false);
+    CHECK(held_ds && held_rot && held_dht, "cannot open devices before unbind");
+    if (held_ds)
+        host_read(held_ds, buf, 32);
+
+out:
+    host_ds_unload();
+    host_rotary_unload();
+    host_dht11_unload();
+    check_closed_after_unbind(held_ds, held_rot, held_dht);
+    run_for_ms(100);
+    host_i2c_del_bus(bus);
+
+    CHECK(!kshim_events_pending(), "%d work/hrtimer still pending after unload", kshim_events_pending());
+    CHECK(kshim_kmalloc_live() == 0, "%ld allocations leaked", kshim_kmalloc_live());
+    CHECK(sim_gpio_contention() == 0, "GPIO contention: %lu", sim_gpio_contention());
+    CHECK(sim_ssd1306_stats()->protocol_errors == 0, "SSD1306 protocol errors: %lu",
+          sim_ssd1306_stats()->protocol_errors);
+    CHECK(sim_ds1302_stats()->bad_cmd == 0, "DS1302 bad commands: %lu", sim_ds1302_stats()->bad_cmd);
+    CHECK(sim_dht11_stats()->too_soon == 0 && sim_dht11_stats()->short_starts == 0,
+          "DHT11 over-driven: %lu starts within 1 s, %lu short", sim_dht11_stats()->too_soon,
+          sim_dht11_stats()->short_starts);
+}
+
+static int cmd_run(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+        run_scenario(&scenarios[i]);
+    printf("# %s (%d failures)\n", failures ? "FAIL" : "ok", failures);
+    return failures ? 1 : 0;
+}
+
+static void bench_one(const char *name, void (*fn)(int), int n)
+{
+    unsigned long long t0, ns;
+
+    fn(n / 10 + 1);                     // 캐시/분기 예열
+    t0 = host_mono_ns();
+    fn(n);
+    ns = host_mono_ns() - t0;
+    printf("%-28s %10d ops %12.1f ns/op\n", name, n, (double)ns / n);
+}
+
+static void bench_dht11(int n)
+{
+    int i, t, h;
+
+    for (i = 0; i < n; i++) {
+        kshim_advance_ns(1000 * NSEC_PER_MSEC);   // 센서 1 Hz 제한
+        host_dht11_read(&t, &h);
+    }
+}
+
+static int cmd_bench(int n)
+{
+    const struct host_ds_params ds = {
+        .bus = OLED_BUS, .addr = OLED_ADDR,
+        .ce = PIN_DS_CE, .clk = PIN_DS_CLK, .dat = PIN_DS_DAT,
+        .single_xfer = true, .clock_scale = 1,
+    };
+    void *bus;
+
+    sim_reset();
+    bus = host_i2c_add_bus(OLED_BUS, "i2c-gpio");
+    sim_ds1302_attach(PIN_DS_CE, PIN_DS_CLK, PIN_DS_DAT, SIM_EPOCH, kshim_now_ns());
+    sim_dht11_attach(PIN_DHT11);
+    sim_enc_attach(PIN_ROT_S1, PIN_ROT_S2, PIN_ROT_SW);
+    sim_ssd1306_attach(OLED_BUS, OLED_ADDR);
+    if (host_dht11_load(PIN_DHT11) || host_rotary_load(PIN_ROT_S1, PIN_ROT_S2, PIN_ROT_SW) ||
+        host_ds_load(&ds) || !host_ds_bound()) {
+        fprintf(stderr, "bench: drivers did not come up\n");
+        return 1;
+    }
+    run_for_ms(2000);
+
+    bench_one("ui_draw", host_ds_bench_draw, n);
+    bench_one("tick + flush (1 s digit)", host_ds_bench_tick, n / 10);
+    bench_one("DS1302 burst read", host_ds_bench_rtc, n / 10);
+    bench_one("rotary A/B decode", host_rotary_bench_decode, n);
+    bench_one("DHT11 read + decode", bench_dht11, n / 100);
+
+    host_ds_unload();
+    host_rotary_unload();
+    host_dht11_unload();
+    host_i2c_del_bus(bus);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: kkk_host test [suite] | run [-v] | bench [iterations]\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    if (!strcmp(argv[1], "test"))
+        return kshim_kunit_run(argc > 2 ? argv[2] : NULL) ? 1 : 0;
+    if (!strcmp(argv[1], "run")) {
+        verbose = argc > 2 && !strcmp(argv[2], "-v");
+        kshim_set_loglevel(verbose ? 8 : 5);   // 평소엔 경고 이상만
+        return cmd_run();
+    }
+    if (!strcmp(argv[1], "bench")) {
+        kshim_set_loglevel(4);
+        return cmd_bench(argc > 2 ? atoi(argv[2]) : 20000);
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,837 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * 가상 하드웨어 (sim.h 참고). 데이터시트 동작 중 드라이버가 실제로 쓰는 부분만:
+ *  - DS1302: CE/CLK/DAT 3선, 명령 바이트 + 단일/burst 읽기·쓰기, WP, CH, 31바이트 RAM
+ *  - DHT11: 1선, 18ms 이상 LOW 시작 신호 -> 응답 80us/80us + 40비트 (50us LOW + 27/70us HIGH)
+ *  - 로터리: A/B gray code + 버튼(active-low)
+ *  - SSD1306: control byte(Co/DC) 파서, horizontal/page addressing, GDDRAM
+ * 시간은 kshim의 가상 시계만 본다.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "sim.h"
+
+#define NS_PER_US  1000ULL
+#define NS_PER_MS  1000000ULL
+#define NS_PER_SEC 1000000000ULL
+
+// -------------------- GPIO 선 --------------------
+enum pin_owner {
+    PIN_FREE = 0,
+    PIN_DS_CE,
+    PIN_DS_CLK,
+    PIN_DS_DAT,
+    PIN_DHT,
+    PIN_ENC_A,
+    PIN_ENC_B,
+    PIN_ENC_SW,
+};
+
+struct pin {
+    enum pin_owner owner;
+    bool host_out;
+    int host_val;
+    int level;              // 마지막으로 알린 레벨
+};
+
+static struct pin pins[SIM_MAX_PINS];
+static unsigned long contention;
+
+static bool ds_drive(int pin, int *lvl);
+static bool dht_drive(uint64_t now, int *lvl);
+static bool enc_drive(int pin, int *lvl);
+static void ds_host_changed(void);
+static void dht_host_changed(void);
+
+static bool pin_ok(int pin)
+{
+    return pin >= 0 && pin < SIM_MAX_PINS;
+}
+
+/* 장치가 이 선을 끌고 있으면 true (*lvl에 레벨) */
+static bool dev_drive(int pin, int *lvl)
+{
+    switch (pins[pin].owner) {
+    case PIN_DS_DAT: return ds_drive(pin, lvl);
+    case PIN_DHT:    return dht_drive(kshim_now_ns(), lvl);
+    case PIN_ENC_A:
+    case PIN_ENC_B:
+    case PIN_ENC_SW: return enc_drive(pin, lvl);
+    default:         return false;
+    }
+}
+
+static int line_level(int pin)
+{
+    struct pin *p = &pins[pin];
+    int dl;
+    bool dev = dev_drive(pin, &dl);
+
+    if (p->host_out) {
+        if (dev)
+            contention++;
+        return p->host_val;
+    }
+    return dev ? dl : 1;   // 아무도 안 끌면 pull-up
+}
+
+/* 레벨이 바뀐 선마다 에지를 알린다 (IRQ) */
+void sim_settle(void)
+{
+    int i;
+
+    for (i = 0; i < SIM_MAX_PINS; i++) {
+        int l;
+
+        if (pins[i].owner == PIN_FREE && !pins[i].host_out)
+            continue;
+        l = line_level(i);
+        if (l != pins[i].level) {
+            pins[i].level = l;
+            kshim_gpio_edge(i, l);
+        }
+    }
+}
+
+static void host_changed(int pin)
+{
+    switch (pins[pin].owner) {
+    case PIN_DS_CE:
+    case PIN_DS_CLK:
+    case PIN_DS_DAT: ds_host_changed(); break;
+    case PIN_DHT:    dht_host_changed(); break;
+    default: break;
+    }
+}
+
+void sim_gpio_dir(int pin, bool out, int val)
+{
+    if (!pin_ok(pin))
+        return;
+    pins[pin].host_out = out;
+    if (out)
+        pins[pin].host_val = !!val;
+    host_changed(pin);
+    sim_settle();
+}
+
+void sim_gpio_set(int n, const int *pv, const int *vals)
+{
+    int i, touched = -1;
+
+    for (i = 0; i < n; i++) {
+        if (!pin_ok(pv[i]) || !pins[pv[i]].host_out)
+            continue;   // 입력인 선에 set은 무시 (gpiolib도 그렇다)
+        pins[pv[i]].host_val = !!vals[i];
+        touched = pv[i];
+    }
+    // 여러 선이 한 번에 바뀐 것으로 장치에 한 번만 알림
+    if (touched >= 0)
+        host_changed(touched);
+    sim_settle();
+}
+
+int sim_gpio_get(int pin)
+{
+    if (!pin_ok(pin))
+        return 0;
+    return line_level(pin);
+}
+
+unsigned long sim_gpio_contention(void)
+{
+    return contention;
+}
+
+static void claim(int pin, enum pin_owner o)
+{
+    if (pin_ok(pin)) {
+        pins[pin].owner = o;
+        pins[pin].level = line_level(pin);
+    }
+}
+
+// -------------------- DS1302 --------------------
+#define DS_RAM 31
+
+static struct {
+    int ce, clk, dat;
+    bool attached;
+
+    // 시계: 가상 시계 base_ns에 epoch초가 시작됨. halted면 frozen
+    int64_t epoch;
+    uint64_t base_ns;
+    bool halted;
+    int64_t frozen;
+    int wday;                  // 1..7, wday_day일 때의 값
+    int64_t wday_day;          // epoch/86400
+    uint8_t ctrl;              // bit7 = WP
+    uint8_t trickle;
+    uint8_t ram[DS_RAM];
+
+    // 전송 상태 (CE 구간 하나)
+    int last_ce, last_clk;
+    int bits;                  // 현재 바이트에 받은 비트 수
+    uint8_t shift;
+    int nbytes;                // 이번 CE 구간에 받은 바이트 (명령 포함)
+    uint8_t cmd;
+    bool reading;
+    uint8_t rd[32];
+    int rd_len, rd_bit;        // 다음에 내보낼 비트 번호 (-1 = 아직 안 내보냄)
+    int out;                   // 지금 DAT에 내보내는 비트
+    uint8_t wr[8];             // clock burst write 모으기
+    bool wp_at_start;
+
+    struct sim_ds1302_stats st;
+} ds;
+
+static uint8_t bin2bcd(int v) { return (uint8_t)(((v / 10) << 4) | (v % 10)); }
+static int bcd2bin(uint8_t b) { return (b >> 4) * 10 + (b & 0x0f); }
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+
+    return (a % b && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+int64_t sim_ds1302_time(uint64_t ns)
+{
+    if (ds.halted)
+        return ds.frozen;
+    return ds.epoch + floor_div((int64_t)(ns - ds.base_ns), (int64_t)NS_PER_SEC);
+}
+
+uint64_t sim_ds1302_next_edge(uint64_t ns)
+{
+    int64_t k = floor_div((int64_t)(ns - ds.base_ns), (int64_t)NS_PER_SEC) + 1;
+
+    return ds.base_ns + (uint64_t)k * NS_PER_SEC;
+}
+
+int sim_ds1302_wday(uint64_t ns)
+{
+    int64_t days = floor_div(sim_ds1302_time(ns), 86400) - ds.wday_day;
+    int64_t w = (ds.wday - 1 + days) % 7;
+
+    return (int)(w < 0 ? w + 7 : w) + 1;
+}
+
+const uint8_t *sim_ds1302_ram(void) { return ds.ram; }
+bool sim_ds1302_wp(void) { return ds.ctrl & 0x80; }
+const struct sim_ds1302_stats *sim_ds1302_stats(void) { return &ds.st; }
+
+/* 지금 시각을 secs로 바꾼다. keep_phase면 초 안의 위치는 그대로 */
+static void ds_set_secs(int64_t secs, bool keep_phase)
+{
+    uint64_t now = kshim_now_ns();
+    int64_t wd = sim_ds1302_wday(now);
+
+    if (ds.halted) {
+        ds.frozen = secs;
+    } else if (keep_phase) {
+        ds.epoch += secs - sim_ds1302_time(now);
+    } else {
+        ds.epoch = secs;
+        ds.base_ns = now;
+    }
+    // 요일 레지스터는 날짜와 따로 (날짜를 바꿔도 요일은 그대로)
+    ds.wday = (int)wd;
+    ds.wday_day = floor_div(secs, 86400);
+}
+
+static void ds_regs(uint8_t r[8])
+{
+    time_t t = (time_t)sim_ds1302_time(kshim_now_ns());
+    struct tm tm;
+
+    gmtime_r(&t, &tm);
+    r[0] = bin2bcd(tm.tm_sec) | (ds.halted ? 0x80 : 0);
+    r[1] = bin2bcd(tm.tm_min);
+    r[2] = bin2bcd(tm.tm_hour);             // 24h
+    r[3] = bin2bcd(tm.tm_mday);
+    r[4] = bin2bcd(tm.tm_mon + 1);
+    r[5] = bin2bcd(sim_ds1302_wday(kshim_now_ns()));
+    r[6] = bin2bcd((tm.tm_year + 1900) % 100);
+    r[7] = ds.ctrl;
+}
+
+/* 시계 레지스터 하나 쓰기 (idx 0..6) */
+static void ds_write_clock_reg(int idx, uint8_t v)
+{
+    time_t t = (time_t)sim_ds1302_time(kshim_now_ns());
+    struct tm tm;
+
+    gmtime_r(&t, &tm);
+    switch (idx) {
+    case 0:
+        tm.tm_sec = bcd2bin(v & 0x7f);
+        if (v & 0x80) {
+            ds.frozen = sim_ds1302_time(kshim_now_ns());
+            ds.halted = true;
+        } else if (ds.halted) {
+            ds.halted = false;
+            ds.epoch = ds.frozen;
+            ds.base_ns = kshim_now_ns();
+        }
+        break;
+    case 1: tm.tm_min = bcd2bin(v & 0x7f); break;
+    case 2:
+        if (v & 0x80) {   // 12h: AM/PM 비트 5
+            int h = bcd2bin(v & 0x1f) % 12;
+
+            tm.tm_hour = h + ((v & 0x20) ? 12 : 0);
+        } else {
+            tm.tm_hour = bcd2bin(v & 0x3f);
+        }
+        break;
+    case 3: tm.tm_mday = bcd2bin(v & 0x3f); break;
+    case 4: tm.tm_mon = bcd2bin(v & 0x1f) - 1; break;
+    case 5: {
+        int64_t secs = sim_ds1302_time(kshim_now_ns());
+
+        ds.wday = bcd2bin(v & 0x07);
+        ds.wday_day = floor_div(secs, 86400);
+        return;
+    }
+    case 6: tm.tm_year = 100 + bcd2bin(v); break;
+    default: return;
+    }
+    // 초를 쓰면 1초 분주기가 리셋된다 (다음 초는 지금부터 1초 뒤)
+    ds_set_secs((int64_t)timegm(&tm), idx != 0);
+}
+
+static bool ds_writable(uint8_t cmd)
+{
+    if ((cmd & 0x3e) == 0x0e && !(cmd & 0x40))
+        return true;   // control 레지스터는 WP와 상관없이
+    if (ds.ctrl & 0x80) {
+        ds.st.wp_blocked++;
+        return false;
+    }
+    return true;
+}
+
+/* 명령 바이트를 다 받았을 때 */
+static void ds_command(uint8_t cmd)
+{
+    int addr = (cmd >> 1) & 0x1f;
+    bool ram = cmd & 0x40;
+
+    ds.cmd = cmd;
+    ds.wp_at_start = ds.ctrl & 0x80;
+    if (!(cmd & 0x80)) {
+        ds.st.bad_cmd++;
+        return;
+    }
+    if (!(cmd & 1))
+        return;   // 쓰기: 데이터 바이트를 기다림
+
+    // 읽기: 이 순간의 값을 잡아 두고 CLK↓마다 한 비트씩
+    ds.reading = true;
+    ds.rd_bit = -1;
+    if (ram && addr == 31) {
+        memcpy(ds.rd, ds.ram, DS_RAM);
+        ds.rd_len = DS_RAM;
+        ds.st.ram_bursts_rd++;
+    } else if (!ram && addr == 31) {
+        ds_regs(ds.rd);
+        ds.rd_len = 8;
+        ds.st.clock_bursts_rd++;
+    } else {
+        uint8_t r[8];
+
+        if (ram) {
+            ds.rd[0] = addr < DS_RAM ? ds.ram[addr] : 0;
+        } else if (addr < 8) {
+            ds_regs(r);
+            ds.rd[0] = r[addr];
+        } else {
+            ds.rd[0] = addr == 8 ? ds.trickle : 0;
+        }
+        ds.rd_len = 1;
+        ds.st.single_rd++;
+    }
+}
+
+/* 데이터 바이트 (쓰기 명령 뒤 n번째, 0부터) */
+static void ds_data(int n, uint8_t v)
+{
+    int addr = (ds.cmd >> 1) & 0x1f;
+    bool ram = ds.cmd & 0x40;
+
+    if (!(ds.cmd & 0x80) || (ds.cmd & 1))
+        return;
+
+    if (addr == 31 && !ram) {
+        // clock burst write: 8바이트를 다 받아야 한 번에 들어감
+        if (n < 8)
+            ds.wr[n] = v;
+        if (n == 7) {
+            int i;
+
+            ds.st.clock_bursts_wr++;
+            if (ds.wp_at_start || (ds.ctrl & 0x80)) {
+                ds.st.wp_blocked++;
+                return;
+            }
+            // 초를 먼저 쓰면 분주기 리셋, 나머지는 위상 유지
+            for (i = 6; i >= 0; i--)
+                ds_write_clock_reg(i, ds.wr[i]);
+            ds.ctrl = ds.wr[7] & 0x80;
+        }
+        return;
+    }
+    if (addr == 31 && ram) {
+        if (n == 0)
+            ds.st.ram_bursts_wr++;
+        if (n < DS_RAM && ds_writable(ds.cmd))
+            ds.ram[n] = v;
+        return;
+    }
+    if (n != 0)
+        return;   // 단일 쓰기는 데이터 한 바이트
+    ds.st.single_wr++;
+    if (!ds_writable(ds.cmd))
+        return;
+    if (ram) {
+        if (addr < DS_RAM)
+            ds.ram[addr] = v;
+    } else if (addr < 7) {
+        ds_write_clock_reg(addr, v);
+    } else if (addr == 7) {
+        ds.ctrl = v & 0x80;
+    } else if (addr == 8) {
+        ds.trickle = v;
+    }
+}
+
+static void ds_host_changed(void)
+{
+    int ce, clk;
+
+    if (!ds.attached)
+        return;
+    ce = pins[ds.ce].host_out ? pins[ds.ce].host_val : 0;
+    clk = pins[ds.clk].host_out ? pins[ds.clk].host_val : 0;
+
+    if (ce && !ds.last_ce) {
+        ds.st.xfers++;
+        ds.bits = 0;
+        ds.shift = 0;
+        ds.nbytes = 0;
+        ds.reading = false;
+    } else if (!ce && ds.last_ce) {
+        ds.reading = false;   // DAT 놓음
+    }
+
+    if (ce && ds.last_ce && clk != ds.last_clk) {
+        if (clk && !ds.reading) {
+            // 상승 에지: LSB부터 받음
+            int bit = pins[ds.dat].host_out ? pins[ds.dat].host_val : 1;
+
+            ds.shift |= (uint8_t)(bit << ds.bits);
+            if (++ds.bits == 8) {
+                if (ds.nbytes == 0)
+                    ds_command(ds.shift);
+                else
+                    ds_data(ds.nbytes - 1, ds.shift);
+                ds.nbytes++;
+                ds.bits = 0;
+                ds.shift = 0;
+            }
+        } else if (!clk && ds.reading) {
+            // 하강 에지: 다음 비트를 내보냄 (burst 끝을 지나면 처음부터 반복)
+            int k = ++ds.rd_bit % (ds.rd_len * 8);
+
+            ds.out = (ds.rd[k / 8] >> (k % 8)) & 1;
+        }
+    }
+    ds.last_ce = ce;
+    ds.last_clk = clk;
+}
+
+static bool ds_drive(int pin, int *lvl)
+{
+    (void)pin;
+    if (!ds.reading || ds.rd_bit < 0)
+        return false;
+    *lvl = ds.out;
+    return true;
+}
+
+void sim_ds1302_attach(int ce, int clk, int dat, int64_t epoch, uint64_t at_ns)
+{
+    memset(&ds, 0, sizeof(ds));
+    ds.ce = ce;
+    ds.clk = clk;
+    ds.dat = dat;
+    ds.epoch = epoch;
+    ds.base_ns = at_ns;
+    ds.ctrl = 0x80;          // 전원 켤 때 WP 상태는 정해져 있지 않음 -> 드라이버가 꼭 풀어야 함
+    ds.wday_day = floor_div(epoch, 86400);
+    ds.wday = (int)((ds.wday_day + 4) % 7) + 1;   // 1970-01-01 = 목요일, 1 = 일요일
+    ds.attached = true;
+    claim(ce, PIN_DS_CE);
+    claim(clk, PIN_DS_CLK);
+    claim(dat, PIN_DS_DAT);
+}
+
+// -------------------- DHT11 --------------------
+#define DHT_MAX_EDGES 96
+
+static struct {
+    int pin;
+    bool attached;
+    int temp, humi;
+    enum sim_dht11_fault fault;
+
+    uint64_t low_since;        // host가 LOW로 끌기 시작한 시각 (0 = 안 끌고 있음)
+    uint64_t last_resp;        // 마지막 응답 시작 (0 = 없음)
+    // 응답 파형: t[i]부터 lvl[i]
+    uint64_t t[DHT_MAX_EDGES];
+    uint8_t lvl[DHT_MAX_EDGES];
+    int n;
+
+    struct sim_dht11_stats st;
+} dht;
+
+const struct sim_dht11_stats *sim_dht11_stats(void) { return &dht.st; }
+
+void sim_dht11_set(int temp, int humi, enum sim_dht11_fault fault)
+{
+    dht.temp = temp;
+    dht.humi = humi;
+    dht.fault = fault;
+}
+
+static void dht_edge(uint64_t t, int l)
+{
+    if (dht.n < DHT_MAX_EDGES) {
+        dht.t[dht.n] = t;
+        dht.lvl[dht.n] = (uint8_t)l;
+        dht.n++;
+    }
+}
+
+/* host가 선을 놓은 순간 r: 20~40us 뒤 LOW 80us, HIGH 80us, 그리고 비트마다 LOW 50us + HIGH 27/70us */
+static void dht_respond(uint64_t r)
+{
+    uint8_t f[5];
+    uint64_t t;
+    int i, nbits = 40;
+
+    f[0] = (uint8_t)dht.humi;
+    f[1] = 0;
+    f[2] = (uint8_t)dht.temp;
+    f[3] = 0;
+    f[4] = (uint8_t)(f[0] + f[1] + f[2] + f[3]);
+    if (dht.fault == SIM_DHT11_BAD_CHECKSUM)
+        f[4]++;
+    if (dht.fault == SIM_DHT11_TRUNCATED)
+        nbits = 20;
+
+    dht.n = 0;
+    t = r + 35 * NS_PER_US;
+    dht_edge(t, 0);
+    t += 80 * NS_PER_US;
+    dht_edge(t, 1);
+    t += 80 * NS_PER_US;
+    for (i = 0; i < nbits; i++) {
+        bool one = f[i / 8] & (0x80 >> (i % 8));
+
+        dht_edge(t, 0);
+        t += 50 * NS_PER_US;
+        dht_edge(t, 1);
+        t += (one ? 70 : 27) * NS_PER_US;
+    }
+    if (nbits == 40) {
+        dht_edge(t, 0);       // 끝 표시 LOW 50us 후 놓음
+        t += 50 * NS_PER_US;
+    }
+    dht_edge(t, 1);
+}
+
+static void dht_host_changed(void)
+{
+    uint64_t now = kshim_now_ns();
+    bool low = pins[dht.pin].host_out && !pins[dht.pin].host_val;
+
+    if (!dht.attached)
+        return;
+    if (low) {
+        if (!dht.low_since) {
+            dht.low_since = now;
+            dht.n = 0;   // 시작 신호가 오면 진행 중이던 응답은 끝
+        }
+        return;
+    }
+    if (!dht.low_since)
+        return;
+
+    if (now - dht.low_since < 18 * NS_PER_MS) {
+        dht.st.short_starts++;
+    } else if (dht.fault != SIM_DHT11_ABSENT) {
+        dht.st.starts++;
+        if (dht.last_resp && now - dht.last_resp < NS_PER_SEC)
+            dht.st.too_soon++;
+        dht.last_resp = now;
+        dht_respond(now);
+    }
+    dht.low_since = 0;
+}
+
+static bool dht_drive(uint64_t now, int *lvl)
+{
+    int i;
+
+    if (!dht.n || now < dht.t[0] || now >= dht.t[dht.n - 1])
+        return false;
+    for (i = dht.n - 1; i > 0 && dht.t[i] > now; i--)
+        ;
+    *lvl = dht.lvl[i];
+    return true;
+}
+
+void sim_dht11_attach(int pin)
+{
+    memset(&dht, 0, sizeof(dht));
+    dht.pin = pin;
+    dht.temp = 25;
+    dht.humi = 40;
+    dht.attached = true;
+    claim(pin, PIN_DHT);
+}
+
+uint64_t sim_next_edge_ns(uint64_t now)
+{
+    int i;
+
+    for (i = 0; i < dht.n; i++)
+        if (dht.t[i] > now)
+            return dht.t[i];
+    return UINT64_MAX;
+}
+
+// -------------------- 로터리 엔코더 --------------------
+static struct {
+    int a, b, sw;
+    bool attached;
+    int idx;          // gray 순서 0..3 = AB 00,01,11,10
+    bool down;
+} enc;
+
+static const uint8_t enc_gray[4] = { 0x0, 0x1, 0x3, 0x2 };
+
+static bool enc_drive(int pin, int *lvl)
+{
+    uint8_t ab = enc_gray[enc.idx];
+
+    if (pin == enc.a)
+        *lvl = (ab >> 1) & 1;
+    else if (pin == enc.b)
+        *lvl = ab & 1;
+    else
+        *lvl = enc.down ? 0 : 1;
+    return true;
+}
+
+void sim_enc_attach(int a, int b, int sw)
+{
+    memset(&enc, 0, sizeof(enc));
+    enc.a = a;
+    enc.b = b;
+    enc.sw = sw;
+    enc.attached = true;
+    claim(a, PIN_ENC_A);
+    claim(b, PIN_ENC_B);
+    claim(sw, PIN_ENC_SW);
+}
+
+void sim_enc_step(int dir)
+{
+    enc.idx = (enc.idx + (dir > 0 ? 1 : 3)) & 3;
+    sim_settle();
+}
+
+void sim_enc_button(bool down)
+{
+    enc.down = down;
+    sim_settle();
+}
+
+// -------------------- SSD1306 --------------------
+static struct {
+    int bus;
+    uint16_t addr;
+    bool attached;
+    uint8_t ram[SIM_OLED_PAGES * SIM_OLED_W];
+    bool on;
+    int mode;                  // 0 = horizontal, 2 = page (전원 켤 때)
+    int col, col0, col1, page, page0, page1;
+    // 명령 파라미터 (전송 경계를 넘어 이어짐)
+    uint8_t cmd;
+    int need, got;
+    uint8_t par[2];
+    unsigned int fail_every, nxfer;
+    struct sim_ssd1306_stats st;
+} oled;
+
+void sim_ssd1306_attach(int bus, uint16_t addr)
+{
+    memset(&oled, 0, sizeof(oled));
+    oled.bus = bus;
+    oled.addr = addr;
+    oled.mode = 2;
+    oled.col1 = SIM_OLED_W - 1;
+    oled.page1 = SIM_OLED_PAGES - 1;
+    oled.attached = true;
+}
+
+void sim_ssd1306_fail_every(unsigned int n) { oled.fail_every = n; oled.nxfer = 0; }
+const uint8_t *sim_ssd1306_gddram(void) { return oled.ram; }
+bool sim_ssd1306_display_on(void) { return oled.on; }
+const struct sim_ssd1306_stats *sim_ssd1306_stats(void) { return &oled.st; }
+
+static int oled_params(uint8_t c)
+{
+    switch (c) {
+    case 0x21: case 0x22:
+        return 2;
+    case 0x20: case 0x81: case 0x8d: case 0xa8: case 0xd3:
+    case 0xd5: case 0xd9: case 0xda: case 0xdb:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void oled_exec(void)
+{
+    switch (oled.cmd) {
+    case 0x20: oled.mode = oled.par[0] & 3; break;
+    case 0x21:
+        oled.col0 = oled.par[0] & 0x7f;
+        oled.col1 = oled.par[1] & 0x7f;
+        oled.col = oled.col0;
+        break;
+    case 0x22:
+        oled.page0 = oled.par[0] & 7;
+        oled.page1 = oled.par[1] & 7;
+        oled.page = oled.page0;
+        break;
+    case 0xae: oled.on = false; break;
+    case 0xaf: oled.on = true; break;
+    default:
+        if (oled.cmd >= 0xb0 && oled.cmd <= 0xb7)
+            oled.page = oled.cmd & 7;                               // page mode
+        else if (oled.cmd <= 0x0f)
+            oled.col = (oled.col & 0xf0) | oled.cmd;
+        else if (oled.cmd >= 0x10 && oled.cmd <= 0x1f)
+            oled.col = (oled.col & 0x0f) | ((oled.cmd & 0x0f) << 4);
+        break;
+    }
+}
+
+static void oled_cmd_byte(uint8_t b)
+{
+    oled.st.cmd_bytes++;
+    if (oled.need) {
+        oled.par[oled.got++] = b;
+        if (oled.got == oled.need) {
+            oled.need = 0;
+            oled_exec();
+        }
+        return;
+    }
+    oled.cmd = b;
+    oled.need = oled_params(b);
+    oled.got = 0;
+    if (!oled.need)
+        oled_exec();
+}
+
+static void oled_data_byte(uint8_t b)
+{
+    oled.st.data_bytes++;
+    oled.ram[oled.page * SIM_OLED_W + oled.col] = b;
+    if (oled.mode == 0) {
+        if (++oled.col > oled.col1) {
+            oled.col = oled.col0;
+            if (++oled.page > oled.page1)
+                oled.page = oled.page0;
+        }
+    } else if (oled.mode == 2) {
+        if (oled.col < SIM_OLED_W - 1)
+            oled.col++;
+    } else {
+        oled.st.protocol_errors++;   // vertical은 드라이버가 안 씀
+    }
+}
+
+int sim_i2c_xfer(int bus, const struct sim_i2c_msg *msgs, int n, unsigned long *wire_bits)
+{
+    bool want_ctrl = true, co = false, dc = false;
+    size_t total = 0, limit, done = 0;
+    unsigned long bits = 2;   // START/STOP
+    int i;
+
+    if (!oled.attached || bus != oled.bus || !n || msgs[0].nostart || msgs[0].addr != oled.addr) {
+        *wire_bits = 11;      // START + 주소 + NAK
+        return -6;            // -ENXIO
+    }
+    oled.st.xfers++;
+    for (i = 0; i < n; i++)
+        total += msgs[i].len;
+
+    limit = total;
+    if (oled.fail_every && ++oled.nxfer % oled.fail_every == 0)
+        limit = total / 2;    // 가운데쯤에서 끊김
+
+    for (i = 0; i < n; i++) {
+        size_t k;
+
+        if (!msgs[i].nostart) {
+            bits += 9;
+            oled.st.wire_bytes++;
+        }
+        for (k = 0; k < msgs[i].len && done < limit; k++, done++) {
+            uint8_t b = msgs[i].buf[k];
+
+            bits += 9;
+            oled.st.wire_bytes++;
+            if (want_ctrl) {
+                if (b & 0x3f)
+                    oled.st.protocol_errors++;
+                co = b & 0x80;
+                dc = b & 0x40;
+                want_ctrl = false;
+                continue;
+            }
+            if (dc)
+                oled_data_byte(b);
+            else
+                oled_cmd_byte(b);
+            if (co)
+                want_ctrl = true;
+        }
+    }
+    *wire_bits = bits;
+    if (done < total) {
+        oled.st.injected_errors++;
+        return -5;            // -EIO
+    }
+    return 0;
+}
+
+void sim_reset(void)
+{
+    memset(pins, 0, sizeof(pins));
+    contention = 0;
+    memset(&ds, 0, sizeof(ds));
+    memset(&dht, 0, sizeof(dht));
+    memset(&enc, 0, sizeof(enc));
+    memset(&oled, 0, sizeof(oled));
+}
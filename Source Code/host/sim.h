@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * 호스트 빌드용 가상 하드웨어: GPIO 선, DS1302, DHT11, 로터리 엔코더, SSD1306.
+ *
+ * 장치 모델은 kshim의 가상 시계(kshim_now_ns)만 본다. 드라이버 쪽 API(gpiod/i2c)는
+ * kshim.c가 여기로 넘기고, 선 레벨이 바뀌면 kshim_gpio_edge()로 IRQ를 알린다.
+ * 이 헤더는 커널 shim과 독립이다 (libc 타입만).
+ */
+#ifndef KKK_HOST_SIM_H
+#define KKK_HOST_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SIM_MAX_PINS 64
+
+/* kshim.c가 제공 */
+unsigned long long kshim_now_ns(void);
+void kshim_gpio_edge(int pin, int level);
+
+void sim_reset(void);
+
+/*
+ * 장치가 시간에 따라 스스로 바꾸는 선(DHT11 응답 파형)의 다음 변화 시각 (없으면 UINT64_MAX).
+ * kshim_advance_ns()가 시계를 밀 때 그 시각마다 멈춰서 sim_settle()로 에지를 낸다.
+ */
+uint64_t sim_next_edge_ns(uint64_t now);
+void sim_settle(void);
+
+// -------------------- GPIO 선 --------------------
+/* host(드라이버) 쪽. 출력이면 그 값, 입력이면 장치가 끄는 값, 아무도 안 끌면 pull-up(1) */
+void sim_gpio_dir(int pin, bool out, int val);
+void sim_gpio_set(int n, const int *pins, const int *vals);   // 한 번에 바뀐 것으로 장치에 알림
+int sim_gpio_get(int pin);
+unsigned long sim_gpio_contention(void);   // host와 장치가 동시에 끈 횟수 (0이어야 함)
+
+// -------------------- DS1302 --------------------
+struct sim_ds1302_stats {
+    unsigned long xfers;          // CE 구간 수
+    unsigned long clock_bursts_rd, clock_bursts_wr, ram_bursts_rd, ram_bursts_wr;
+    unsigned long single_rd, single_wr;
+    unsigned long wp_blocked;     // WP가 켜져 있어서 무시된 쓰기
+    unsigned long bad_cmd;        // bit7이 0인 명령 등
+};
+/* epoch: 모델 시계의 시작 시각(초, UTC), at_ns: 가상 시계에서 그 초가 시작되는 순간 */
+void sim_ds1302_attach(int ce, int clk, int dat, int64_t epoch, uint64_t at_ns);
+int64_t sim_ds1302_time(uint64_t ns);             // 그 순간 RTC 값 (초)
+uint64_t sim_ds1302_next_edge(uint64_t ns);       // ns 이후 첫 초 경계
+int sim_ds1302_wday(uint64_t ns);                 // 요일 레지스터 (1..7)
+const uint8_t *sim_ds1302_ram(void);
+bool sim_ds1302_wp(void);
+const struct sim_ds1302_stats *sim_ds1302_stats(void);
+
+// -------------------- DHT11 --------------------
+enum sim_dht11_fault {
+    SIM_DHT11_OK = 0,
+    SIM_DHT11_ABSENT,             // 응답 없음 (선이 계속 high)
+    SIM_DHT11_BAD_CHECKSUM,
+    SIM_DHT11_TRUNCATED,          // 20비트에서 멈춤
+};
+struct sim_dht11_stats {
+    unsigned long starts;         // 유효한 시작 신호 (LOW >= 18ms)
+    unsigned long short_starts;   // 18ms보다 짧은 LOW
+    unsigned long too_soon;       // 직전 응답 뒤 1초가 안 돼서 다시 시작
+};
+void sim_dht11_attach(int pin);
+void sim_dht11_set(int temp, int humi, enum sim_dht11_fault fault);
+const struct sim_dht11_stats *sim_dht11_stats(void);
+
+// -------------------- 로터리 엔코더 (A/B quadrature + active-low 버튼) --------------------
+void sim_enc_attach(int a, int b, int sw);
+void sim_enc_step(int dir);       // +1: CW 방향 전이 하나 (00->01->11->10)
+void sim_enc_button(bool down);
+
+// -------------------- SSD1306 (I2C) --------------------
+#define SIM_OLED_W     128
+#define SIM_OLED_PAGES 8
+struct sim_i2c_msg {
+    uint16_t addr;
+    bool nostart;                 // I2C_M_NOSTART: 앞 메시지에 이어서 (START/주소 없음)
+    const uint8_t *buf;
+    size_t len;
+};
+struct sim_ssd1306_stats {
+    unsigned long xfers;          // i2c_transfer 호출 (START ~ STOP)
+    unsigned long wire_bytes;     // 주소 바이트 포함 버스에 나간 바이트
+    unsigned long data_bytes;     // GDDRAM에 쓴 바이트
+    unsigned long cmd_bytes;
+    unsigned long injected_errors;
+    unsigned long protocol_errors;
+};
+void sim_ssd1306_attach(int bus, uint16_t addr);
+/* 실패 주입: n번째 전송마다 -EIO (0 = 끔) */
+void sim_ssd1306_fail_every(unsigned int n);
+/* 성공하면 0 (*wire_bits에 버스 비트 수), 아니면 -errno */
+int sim_i2c_xfer(int bus, const struct sim_i2c_msg *msgs, int n, unsigned long *wire_bits);
+const uint8_t *sim_ssd1306_gddram(void);          // [page * 128 + col]
+bool sim_ssd1306_display_on(void);
+const struct sim_ssd1306_stats *sim_ssd1306_stats(void);
+
+#endif /* KKK_HOST_SIM_H */
@@ -2,6 +2,7 @@
 #include <linux/kernel.h>
 #include <linux/init.h>
 #include <linux/gpio.h>
+#include <linux/gpio/consumer.h>
 #include <linux/interrupt.h>
 #include <linux/timer.h>
 #include <linux/cdev.h>
@@ -11,16 +12,24 @@
 #include <linux/jiffies.h>
 #include <linux/spinlock.h>
 #include <linux/export.h>
-#include <linux/irq.h>   
-#include <linux/types.h> 
+#include <linux/irq.h>
+#include <linux/types.h>
+#include <linux/platform_device.h>
+#include <linux/of.h>
+#include <linux/idr.h>
+#include <linux/slab.h>
+#include <linux/kref.h>
+#include <linux/mutex.h>
+
+#define CREATE_TRACE_POINTS
+#include "rotary_trace.h"
 
 #define DRIVER_NAME "rotary_device_driver"
 #define CLASS_NAME "rotary_device_class"
-#define S1_GPIO 23
-#define S2_GPIO 24
-#define SW_GPIO 25 
-#define DEBOUNCE_6MS 2 // debounce time 2ms 
-#define SW_DEBOUNCE_MS 30 // sw debounce time 20ms 
+#define PDEV_NAME "rotary"       // platform device/driver 이름 (기본 인스턴스: rotary.0)
+#define ROT_MAX_DEVS 8
+#define DEBOUNCE_6MS 2 // debounce time 2ms
+#define SW_DEBOUNCE_MS 30 // sw debounce time 20ms
 #define STEPS_PER_DETENT 2      // 보통 4, 필요시 2로 튜닝
 #define ROT_GLITCH_MS    1      // 글리치 컷(1~2ms 추천)
 
@@ -28,27 +37,78 @@
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("kkk");
 MODULE_DESCRIPTION("rotary driver");
-static bool rot_irq_enabled = true; 
+
+/*
+ * 엔코더마다 인스턴스 하나 (platform device).
+ *  - device tree: compatible = "kkk,rotary"; s1-gpios, s2-gpios, sw-gpios
+ *  - DT가 없으면 모듈 로딩 때 s1/s2/sw_gpio 파라미터로 rotary.0 하나를 만든다 (s1_gpio=-1이면 안 만듦)
+ */
+static int s1_gpio = 23;
+static int s2_gpio = 24;
+static int sw_gpio = 25;
+module_param(s1_gpio, int, 0444);
+module_param(s2_gpio, int, 0444);
+module_param(sw_gpio, int, 0444);
+
+struct rotary_pdata {
+    int s1, s2, sw;
+};
+
+enum { EVT_NONE=0, EVT_ROT=1, EVT_BTN=2 };
+enum rotary_evt_type {
+    ROT_EV_NONE = 0,
+    ROT_EV_CW,
+    ROT_EV_CCW,
+    ROT_EV_BTN_DOWN,
+    ROT_EV_BTN_UP,
+};
+
+struct rotary {
+    struct device *dev;
+    struct gpio_desc *s1, *s2, *sw;
+    int interrupt_num_sw;
+    int interrupt_num_s1;	// int number of s1 gpio
+    int interrupt_num_s2;
+    bool rot_irq_enabled;
+
+    unsigned long last_interrupt_time_sw;
+    int data_update_finish; // data ready
+    int last_evt_type;
+    long last_evt_value;        // ROT: +1/-1, BTN: 1
+    int btn_latched;
+    u8 prev_ab;                 // 이전 AB 상태
+    unsigned long last_irq_ab;  // 마지막 AB IRQ 시각(jiffies), 글리치 컷용
+    int step_acc;               // 전이 누적
+    wait_queue_head_t rotary_wait_queue;
+
+    spinlock_t rot_lock;
+    int rot_last_evt;
+    void (*rot_evt_cb)(void *);  // 이벤트 알림 (IRQ 컨텍스트에서 호출)
+    void *rot_evt_data;
+
+    int id;
+    struct cdev *rotary_cdev;   // cdev_alloc: 열린 파일이 남아 있으면 마지막 close까지 산다
+
+    /*
+     * 열린 파일이 잡고 있을 수 있으므로 devm이 아니라 kref로 푼다.
+     * probe가 하나, 열린 파일마다 하나. remove 뒤에는 gone만 보고 -ENODEV.
+     */
+    struct kref ref;
+    bool gone;
+};
+
 static dev_t device_number;
-static struct cdev rotary_cdev;
 static struct class *rotary_class;
-static int interrupt_num_sw;
-static int interrupt_num_s1;	// int number of s1 gpio
-static int interrupt_num_s2; 
-static unsigned long last_interrupt_time_sw = 0;
-static int data_update_finish=0; // data ready
+static DEFINE_IDA(rotary_ida);
+static struct rotary *rotary_devs[ROT_MAX_DEVS];   // minor -> 인스턴스 (open에서 찾기)
+static DEFINE_MUTEX(rotary_devs_lock);
+static struct platform_device *rotary_legacy;
+static struct platform_driver rotary_driver;
 
-enum { EVT_NONE=0, EVT_ROT=1, EVT_BTN=2 };
-static int last_evt_type = EVT_NONE;
-static long last_evt_value = 0;  // ROT: +1/-1, BTN: 1
-static int btn_latched = 0;
-static u8 prev_ab;              // 이전 AB 상태
-static int step_acc;            // 전이 누적
-static DECLARE_WAIT_QUEUE_HEAD(rotary_wait_queue);
-static inline u8 read_ab(void)
+static inline u8 read_ab(struct rotary *r)
 {
-    u8 a = gpio_get_value(S1_GPIO) ? 1 : 0;
-    u8 b = gpio_get_value(S2_GPIO) ? 1 : 0;
+    u8 a = gpiod_get_value(r->s1) ? 1 : 0;
+    u8 b = gpiod_get_value(r->s2) ? 1 : 0;
     return (a << 1) | b;
 }
 
@@ -66,144 +126,216 @@ static inline int decode_step(u8 from, u8 to)
         return 0;  // invalid (bounce/glitch)
     }
 }
-void rotary_irq_enable(bool on)
-{   pr_info("ROT IRQ %s\n", on ? "ON" : "OFF");
+
+/* 전이를 누적하다가 한 디텐트가 차면 +1/-1 (누적은 0으로), 아니면 0 */
+static inline int detent_step(int *acc, int s)
+{
+    *acc += s;
+    if (*acc >= STEPS_PER_DETENT) {
+        *acc = 0;
+        return +1;
+    }
+    if (*acc <= -STEPS_PER_DETENT) {
+        *acc = 0;
+        return -1;
+    }
+    return 0;
+}
+void rotary_irq_enable(struct device *dev, bool on)
+{   struct rotary *r = dev_get_drvdata(dev);
+    dev_dbg(dev, "ROT IRQ %s\n", on ? "ON" : "OFF");
     /* 중복 호출 방지 */
     if (on) {
-        if (!rot_irq_enabled) {
-            enable_irq(interrupt_num_s1);
-            enable_irq(interrupt_num_s2);
-            rot_irq_enabled = true;
+        if (!r->rot_irq_enabled) {
+            enable_irq(r->interrupt_num_s1);
+            enable_irq(r->interrupt_num_s2);
+            r->rot_irq_enabled = true;
         }
     } else {
-        if (rot_irq_enabled) {
-            disable_irq(interrupt_num_s1);
-            disable_irq(interrupt_num_s2);
-            rot_irq_enabled = false;
+        if (r->rot_irq_enabled) {
+            disable_irq(r->interrupt_num_s1);
+            disable_irq(r->interrupt_num_s2);
+            r->rot_irq_enabled = false;
         }
     }
 }
 EXPORT_SYMBOL_GPL(rotary_irq_enable);
-enum rotary_evt_type {
-    ROT_EV_NONE = 0,
-    ROT_EV_CW,
-    ROT_EV_CCW,
-    ROT_EV_BTN_DOWN,
-    ROT_EV_BTN_UP,
-};
-
-static DEFINE_SPINLOCK(rot_lock);
-static int rot_last_evt = ROT_EV_NONE;
 
 /* 디코딩 결과가 나오면 여기로 넣어 */
-static inline void rot_push_evt(int ev)
+static inline void rot_push_evt(struct rotary *r, int ev)
+{
+    unsigned long flags;
+    spin_lock_irqsave(&r->rot_lock, flags);
+    r->rot_last_evt = ev;            // 가장 단순: 마지막 이벤트 1개만 유지
+    if (r->rot_evt_cb)
+        r->rot_evt_cb(r->rot_evt_data);
+    spin_unlock_irqrestore(&r->rot_lock, flags);
+}
+
+/* ds1302_oled가 폴링 대신 이벤트 때만 깨어나도록 콜백 등록 (NULL이면 해제)
+ * 해제 후 리턴하면 더 이상 콜백이 불리지 않는다 */
+void rotary_set_event_cb(struct device *dev, void (*cb)(void *), void *data)
 {
+    struct rotary *r = dev_get_drvdata(dev);
     unsigned long flags;
-    spin_lock_irqsave(&rot_lock, flags);
-    rot_last_evt = ev;            // 가장 단순: 마지막 이벤트 1개만 유지
-    spin_unlock_irqrestore(&rot_lock, flags);
+
+    spin_lock_irqsave(&r->rot_lock, flags);
+    r->rot_evt_cb = cb;
+    r->rot_evt_data = data;
+    spin_unlock_irqrestore(&r->rot_lock, flags);
 }
+EXPORT_SYMBOL_GPL(rotary_set_event_cb);
 
 /* ds1302_oled에서 가져다 쓸 함수 */
-int rotary_get_event(void)
+int rotary_get_event(struct device *dev)
 {
+    struct rotary *r = dev_get_drvdata(dev);
     unsigned long flags;
     int ev;
 
-    spin_lock_irqsave(&rot_lock, flags);
-    ev = rot_last_evt;
-    rot_last_evt = ROT_EV_NONE;   // 읽으면 소진
-    spin_unlock_irqrestore(&rot_lock, flags);
+    spin_lock_irqsave(&r->rot_lock, flags);
+    ev = r->rot_last_evt;
+    r->rot_last_evt = ROT_EV_NONE;   // 읽으면 소진
+    spin_unlock_irqrestore(&r->rot_lock, flags);
 
     return ev;
 }
 EXPORT_SYMBOL_GPL(rotary_get_event);
+
+/*
+ * 다른 모듈이 쓸 엔코더 찾기: DT 노드(np) 또는 장치 이름(예: "rotary.0").
+ * probe가 끝난 장치만 돌려주고 참조를 잡는다 (put_device로 반납). 없으면 NULL.
+ */
+struct device *rotary_find_device(struct device_node *np, const char *name)
+{
+    if (np)
+        return driver_find_device_by_of_node(&rotary_driver.driver, np);
+    if (name && *name)
+        return driver_find_device_by_name(&rotary_driver.driver, name);
+    return NULL;
+}
+EXPORT_SYMBOL_GPL(rotary_find_device);
+
 // ---- interrupt handler
 static irqreturn_t rotary_ab_int_handler(int irq, void *dev_id)
 {
+    struct rotary *r = dev_id;
     unsigned long now = jiffies;
 
     /* 아주 짧은 글리치 컷 */
-    if (time_before(now, last_irq_ab + msecs_to_jiffies(ROT_GLITCH_MS)))
+    if (time_before(now, r->last_irq_ab + msecs_to_jiffies(ROT_GLITCH_MS)))
         return IRQ_HANDLED;
-    last_irq_ab = now;
-
-    u8 ab = read_ab();
-    int s = decode_step(prev_ab, ab);
-    prev_ab = ab;
+    r->last_irq_ab = now;
 
-    if (s) {
-        step_acc += s;
+    u8 ab = read_ab(r);
+    u8 from = r->prev_ab;
+    int s = decode_step(from, ab);
+    int ev = ROT_EV_NONE;
+    int det = s ? detent_step(&r->step_acc, s) : 0;
+    r->prev_ab = ab;
 
-        if (step_acc >= STEPS_PER_DETENT) {
-            step_acc = 0;
+    if (det) {
+        ev = det > 0 ? ROT_EV_CW : ROT_EV_CCW;
 
-            last_evt_type = EVT_ROT;
-            last_evt_value = +1;
-            rot_push_evt(ROT_EV_CW);
+        r->last_evt_type = EVT_ROT;
+        r->last_evt_value = det;
+        rot_push_evt(r, ev);
 
-            data_update_finish = 1;
-            wake_up_interruptible(&rotary_wait_queue);
-        } else if (step_acc <= -STEPS_PER_DETENT) {
-            step_acc = 0;
-
-            last_evt_type = EVT_ROT;
-            last_evt_value = -1;
-            rot_push_evt(ROT_EV_CCW);
-
-            data_update_finish = 1;
-            wake_up_interruptible(&rotary_wait_queue);
-        }
+        r->data_update_finish = 1;
+        wake_up_interruptible(&r->rotary_wait_queue);
     }
+    trace_rotary_decode(r->dev, from, ab, s, r->step_acc, ev);
 
     return IRQ_HANDLED;
 }
 
 static irqreturn_t sw_int_handler(int irq, void *dev_id)
 {
+    struct rotary *r = dev_id;
     unsigned long now = jiffies;
     unsigned long dj  = msecs_to_jiffies(SW_DEBOUNCE_MS);
-    int v = gpio_get_value(SW_GPIO);  // 0: pressed, 1: released (active-low)
+    int v = gpiod_get_value(r->sw);  // 0: pressed, 1: released (active-low)
 
     /* ---------- UP은 debounce 없이 latch만 즉시 해제 ---------- */
-    if (v == 1 && btn_latched) {
-        btn_latched = 0;
+    if (v == 1 && r->btn_latched) {
+        r->btn_latched = 0;
         return IRQ_HANDLED;
     }
 
     /* ---------- DOWN만 debounce ---------- */
-    if (time_before(now, last_interrupt_time_sw + dj))
+    if (time_before(now, r->last_interrupt_time_sw + dj))
         return IRQ_HANDLED;
-    last_interrupt_time_sw = now;
+    r->last_interrupt_time_sw = now;
 
-    if (v == 0 && !btn_latched) {
-        btn_latched = 1;
+    if (v == 0 && !r->btn_latched) {
+        r->btn_latched = 1;
 
-        rot_push_evt(ROT_EV_BTN_DOWN);
+        rot_push_evt(r, ROT_EV_BTN_DOWN);
 
-        last_evt_type  = EVT_BTN;
-        last_evt_value = 1;
+        r->last_evt_type  = EVT_BTN;
+        r->last_evt_value = 1;
 
-        data_update_finish = 1;
-        wake_up_interruptible(&rotary_wait_queue);
+        r->data_update_finish = 1;
+        wake_up_interruptible(&r->rotary_wait_queue);
         return IRQ_HANDLED;
     }
 
     return IRQ_HANDLED;
 }
 
+static void rotary_free(struct kref *kref)
+{
+	kfree(container_of(kref, struct rotary, ref));
+}
+
+static void rotary_put(void *data)
+{
+	struct rotary *r = data;
+
+	kref_put(&r->ref, rotary_free);
+}
+
+static int rotary_open(struct inode *inode, struct file *file)
+{
+	struct rotary *r;
+
+	// remove가 표에서 빼고 나면 새로 열 수 없다
+	mutex_lock(&rotary_devs_lock);
+	r = rotary_devs[iminor(inode)];
+	if (r)
+		kref_get(&r->ref);
+	mutex_unlock(&rotary_devs_lock);
+	if (!r)
+		return -ENODEV;
+
+	file->private_data = r;
+	return 0;
+}
+
+static int rotary_release(struct inode *inode, struct file *file)
+{
+	rotary_put(file->private_data);
+	return 0;
+}
+
 static ssize_t rotary_read(struct file *file, char __user *user_buff, size_t count, loff_t *ppos)
 {
+	struct rotary *r = file->private_data;
 	char buffer[64];
-	int len;
-	// blocking i/o: wait while update data 
-	wait_event_interruptible(rotary_wait_queue, data_update_finish != 0);
-	data_update_finish=0;
-	if (last_evt_type == EVT_ROT) {
+	int len, ret;
+	// blocking i/o: wait while update data
+	ret = wait_event_interruptible(r->rotary_wait_queue,
+	                               r->data_update_finish != 0 || READ_ONCE(r->gone));
+	if (ret)
+		return ret;
+	if (READ_ONCE(r->gone))
+		return -ENODEV;
+	r->data_update_finish=0;
+	if (r->last_evt_type == EVT_ROT) {
         len = snprintf(buffer, sizeof(buffer),
-                       "ROT %ld\n", last_evt_value);
+                       "ROT %ld\n", r->last_evt_value);
     }
-    else if (last_evt_type == EVT_BTN) {
+    else if (r->last_evt_type == EVT_BTN) {
         len = snprintf(buffer, sizeof(buffer),
                        "BTN\n");
     }
@@ -213,102 +345,233 @@ static ssize_t rotary_read(struct file *file, char __user *user_buff, size_t cou
     }
 
     /* 다음 이벤트를 위해 초기화 */
-    last_evt_type = EVT_NONE;
+    r->last_evt_type = EVT_NONE;
 
 	// copy user space
 	if(copy_to_user(user_buff, buffer, len))
 		return -EFAULT;
-	
+
 	return len;
 
 }
 static struct file_operations fops = {
-	.owner = THIS_MODULE,
-	.read  = rotary_read
+	.owner   = THIS_MODULE,
+	.open    = rotary_open,
+	.read    = rotary_read,
+	.release = rotary_release,
+};
+
+/* board info(번호)면 gpio_request, 아니면 DT의 <con_id>-gpios */
+static struct gpio_desc *rotary_get_gpio(struct device *dev, int num, const char *con_id,
+                                         const char *label)
+{
+    int ret;
+
+    if (num < 0)
+        return devm_gpiod_get(dev, con_id, GPIOD_IN);
+
+    ret = devm_gpio_request_one(dev, num, GPIOF_IN, label);
+    if (ret)
+        return ERR_PTR(ret);
+    return gpio_to_desc(num);
+}
+
+static int rotary_probe(struct platform_device *pdev)
+{
+	struct device *dev = &pdev->dev;
+	struct rotary_pdata *pdata = dev_get_platdata(dev);
+	struct rotary *r;
+	struct device *cdev_dev;
+	int ret;
+
+	r = kzalloc(sizeof(*r), GFP_KERNEL);
+	if (!r)
+		return -ENOMEM;
+	kref_init(&r->ref);
+	// 제일 먼저 건 devm 액션이라 제일 나중에 풀린다 (IRQ가 다 풀린 뒤)
+	ret = devm_add_action_or_reset(dev, rotary_put, r);
+	if (ret)
+		return ret;
+	r->dev = dev;
+	r->rot_irq_enabled = true;
+	r->last_evt_type = EVT_NONE;
+	r->rot_last_evt = ROT_EV_NONE;
+	spin_lock_init(&r->rot_lock);
+	init_waitqueue_head(&r->rotary_wait_queue);
+	platform_set_drvdata(pdev, r);   // IRQ 걸기 전에: 핸들러/콜백이 drvdata를 씀
+
+	// 1. request gpio (input)
+	r->s1 = rotary_get_gpio(dev, pdata ? pdata->s1 : -1, "s1", "my_rotary");
+	r->s2 = rotary_get_gpio(dev, pdata ? pdata->s2 : -1, "s2", "my_rotary");
+	r->sw = rotary_get_gpio(dev, pdata ? pdata->sw : -1, "sw", "my_rotary_sw");
+	if (IS_ERR(r->s1) || IS_ERR(r->s2) || IS_ERR(r->sw))
+	{
+		ret = IS_ERR(r->s1) ? PTR_ERR(r->s1) :
+		      IS_ERR(r->s2) ? PTR_ERR(r->s2) : PTR_ERR(r->sw);
+		return dev_err_probe(dev, ret, "ERROR: gpio_request......\n");
+	}
+
+	// 2. assign gpio to irq
+	r->prev_ab = read_ab(r);
+	r->step_acc = 0;
+	r->last_irq_ab = 0;
+
+	/* S1 IRQ */
+	r->interrupt_num_s1 = gpiod_to_irq(r->s1);
+	ret = devm_request_irq(dev, r->interrupt_num_s1, rotary_ab_int_handler,
+	                       IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
+	                       "my_rotary_irq_s1", r);
+	if (ret) return ret;
+
+	/* S2 IRQ */
+	r->interrupt_num_s2 = gpiod_to_irq(r->s2);
+	ret = devm_request_irq(dev, r->interrupt_num_s2, rotary_ab_int_handler,
+	                       IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
+	                       "my_rotary_irq_s2", r);
+	if (ret) return ret;
+
+	/* SW IRQ */
+	r->interrupt_num_sw = gpiod_to_irq(r->sw);
+	ret = devm_request_irq(dev, r->interrupt_num_sw, sw_int_handler,
+	                       IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
+	                       "my_rotary_irq_sw", r);
+	if (ret) return ret;
+
+	rotary_irq_enable(dev, false);
+
+	// 3. char device: 0번은 예전 이름(/dev/rotary_device_driver), 나머지는 .N
+	r->id = ida_alloc_max(&rotary_ida, ROT_MAX_DEVS - 1, GFP_KERNEL);
+	if (r->id < 0)
+		return r->id;
+
+	r->rotary_cdev = cdev_alloc();
+	if (!r->rotary_cdev) {
+		ret = -ENOMEM;
+		goto err_ida;
+	}
+	r->rotary_cdev->owner = THIS_MODULE;
+	r->rotary_cdev->ops = &fops;
+	ret = cdev_add(r->rotary_cdev, MKDEV(MAJOR(device_number), r->id), 1);
+	if (ret) {
+		kobject_put(&r->rotary_cdev->kobj);
+		goto err_ida;
+	}
+	mutex_lock(&rotary_devs_lock);
+	rotary_devs[r->id] = r;
+	mutex_unlock(&rotary_devs_lock);
+
+	if (r->id == 0)
+		cdev_dev = device_create(rotary_class, dev, MKDEV(MAJOR(device_number), r->id),
+		                         r, DRIVER_NAME);
+	else
+		cdev_dev = device_create(rotary_class, dev, MKDEV(MAJOR(device_number), r->id),
+		                         r, DRIVER_NAME ".%d", r->id);
+	if (IS_ERR(cdev_dev)) {
+		ret = PTR_ERR(cdev_dev);
+		goto err_cdev;
+	}
+
+	dev_info(dev, "rotary #%d init success......\n", r->id);
+	return 0;
+
+err_cdev:
+	mutex_lock(&rotary_devs_lock);
+	rotary_devs[r->id] = NULL;
+	mutex_unlock(&rotary_devs_lock);
+	cdev_del(r->rotary_cdev);
+err_ida:
+	ida_free(&rotary_ida, r->id);
+	return ret;
+}
+
+static int rotary_remove(struct platform_device *pdev)
+{
+	struct rotary *r = platform_get_drvdata(pdev);
+
+	// 새 open을 막고, 열려 있는 파일은 -ENODEV로 (자고 있던 read도 깨워서)
+	mutex_lock(&rotary_devs_lock);
+	rotary_devs[r->id] = NULL;
+	mutex_unlock(&rotary_devs_lock);
+	WRITE_ONCE(r->gone, true);
+	wake_up_interruptible_all(&r->rotary_wait_queue);
+
+	device_destroy(rotary_class, MKDEV(MAJOR(device_number), r->id));
+	cdev_del(r->rotary_cdev);
+	ida_free(&rotary_ida, r->id);
+	return 0;   // r은 마지막 파일이 닫힐 때 rotary_put에서
+}
+
+static const struct of_device_id rotary_of_match[] = {
+	{ .compatible = "kkk,rotary" },
+	{ }
+};
+MODULE_DEVICE_TABLE(of, rotary_of_match);
+
+static struct platform_driver rotary_driver = {
+	.probe  = rotary_probe,
+	.remove = rotary_remove,
+	.driver = {
+		.name           = PDEV_NAME,
+		.of_match_table = rotary_of_match,
+	},
 };
 
 static int __init  rotary_driver_init(void)
 {
+	struct rotary_pdata pdata = { .s1 = s1_gpio, .s2 = s2_gpio, .sw = sw_gpio };
 	int ret;
 	printk(KERN_INFO "=== rotary initializing ======\n");
-	// 1. alloc device number 
-	if ((ret = alloc_chrdev_region(&device_number ,0 ,1 ,DRIVER_NAME )) == -1){
+	// 1. alloc device number (인스턴스마다 minor 하나)
+	if ((ret = alloc_chrdev_region(&device_number ,0 ,ROT_MAX_DEVS ,DRIVER_NAME )) < 0){
 		printk(KERN_ERR "ERROR: alloc_chrdev_regin .......\n");
 		return ret;
 	}
-	// 2. register char device
-	cdev_init(&rotary_cdev, &fops);
-	if ((ret = cdev_add(&rotary_cdev, device_number,1)) == -1){
-		printk(KERN_ERR "ERROR: cdev_add .......\n");
-		unregister_chrdev_region(device_number, 1);
-		return ret;
-	}
-	// 3. create class & create device /dev/rotary_driver
+	// 2. create class
 	rotary_class = class_create(THIS_MODULE, CLASS_NAME);
 	if(IS_ERR(rotary_class))
 	{
-		cdev_del(&rotary_cdev);
-		unregister_chrdev_region(device_number, 1);
-		return PTR_ERR(rotary_class);
+		ret = PTR_ERR(rotary_class);
+		goto err_chr;
 	}
-	device_create(rotary_class, NULL, device_number, NULL, DRIVER_NAME);
-	// 4. request gpio
-	if(gpio_request(S1_GPIO,"my_rotary") || gpio_request(S2_GPIO, "my_rotary") ||
-		gpio_request(SW_GPIO,"my_rotary_sw")) 
-	{
-		printk(KERN_ERR "ERROR: gpio_request......\n");
-		return -1;
+	// 3. register driver -> DT 노드마다 probe
+	ret = platform_driver_register(&rotary_driver);
+	if (ret)
+		goto err_class;
+	// 4. DT 없이 쓰던 예전 구성: 파라미터 핀으로 기본 엔코더 하나
+	if (s1_gpio >= 0) {
+		rotary_legacy = platform_device_register_data(NULL, PDEV_NAME, 0,
+		                                              &pdata, sizeof(pdata));
+		if (IS_ERR(rotary_legacy)) {
+			ret = PTR_ERR(rotary_legacy);
+			rotary_legacy = NULL;
+			goto err_drv;
+		}
 	}
-	// set input mode 
-	gpio_direction_input(S1_GPIO);
-    gpio_direction_input(S2_GPIO);
-	gpio_direction_input(SW_GPIO);
-	// 5. assign gpio to irq
-prev_ab = read_ab();
-step_acc = 0;
-last_irq_ab = 0;
-
-/* S1 IRQ */
-interrupt_num_s1 = gpio_to_irq(S1_GPIO);
-ret = request_irq(interrupt_num_s1, rotary_ab_int_handler,
-                   IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
-                  "my_rotary_irq_s1", NULL);
-if (ret) return ret;
-
-/* S2 IRQ */
-interrupt_num_s2 = gpio_to_irq(S2_GPIO);
-ret = request_irq(interrupt_num_s2, rotary_ab_int_handler,
-                   IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
-                  "my_rotary_irq_s2", NULL);
-/* SW IRQ */
-interrupt_num_sw = gpio_to_irq(SW_GPIO);
-ret = request_irq(interrupt_num_sw, sw_int_handler,
-                  IRQF_TRIGGER_FALLING | IRQF_TRIGGER_RISING,
-                  "my_rotary_irq_sw", NULL);
-if (ret){
-    free_irq(interrupt_num_s1, NULL);
-    return ret;
-}
-rotary_irq_enable(false);
-printk(KERN_INFO "rotary driver init success......\n");
-return 0;
+	printk(KERN_INFO "rotary driver init success......\n");
+	return 0;
+
+err_drv:
+	platform_driver_unregister(&rotary_driver);
+err_class:
+	class_destroy(rotary_class);
+err_chr:
+	unregister_chrdev_region(device_number, ROT_MAX_DEVS);
+	return ret;
 }
 
 static void __exit rotary_driver_exit(void)
 {
-	free_irq(interrupt_num_s1, NULL);
-    free_irq(interrupt_num_s2, NULL); 
-	free_irq(interrupt_num_sw, NULL);
-	gpio_free(S1_GPIO);
-	gpio_free(S2_GPIO);
-	gpio_free(SW_GPIO);
-	device_destroy(rotary_class, device_number);
+	platform_device_unregister(rotary_legacy);
+	platform_driver_unregister(&rotary_driver);
 	class_destroy(rotary_class);
-	cdev_del(&rotary_cdev);
-	unregister_chrdev_region(device_number, 1);
+	unregister_chrdev_region(device_number, ROT_MAX_DEVS);
 	printk(KERN_INFO "rotary_driver_exit !!!!!\n");
 
 }
 
 module_init(rotary_driver_init);
 module_exit(rotary_driver_exit);
+
+#ifdef KKK_KUNIT_TEST
+#include "rotary_test.c"
+#endif
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * rotary KUnit 테스트 (rotary.c 끝에서 include, make KUNIT=1)
+ * 하드웨어 없이 돈다: decode_step()/detent_step()만 본다.
+ */
+#include <kunit/test.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
+
+#define ROT_BENCH_N 1000000
+
+/* CW 한 바퀴: 00 -> 01 -> 11 -> 10 -> 00 */
+static const u8 rot_cw_seq[4] = { 0b00, 0b01, 0b11, 0b10 };
+
+static void rot_test_decode_table(struct kunit *test)
+{
+    int from, to, cw = 0, ccw = 0, bad = 0;
+
+    for (from = 0; from < 4; from++) {
+        for (to = 0; to < 4; to++) {
+            int s = decode_step(from, to);
+
+            if (s > 0) cw++;
+            else if (s < 0) ccw++;
+            else bad++;
+            // 반대 방향 전이는 항상 부호가 반대
+            KUNIT_EXPECT_EQ(test, s, -decode_step(to, from));
+        }
+    }
+    // 유효 전이는 방향마다 4개, 나머지(같은 상태, 두 비트 동시 변화) 8개는 무효
+    KUNIT_EXPECT_EQ(test, cw, 4);
+    KUNIT_EXPECT_EQ(test, ccw, 4);
+    KUNIT_EXPECT_EQ(test, bad, 8);
+
+    for (from = 0; from < 4; from++)
+        KUNIT_EXPECT_EQ(test, decode_step(rot_cw_seq[from], rot_cw_seq[(from + 1) % 4]), 1);
+}
+
+static void rot_test_detent(struct kunit *test)
+{
+    int i, acc = 0;
+
+    // STEPS_PER_DETENT번째 전이에서만 이벤트, 그때 누적은 0으로
+    for (i = 1; i < STEPS_PER_DETENT; i++)
+        KUNIT_EXPECT_EQ(test, detent_step(&acc, +1), 0);
+    KUNIT_EXPECT_EQ(test, detent_step(&acc, +1), 1);
+    KUNIT_EXPECT_EQ(test, acc, 0);
+
+    for (i = 1; i < STEPS_PER_DETENT; i++)
+        KUNIT_EXPECT_EQ(test, detent_step(&acc, -1), 0);
+    KUNIT_EXPECT_EQ(test, detent_step(&acc, -1), -1);
+    KUNIT_EXPECT_EQ(test, acc, 0);
+
+    // 바운스(+1, -1 반복)는 이벤트를 만들지 않는다
+    for (i = 0; i < 100; i++) {
+        KUNIT_EXPECT_EQ(test, detent_step(&acc, +1), 0);
+        KUNIT_EXPECT_EQ(test, detent_step(&acc, -1), 0);
+    }
+}
+
+/* 한 방향으로 계속 돌린 시퀀스: 이벤트 수 = 전이 수 / STEPS_PER_DETENT */
+static void rot_test_sequence(struct kunit *test)
+{
+    int i, acc = 0, net = 0;
+    u8 prev = rot_cw_seq[0];
+
+    for (i = 1; i <= 4 * STEPS_PER_DETENT * 10; i++) {
+        u8 ab = rot_cw_seq[i % 4];
+        int s = decode_step(prev, ab);
+
+        prev = ab;
+        net += s ? detent_step(&acc, s) : 0;
+    }
+    KUNIT_EXPECT_EQ(test, net, 40);
+
+    for (i = 4 * STEPS_PER_DETENT * 10 - 1; i >= 0; i--) {
+        u8 ab = rot_cw_seq[i % 4];
+        int s = decode_step(prev, ab);
+
+        prev = ab;
+        net += s ? detent_step(&acc, s) : 0;
+    }
+    KUNIT_EXPECT_EQ(test, net, 0);
+}
+
+/* IRQ 핸들러의 판별 부분 1M 전이: ns/op */
+static void rot_bench_decode(struct kunit *test)
+{
+    int i, acc = 0, net = 0;
+    u8 prev = rot_cw_seq[0];
+    u64 t0, ns;
+
+    t0 = ktime_get_ns();
+    for (i = 1; i <= ROT_BENCH_N; i++) {
+        u8 ab = rot_cw_seq[i & 3];
+        int s = decode_step(prev, ab);
+
+        prev = ab;
+        net += s ? detent_step(&acc, s) : 0;
+    }
+    ns = ktime_get_ns() - t0;
+
+    KUNIT_EXPECT_EQ(test, net, ROT_BENCH_N / STEPS_PER_DETENT);
+    kunit_info(test, "decode %d transitions: %llu ns total, %llu.%03llu ns/op\n",
+               ROT_BENCH_N, ns, div_u64(ns, ROT_BENCH_N),
+               div_u64(ns * 1000, ROT_BENCH_N) % 1000);
+}
+
+static struct kunit_case rotary_test_cases[] = {
+    KUNIT_CASE(rot_test_decode_table),
+    KUNIT_CASE(rot_test_detent),
+    KUNIT_CASE(rot_test_sequence),
+    KUNIT_CASE(rot_bench_decode),
+    {}
+};
+
+static struct kunit_suite rotary_test_suite = {
+    .name = "rotary",
+    .test_cases = rotary_test_cases,
+};
+kunit_test_suite(rotary_test_suite);
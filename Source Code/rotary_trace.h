@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * rotary tracepoints (/sys/kernel/tracing/events/rotary/)
+ * A/B IRQ 핸들러 안에서 불린다. 꺼져 있을 때는 static key라서 비용이 거의 없다.
+ */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM rotary
+
+#if !defined(_ROTARY_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _ROTARY_TRACE_H
+
+#include <linux/tracepoint.h>
+#include <linux/device.h>
+
+/*
+ * A/B IRQ 한 번의 판별 결과 (글리치 컷에 걸린 IRQ는 안 남김)
+ *  step: +1/-1, 0이면 무효 전이(바운스)
+ *  acc:  판별 뒤 누적값, ev: 이번에 낸 이벤트 (0 = 없음, 1 = CW, 2 = CCW)
+ */
+TRACE_EVENT(rotary_decode,
+    TP_PROTO(struct device *dev, u8 from, u8 to, int step, int acc, int ev),
+    TP_ARGS(dev, from, to, step, acc, ev),
+    TP_STRUCT__entry(
+        __string(dev, dev_name(dev))
+        __field(u8, from)
+        __field(u8, to)
+        __field(int, step)
+        __field(int, acc)
+        __field(int, ev)
+    ),
+    TP_fast_assign(
+        __assign_str(dev, dev_name(dev));
+        __entry->from = from;
+        __entry->to = to;
+        __entry->step = step;
+        __entry->acc = acc;
+        __entry->ev = ev;
+    ),
+    TP_printk("%s ab=%u%u->%u%u step=%d acc=%d ev=%s", __get_str(dev),
+              __entry->from >> 1, __entry->from & 1, __entry->to >> 1, __entry->to & 1,
+              __entry->step, __entry->acc,
+              __print_symbolic(__entry->ev, { 0, "-" }, { 1, "CW" }, { 2, "CCW" }))
+);
+
+#endif /* _ROTARY_TRACE_H */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE rotary_trace
+#include <trace/define_trace.h>